@@ -0,0 +1,17 @@
+# mklax cmake integration
+
+function(klax_generate_cpp KLAX_FILE SYMBOLS_FILE TABLE_FILE)
+  set(${TABLE_FILE} "${CMAKE_CURRENT_BINARY_DIR}/${KLAX_FILE}.table.cc")
+  set(${TABLE_FILE} "${CMAKE_CURRENT_BINARY_DIR}/${KLAX_FILE}.table.cc" PARENT_SCOPE)
+  set(klax_file "${CMAKE_CURRENT_SOURCE_DIR}/${KLAX_FILE}")
+
+  # any further arguments (such as -n NAME) are passed to mklax
+  add_custom_command(
+      OUTPUT "${SYMBOLS_FILE}" "${${TABLE_FILE}}"
+      COMMAND mklax -f "${klax_file}" -t "${${TABLE_FILE}}" -T "${SYMBOLS_FILE}" -p ${ARGN}
+      DEPENDS mklax ${klax_file}
+      COMMENT "Generating parser table and symbols for ${KLAX_FILE}"
+      VERBATIM)
+  set_source_files_properties(${SYMBOLS_FILE} PROPERTIES GENERATED TRUE)
+  set_source_files_properties(${${TABLE_FILE}} PROPERTIES GENERATED TRUE)
+endfunction()
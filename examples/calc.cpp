@@ -0,0 +1,53 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/Report.h>
+#include <klex/cfg/ll/Analyzer.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include "calc.h" // generated via mklax
+
+using Analyzer = klex::cfg::ll::Analyzer<long>;
+
+long evaluate(int id, const Analyzer& analyzer)
+{
+    // Sum and Product evaluate to the sum (product) of the operands to their right, with the
+    // subtrahends negated, such that each operation ends up evaluated left to right.
+    switch (static_cast<calc::Action>(id))
+    {
+        case calc::Action::num: return std::stol(analyzer.lastLiteral());
+        case calc::Action::zero: return 0;
+        case calc::Action::one: return 1;
+        case calc::Action::add: return analyzer.semanticValue(-2) + analyzer.semanticValue(-1);
+        case calc::Action::sub: return -analyzer.semanticValue(-2) + analyzer.semanticValue(-1);
+        case calc::Action::mul: return analyzer.semanticValue(-2) * analyzer.semanticValue(-1);
+        case calc::Action::group: return analyzer.semanticValue(-2);
+        case calc::Action::result: return analyzer.semanticValue(-2);
+        default: return 0;
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    const std::string input = argc == 2 ? argv[1] : "2 + 3 * (4 + 1)";
+
+    klex::ConsoleReport report;
+    Analyzer analyzer { calc::syntaxTable, &report, input, &evaluate };
+
+    if (std::optional<long> result = analyzer.analyze(); result && !report.containsFailures())
+    {
+        fmt::print("{} = {}\n", input, *result);
+        return EXIT_SUCCESS;
+    }
+
+    return EXIT_FAILURE;
+}
@@ -7,21 +7,22 @@
 
 #include <klex/cfg/Grammar.h>
 #include <klex/cfg/LeftRecursion.h>
+#include <klex/util/bits.h>
 #include <klex/util/iterator.h>
 
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <deque>
 #include <iterator>
 #include <map>
-#include <set>
 #include <vector>
 
 using namespace std;
 using klex::util::find_last;
 using klex::util::indexed;
-using klex::util::reversed;
 
 namespace klex::cfg
 {
@@ -30,37 +31,275 @@ namespace klex::cfg
 namespace
 {
 
-    template <typename T>
-    inline vector<T> to_vector(set<T> S)
+    //! @returns the first occurrence of each terminal within the productions' handles, by terminal ID.
+    vector<const Terminal*> terminalsById(const Grammar& grammar)
     {
-        vector<T> out;
-        out.reserve(S.size());
-        for (const T& v: S)
-            out.emplace_back(v);
-        return out;
+        const SymbolTable& symbolTable = grammar.symbolTable;
+        vector<const Terminal*> terminals(symbolTable.terminalCount(), nullptr);
+        for (const Production& p: grammar.productions)
+            for (const HandleElement& e: p.handle)
+                if (holds_alternative<Terminal>(e))
+                {
+                    const Terminal*& w = terminals[symbolTable.terminalId(get<Terminal>(e).pattern())];
+                    if (w == nullptr)
+                        w = &get<Terminal>(e);
+                }
+        return terminals;
     }
 
-    template <typename T, typename V = int>
-    inline map<T, V> createIdMap(const vector<T>& items)
+    //! Set of terminals, by their IDs (see FirstFollowBuilder).
+    class TerminalSet
     {
-        map<T, V> out;
-        for (auto i = begin(items); i != end(items); ++i)
-            out[*i] = distance(begin(items), i);
-        return out;
-    }
+      public:
+        explicit TerminalSet(size_t terminalCount = 0): words_((terminalCount + 63) / 64, 0) {}
+
+        void clear() { fill(begin(words_), end(words_), 0); }
 
-    template <typename T>
-    inline bool merge(vector<T>* target, vector<T> source)
+        void insert(size_t t) { words_[t / 64] |= uint64_t(1) << (t % 64); }
+
+        //! Adds all terminals of @p other, returning whether or not any was new.
+        bool merge(const TerminalSet& other)
+        {
+            uint64_t added = 0;
+            for (size_t i = 0; i < words_.size(); ++i)
+            {
+                added |= other.words_[i] & ~words_[i];
+                words_[i] |= other.words_[i];
+            }
+            return added != 0;
+        }
+
+        template <typename F>
+        void each(F f) const
+        {
+            for (size_t i = 0; i < words_.size(); ++i)
+                for (uint64_t w = words_[i]; w != 0; w &= w - 1)
+                    f(i * 64 + util::countTrailingZeros(w));
+        }
+
+      private:
+        vector<uint64_t> words_;
+    };
+
+    /**
+     * Computes the epsilon flags and FIRST/FOLLOW sets of all productions.
+     *
+     * The sets are bitsets over the terminal IDs of the grammar's symbol table, per non-terminal.
+     * Rather than passing over all productions until nothing changes anymore, each set is propagated
+     * along the edges of its dependency graph by a worklist that revisits a non-terminal only when a
+     * set it depends on has grown.
+     */
+    class FirstFollowBuilder
     {
-        sort(begin(*target), end(*target));
-        sort(begin(source), end(source));
-
-        const size_t n = target->size();
-        vector<T> dest;
-        set_union(begin(*target), end(*target), begin(source), end(source), back_inserter(dest));
-        *target = move(dest);
-        return target->size() > n;
-    }
+      public:
+        explicit FirstFollowBuilder(Grammar& grammar):
+            grammar_ { grammar }, productions_ { grammar.productions }, nullable_ { grammar.nullable }
+        {
+        }
+
+        void build()
+        {
+            intern();
+            computeEpsilon();
+            computeFirst();
+            computeFollow();
+
+            for (size_t p = 0; p < productions_.size(); ++p)
+            {
+                TerminalSet first { terminals_.size() };
+                for (const Sym& b: handles_[p])
+                {
+                    if (b.terminal)
+                        first.insert(b.id);
+                    else
+                        first.merge(first_[b.id]);
+
+                    if (b.terminal || !nullable_[b.id])
+                        break;
+                }
+                productions_[p].first = toTerminals(first);
+                productions_[p].follow = toTerminals(follow_[lhs_[p]]);
+            }
+        }
+
+      private:
+        struct Sym
+        {
+            bool terminal;
+            size_t id;
+        };
+
+        void intern()
+        {
+            const SymbolTable& symbolTable = grammar_.symbolTable;
+            terminals_ = terminalsById(grammar_);
+
+            for (const Production& p: productions_)
+            {
+                lhs_.emplace_back(static_cast<size_t>(symbolTable.nonterminalId(p.name)));
+
+                vector<Sym>& handle = handles_.emplace_back();
+                for (const HandleElement& e: p.handle)
+                {
+                    if (holds_alternative<Terminal>(e))
+                    {
+                        const SymbolTable::Id w = symbolTable.terminalId(get<Terminal>(e).pattern());
+                        handle.emplace_back(Sym { true, static_cast<size_t>(w) });
+                    }
+                    else if (holds_alternative<NonTerminal>(e))
+                    {
+                        const SymbolTable::Id nt = symbolTable.nonterminalId(get<NonTerminal>(e).name);
+                        handle.emplace_back(Sym { false, static_cast<size_t>(nt) });
+                    }
+                }
+            }
+
+            nullable_.assign(symbolTable.nonterminalCount(), false);
+            first_.assign(symbolTable.nonterminalCount(), TerminalSet { terminals_.size() });
+            follow_.assign(symbolTable.nonterminalCount(), TerminalSet { terminals_.size() });
+        }
+
+        void computeEpsilon()
+        {
+            // number of symbols per production not yet known to derive epsilon (npos if any is a terminal)
+            constexpr size_t npos = static_cast<size_t>(-1);
+            vector<size_t> pending(productions_.size());
+            vector<vector<size_t>> occurrences(nullable_.size());
+            deque<size_t> worklist;
+
+            auto setNullable = [&](size_t p) {
+                productions_[p].epsilon = true;
+                if (!nullable_[lhs_[p]])
+                {
+                    nullable_[lhs_[p]] = true;
+                    worklist.emplace_back(lhs_[p]);
+                }
+            };
+
+            for (size_t p = 0; p < productions_.size(); ++p)
+            {
+                pending[p] = handles_[p].size();
+                for (const Sym& b: handles_[p])
+                    if (b.terminal)
+                        pending[p] = npos;
+                    else
+                        occurrences[b.id].emplace_back(p);
+
+                if (pending[p] == 0)
+                    setNullable(p);
+            }
+
+            while (!worklist.empty())
+            {
+                const size_t nt = worklist.front();
+                worklist.pop_front();
+
+                for (size_t p: occurrences[nt])
+                    if (pending[p] != npos && --pending[p] == 0)
+                        setNullable(p);
+            }
+        }
+
+        void computeFirst()
+        {
+            // dependents[Y] contains X if FIRST(X) includes FIRST(Y)
+            vector<vector<size_t>> dependents(nullable_.size());
+
+            for (size_t p = 0; p < productions_.size(); ++p)
+                for (const Sym& b: handles_[p])
+                {
+                    if (b.terminal)
+                    {
+                        first_[lhs_[p]].insert(b.id);
+                        break;
+                    }
+
+                    if (b.id != lhs_[p])
+                        dependents[b.id].emplace_back(lhs_[p]);
+
+                    if (!nullable_[b.id])
+                        break;
+                }
+
+            propagate(first_, dependents);
+        }
+
+        void computeFollow()
+        {
+            // dependents[A] contains B if FOLLOW(B) includes FOLLOW(A)
+            vector<vector<size_t>> dependents(nullable_.size());
+            TerminalSet trailer { terminals_.size() };
+
+            for (size_t p = 0; p < productions_.size(); ++p)
+            {
+                trailer.clear();
+                bool trailerNullable = true;
+
+                for (auto b = handles_[p].rbegin(); b != handles_[p].rend(); ++b)
+                {
+                    if (b->terminal)
+                    {
+                        trailer.clear();
+                        trailer.insert(b->id);
+                        trailerNullable = false;
+                        continue;
+                    }
+
+                    follow_[b->id].merge(trailer);
+                    if (trailerNullable && b->id != lhs_[p])
+                        dependents[lhs_[p]].emplace_back(b->id);
+
+                    if (!nullable_[b->id])
+                    {
+                        trailer.clear();
+                        trailerNullable = false;
+                    }
+                    trailer.merge(first_[b->id]);
+                }
+            }
+
+            propagate(follow_, dependents);
+        }
+
+        static void propagate(vector<TerminalSet>& sets, const vector<vector<size_t>>& dependents)
+        {
+            deque<size_t> worklist;
+            vector<bool> queued(sets.size(), true);
+            for (size_t nt = 0; nt < sets.size(); ++nt)
+                worklist.emplace_back(nt);
+
+            while (!worklist.empty())
+            {
+                const size_t nt = worklist.front();
+                worklist.pop_front();
+                queued[nt] = false;
+
+                for (size_t dependent: dependents[nt])
+                    if (sets[dependent].merge(sets[nt]) && !queued[dependent])
+                    {
+                        queued[dependent] = true;
+                        worklist.emplace_back(dependent);
+                    }
+            }
+        }
+
+        vector<Terminal> toTerminals(const TerminalSet& set) const
+        {
+            vector<Terminal> out;
+            set.each([&](size_t t) { out.emplace_back(*terminals_[t]); });
+            return out;
+        }
+
+      private:
+        Grammar& grammar_;
+        vector<Production>& productions_;
+        vector<bool>& nullable_;             //!< per non-terminal
+        vector<const Terminal*> terminals_;  //!< by terminal ID
+        vector<size_t> lhs_;                 //!< non-terminal ID per production
+        vector<vector<Sym>> handles_;        //!< interned symbols per production
+        vector<TerminalSet> first_;          //!< per non-terminal
+        vector<TerminalSet> follow_;         //!< per non-terminal
+    };
 
 } // namespace
 // }}} helper
@@ -111,20 +350,46 @@ string to_string(const Production& p)
 
 vector<Terminal> Production::first1() const
 {
-    vector<Terminal> result = first;
-    if (epsilon)
-        set_union(begin(result), end(result), begin(follow), end(follow), back_inserter(result));
+    if (!epsilon)
+        return first;
 
+    vector<Terminal> result;
+    set_union(begin(first), end(first), begin(follow), end(follow), back_inserter(result));
     return result;
 }
 
+void Grammar::reindex()
+{
+    vector<string> nonterminals;
+    vector<string> terminals;
+    vector<string> actions;
+
+    for (const Production& production: productions)
+        nonterminals.emplace_back(production.name);
+
+    for (const Production& production: productions)
+        for (const HandleElement& e: production.handle)
+            if (holds_alternative<Terminal>(e))
+                terminals.emplace_back(get<Terminal>(e).pattern());
+            else if (holds_alternative<NonTerminal>(e))
+                nonterminals.emplace_back(get<NonTerminal>(e).name);
+            else
+                actions.emplace_back(get<Action>(e).id);
+
+    symbolTable = SymbolTable { nonterminals, move(terminals), move(actions) };
+
+    productionIndex.assign(symbolTable.nonterminalCount(), {});
+    for (size_t i = 0; i < productions.size(); ++i)
+        productionIndex[symbolTable.nonterminalId(productions[i].name)].emplace_back(i);
+}
+
 vector<Production*> Grammar::getProductions(const NonTerminal& nt)
 {
     vector<Production*> result;
 
-    for (Production& production: productions)
-        if (production.name == nt.name)
-            result.push_back(&production);
+    if (const SymbolTable::Id id = symbolTable.nonterminalId(nt.name); id != SymbolTable::None)
+        for (size_t i: productionIndex[id])
+            result.push_back(&productions[i]);
 
     return result;
 }
@@ -133,9 +398,9 @@ vector<const Production*> Grammar::getProductions(const NonTerminal& nt) const
 {
     vector<const Production*> result;
 
-    for (const Production& production: productions)
-        if (production.name == nt.name)
-            result.push_back(&production);
+    if (const SymbolTable::Id id = symbolTable.nonterminalId(nt.name); id != SymbolTable::None)
+        for (size_t i: productionIndex[id])
+            result.push_back(&productions[i]);
 
     return result;
 }
@@ -145,23 +410,22 @@ vector<Terminal> Grammar::firstOf(const Symbol& b) const
     if (holds_alternative<Terminal>(b))
         return vector<Terminal> { get<Terminal>(b) };
 
-    set<Terminal> first;
+    vector<Terminal> first;
     for (const Production* p: getProductions(get<NonTerminal>(b)))
-        for (const Terminal& w: p->first)
-            first.emplace(w);
+    {
+        vector<Terminal> result;
+        set_union(begin(first), end(first), begin(p->first), end(p->first), back_inserter(result));
+        first = move(result);
+    }
 
-    return to_vector(move(first));
+    return first;
 }
 
 vector<Terminal> Grammar::followOf(const NonTerminal& nt) const
 {
-    set<Terminal> follow;
-
-    for (const Production* p: getProductions(nt))
-        for (const Terminal& w: p->follow)
-            follow.emplace(w);
-
-    return to_vector(move(follow));
+    // all productions of a non-terminal share its FOLLOW-set
+    const vector<const Production*> productions = getProductions(nt);
+    return !productions.empty() ? productions.front()->follow : vector<Terminal> {};
 }
 
 void Grammar::injectEof()
@@ -222,55 +486,12 @@ void Grammar::finalize()
     injectEof();
 
     for_each(begin(productions), end(productions), ProductionIdBuilder {});
+    reindex();
 
     terminals = cfg::terminals(*this);
     nonterminals = cfg::nonterminals(*this);
 
-    while (true)
-    {
-        bool updated = false;
-
-        for (Production& production: productions)
-        {
-            const NonTerminal nt { production.name };
-            const Handle& expression = production.handle;
-
-            // FIRST-set
-            bool found = false;
-            for (const Symbol b: symbols(expression))
-            {
-                updated |= merge(&production.first, firstOf(b));
-                if (!containsEpsilon(b))
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                production.epsilon = true;
-
-            // FOLLOW-set
-            vector<Terminal> trailer = followOf(nt);
-            for (const Symbol b: reversed(symbols(expression)))
-            {
-                if (holds_alternative<Terminal>(b))
-                    trailer = firstOf(b);
-                else
-                {
-                    for (Production* p: getProductions(get<NonTerminal>(b)))
-                        updated |= merge(&p->follow, trailer);
-
-                    if (!containsEpsilon(b))
-                        trailer = firstOf(b);
-                    else
-                        merge(&trailer, firstOf(b));
-                }
-            }
-        }
-
-        if (!updated)
-            break;
-    }
+    FirstFollowBuilder { *this }.build();
 }
 
 string Grammar::dump() const
@@ -303,13 +524,9 @@ string Grammar::dump() const
 
 vector<Terminal> terminals(const Grammar& grammar)
 {
-    set<Terminal> terminals;
-    for (const Production& production: grammar.productions)
-        for (const Symbol b: symbols(production.handle))
-            if (holds_alternative<Terminal>(b))
-                terminals.insert(get<Terminal>(b));
-
-    vector<Terminal> terms = to_vector(move(terminals));
+    vector<Terminal> terms;
+    for (const Terminal* w: terminalsById(grammar))
+        terms.emplace_back(*w);
 
     for_each(begin(terms), end(terms), TerminalNameCurator {});
 
@@ -325,23 +542,22 @@ vector<NonTerminal> nonterminals(const Grammar& grammar)
 {
     vector<NonTerminal> nts;
 
-    for (const Production& production: grammar.productions)
-        if (find(begin(nts), end(nts), production.name) == end(nts))
-            nts.emplace_back(NonTerminal { production.name });
+    // those with productions come first, by their ID
+    for (SymbolTable::Id id = 0; static_cast<size_t>(id) < grammar.productionIndex.size(); ++id)
+        if (!grammar.productionIndex[id].empty())
+            nts.emplace_back(NonTerminal { grammar.symbolTable.nonterminalName(id) });
 
     return nts;
 }
 
 vector<Action> actions(const Grammar& grammar)
 {
-    set<Action> acts;
+    vector<Action> acts;
 
-    for (const Production& production: grammar.productions)
-        for (const HandleElement& e: production.handle)
-            if (holds_alternative<Action>(e))
-                acts.insert(get<Action>(e));
+    for (size_t id = 0; id < grammar.symbolTable.actionCount(); ++id)
+        acts.emplace_back(Action { grammar.symbolTable.actionName(static_cast<SymbolTable::Id>(id)) });
 
-    return to_vector(move(acts));
+    return acts;
 }
 
 bool isLeftRecursive(const Grammar& grammar)
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <klex/cfg/SymbolTable.h>
 #include <klex/regular/Rule.h>
 
 #include <iterator>
@@ -227,6 +228,23 @@ struct Grammar {
 	//! Accumulated list of terminals (including explicitely specified terminals), filled by finalize().
 	std::vector<Terminal> terminals;
 
+	//! Interned symbols of all productions (and thus their IDs), built by reindex().
+	SymbolTable symbolTable;
+
+	//! Indices into productions per non-terminal ID, built by reindex().
+	std::vector<std::vector<size_t>> productionIndex;
+
+	//! Whether or not a non-terminal (by ID) derives epsilon, filled by finalize().
+	std::vector<bool> nullable;
+
+	/**
+	 * Rebuilds the symbolTable and productionIndex from the productions.
+	 *
+	 * Non-terminals are numbered in the order of their first production, followed by those that
+	 * are referenced without having any. Must be invoked after modifying the productions.
+	 */
+	void reindex();
+
 	//! @returns a set of Production alternating rules that represent given NonTerminal @p nt.
 	[[nodiscard]] std::vector<const Production*> getProductions(const NonTerminal& nt) const;
 
@@ -242,18 +260,15 @@ struct Grammar {
 	//! @returns boolean, indicating whether or not given symbol contains an epsilon.
 	[[nodiscard]] bool containsEpsilon(const NonTerminal& nt) const
 	{
-		for (const Production* p : getProductions(nt))
-			if (p->epsilon)
-				return true;
-
-		return false;
+		const SymbolTable::Id id = symbolTable.nonterminalId(nt.name);
+		return id != SymbolTable::None && static_cast<size_t>(id) < nullable.size() && nullable[id];
 	}
 
 	//! @returns true if given non-terminal corresponds to a production, false otherwise.
 	[[nodiscard]] bool containsProduction(const NonTerminal& nt) const
 	{
-		return std::any_of(productions.begin(), productions.end(),
-						   [&](const Production& p) { return p.name == nt.name; });
+		const SymbolTable::Id id = symbolTable.nonterminalId(nt.name);
+		return id != SymbolTable::None && !productionIndex[id].empty();
 	}
 
 	//! @returns boolean, indicating whether or not a terminal by given symbolic name has been declared.
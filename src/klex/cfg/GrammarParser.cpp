@@ -50,14 +50,13 @@ Grammar GrammarParser::parse()
             default:
                 report_->syntaxError(
                     SourceLocation {}, "Unexpected token {}. Expecting a rule instead.", currentToken());
-                consumeToken();
-                abort();
-                break;
+                return grammar_;
         }
     }
 
     consumeToken(Token::Eof);
 
+    grammar_.reindex();
     GrammarValidator { report_ }.validate(grammar_);
 
     return grammar_;
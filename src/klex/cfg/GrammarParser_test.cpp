@@ -56,6 +56,15 @@ TEST(cfg_GrammarParser, unresolved_nonterminals)
     // TODO: make sure the failure reported is the unresolved-nonterminals case.
 }
 
+TEST(cfg_GrammarParser, syntax_error)
+{
+    BufferedReport report;
+    Grammar grammar = GrammarParser(GrammarLexer { "Start ::= 'a'; ::= 'b';" }, &report).parse();
+    ASSERT_TRUE(report.containsFailures());
+    ASSERT_EQ(1, report.size());
+    ASSERT_EQ(1, grammar.productions.size());
+}
+
 TEST(cfg_GrammarParser, action)
 {
     ConsoleReport report;
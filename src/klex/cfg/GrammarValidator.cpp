@@ -7,8 +7,9 @@
 
 #include <klex/cfg/Grammar.h>
 #include <klex/cfg/GrammarValidator.h>
+#include <klex/cfg/SymbolTable.h>
 
-#include <variant>
+#include <cstddef>
 
 using namespace std;
 using namespace klex;
@@ -16,13 +17,12 @@ using namespace klex::cfg;
 
 void GrammarValidator::validate(const Grammar& G)
 {
-    for (const Production& p: G.productions)
-        for (const Symbol b: symbols(p.handle))
-            if (holds_alternative<NonTerminal>(b))
-                if (!G.containsProduction(get<NonTerminal>(b)))
-                    report_->typeError(SourceLocation { /*TODO: b.location()*/ },
-                                       "Non-terminal {} is missing a production rule.",
-                                       b);
+    // referenced non-terminals without any production
+    for (size_t id = 0; id < G.symbolTable.nonterminalCount(); ++id)
+        if (G.productionIndex[id].empty())
+            report_->typeError(SourceLocation { /*TODO: b.location()*/ },
+                               "Non-terminal {} is missing a production rule.",
+                               G.symbolTable.nonterminalName(static_cast<SymbolTable::Id>(id)));
 
     // TODO: check for unwanted infinite recursions
     // such as: E ::= E
@@ -12,6 +12,11 @@
 #include <klex/util/literals.h>
 #include <klex/util/testing.h>
 
+#include <fmt/format.h>
+
+#include <string>
+#include <vector>
+
 using namespace std;
 using namespace klex;
 using namespace klex::cfg;
@@ -174,4 +179,129 @@ TEST(cfg_Grammar, left_recursive)
               fmt::format("{}", grammar.followOf(NonTerminal { "Factor" })));
 }
 
+TEST(cfg_Grammar, nullable_chains)
+{
+    BufferedReport report;
+    Grammar grammar = GrammarParser(GrammarLexer { R"(`Start ::= A B 'x';
+                                                     `A     ::= B C
+                                                     `      | 'a';
+                                                     `B     ::= C
+                                                     `      | ;
+                                                     `C     ::= B 'c'
+                                                     `      | ;
+                                                     `)"_multiline },
+                                    &report)
+                          .parse();
+    ASSERT_FALSE(report.containsFailures());
+    grammar.finalize();
+
+    log("Grammar:");
+    log(grammar.dump());
+
+    // epsilon is derived through B ::= C and C ::= <eps>, B ::= <eps>
+    ASSERT_EQ(7, grammar.productions.size());
+    EXPECT_FALSE(grammar.productions[0].epsilon);
+    EXPECT_TRUE(grammar.productions[1].epsilon);
+    EXPECT_FALSE(grammar.productions[2].epsilon);
+    EXPECT_TRUE(grammar.productions[3].epsilon);
+    EXPECT_TRUE(grammar.productions[4].epsilon);
+    EXPECT_FALSE(grammar.productions[5].epsilon);
+    EXPECT_TRUE(grammar.productions[6].epsilon);
+
+    EXPECT_EQ("\"a\", \"c\", \"x\"", fmt::format("{}", grammar.productions[0].first));
+    EXPECT_EQ("\"a\", \"c\"", fmt::format("{}", grammar.firstOf(NonTerminal { "A" })));
+    EXPECT_EQ("\"c\"", fmt::format("{}", grammar.firstOf(NonTerminal { "B" })));
+    EXPECT_EQ("\"c\"", fmt::format("{}", grammar.firstOf(NonTerminal { "C" })));
+
+    EXPECT_EQ("\"c\", \"x\"", fmt::format("{}", grammar.followOf(NonTerminal { "A" })));
+    EXPECT_EQ("\"c\", \"x\"", fmt::format("{}", grammar.followOf(NonTerminal { "B" })));
+    EXPECT_EQ("\"c\", \"x\"", fmt::format("{}", grammar.followOf(NonTerminal { "C" })));
+
+    // FIRST+ of A ::= B C contains "c" once, both from FIRST and FOLLOW
+    EXPECT_EQ("\"c\", \"x\"", fmt::format("{}", grammar.productions[1].first1()));
+}
+
+TEST(cfg_Grammar, symbol_table)
+{
+    BufferedReport report;
+    Grammar grammar = GrammarParser(GrammarLexer { R"(`Start ::= List {list};
+                                                     `List  ::= Item List {append}
+                                                     `      | ;
+                                                     `Item  ::= 'b' {item}
+                                                     `      | 'a' Missing;
+                                                     `)"_multiline },
+                                    &report)
+                          .parse();
+
+    // only Missing lacks a production, reported once
+    ASSERT_EQ(1, report.size());
+
+    const SymbolTable& symbolTable = grammar.symbolTable;
+    ASSERT_EQ(4, symbolTable.nonterminalCount());
+    EXPECT_EQ(0, symbolTable.nonterminalId("Start"));
+    EXPECT_EQ(1, symbolTable.nonterminalId("List"));
+    EXPECT_EQ(2, symbolTable.nonterminalId("Item"));
+    EXPECT_EQ(3, symbolTable.nonterminalId("Missing"));
+    EXPECT_EQ(SymbolTable::None, symbolTable.nonterminalId("Other"));
+
+    // terminals and actions by their sort order
+    ASSERT_EQ(2, symbolTable.terminalCount());
+    EXPECT_EQ("a", symbolTable.terminalPattern(0));
+    EXPECT_EQ("b", symbolTable.terminalPattern(1));
+    ASSERT_EQ(3, symbolTable.actionCount());
+    EXPECT_EQ("append", symbolTable.actionName(0));
+    EXPECT_EQ("item", symbolTable.actionName(1));
+    EXPECT_EQ("list", symbolTable.actionName(2));
+
+    EXPECT_TRUE(grammar.productionIndex[1] == vector<size_t>({ 1, 2 }));
+    EXPECT_TRUE(grammar.productionIndex[3].empty());
+    ASSERT_EQ(2, grammar.getProductions(NonTerminal { "Item" }).size());
+    EXPECT_TRUE(&grammar.productions[3] == grammar.getProductions(NonTerminal { "Item" })[0]);
+    EXPECT_TRUE(grammar.containsProduction(NonTerminal { "List" }));
+    EXPECT_FALSE(grammar.containsProduction(NonTerminal { "Missing" }));
+
+    EXPECT_FALSE(grammar.containsEpsilon(NonTerminal { "List" }));
+    grammar.finalize();
+    EXPECT_TRUE(grammar.containsEpsilon(NonTerminal { "List" }));
+    EXPECT_FALSE(grammar.containsEpsilon(NonTerminal { "Item" }));
+
+    // finalize() reindexes for the injected EOF terminal
+    ASSERT_EQ(3, grammar.symbolTable.terminalCount());
+    EXPECT_EQ("<<EOF>>", grammar.symbolTable.terminalPattern(0));
+    ASSERT_EQ(3, grammar.nonterminals.size());
+    EXPECT_EQ("Item", grammar.nonterminals[2].name);
+}
+
+namespace
+{
+    //! Expression grammar with @p levels operator precedence levels, i.e. 2 * levels + 2 non-terminals.
+    string precedenceGrammar(int levels)
+    {
+        string source = "Start ::= E0;\n";
+        for (int i = 0; i < levels; ++i)
+        {
+            source += fmt::format("E{0} ::= E{1} R{0};\n", i, i + 1);
+            source += fmt::format("R{0} ::= 'op{0}' E{1} R{0} | ;\n", i, i + 1);
+        }
+        source += fmt::format("E{} ::= '(' E0 ')' | 'num';\n", levels);
+        return source;
+    }
+} // namespace
+
+class cfg_Grammar_large : public klex::util::testing::Benchmark {
+  public:
+    cfg_Grammar_large(): grammar_ { GrammarParser(precedenceGrammar(200), &report_).parse() } {}
+
+  protected:
+    BufferedReport report_;
+    const Grammar grammar_;
+};
+
+BENCHMARK_F(cfg_Grammar_large, finalize)
+{
+    Grammar grammar = grammar_;
+    grammar.finalize();
+    klex::util::testing::doNotOptimize(grammar.productions.back().follow.size());
+}
+
 // vim:ts=4:sw=4:noet
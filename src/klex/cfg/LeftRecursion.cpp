@@ -21,17 +21,11 @@ LeftRecursion::LeftRecursion(Grammar& _grammar): grammar_ { _grammar }
 
 bool LeftRecursion::isLeftRecursive(const Grammar& grammar)
 {
-    const vector<NonTerminal> nonterminals = cfg::nonterminals(grammar);
+    return any_of(begin(grammar.productions), end(grammar.productions), [](const Production& p) {
+        auto syms = symbols(p.handle);
 
-    return any_of(begin(nonterminals), end(nonterminals), [&](const NonTerminal& nt) {
-        const vector<const Production*> productions = grammar.getProductions(nt);
-
-        return any_of(begin(productions), end(productions), [](const Production* p) {
-            auto syms = symbols(p->handle);
-
-            return !syms.empty() && holds_alternative<NonTerminal>(syms[0])
-                   && get<NonTerminal>(syms[0]) == p->name && syms.size() > 1;
-        });
+        return !syms.empty() && holds_alternative<NonTerminal>(syms[0])
+               && get<NonTerminal>(syms[0]) == p.name && syms.size() > 1;
     });
 }
 
@@ -95,6 +89,8 @@ void LeftRecursion::eliminateDirect(const NonTerminal& nt)
         grammar_.productions.emplace_back(Production { tailSymbol.name, {} });
         // TODO: don't emplace at the back of all but at the back of the last NT's tail symbol.
         // TODO: fix injected EOF rule, omfg
+
+        grammar_.reindex();
     }
 }
 
@@ -102,9 +98,7 @@ NonTerminal LeftRecursion::createRelatedNonTerminal(const NonTerminal& nt) const
 {
     string tail = nt.name + "_";
 
-    while (any_of(begin(grammar_.productions), end(grammar_.productions), [&](const Production& p) {
-        return p.name == tail;
-    }))
+    while (grammar_.symbolTable.nonterminalId(tail) != SymbolTable::None)
         tail += "_";
 
     return NonTerminal { tail };
@@ -0,0 +1,37 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/cfg/SymbolTable.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace klex::cfg
+{
+
+SymbolTable::SymbolTable(const vector<string>& nonterminals, vector<string> terminals, vector<string> actions)
+{
+    for (const string& name: nonterminals)
+        nonterminals_.add(name);
+
+    sort(begin(terminals), end(terminals));
+    for (const string& pattern: terminals)
+        terminals_.add(pattern);
+
+    sort(begin(actions), end(actions));
+    for (const string& name: actions)
+        actions_.add(name);
+}
+
+void SymbolTable::Interned::add(const string& name)
+{
+    if (ids.emplace(name, static_cast<Id>(names.size())).second)
+        names.emplace_back(name);
+}
+
+} // namespace klex::cfg
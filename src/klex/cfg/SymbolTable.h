@@ -0,0 +1,76 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//	 (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace klex::cfg {
+
+/**
+ * Grammar-wide table of interned symbols, assigning dense IDs (starting at 0) per kind of symbol.
+ *
+ * Non-terminals keep the order they are given in, whereas terminals (by pattern) and actions
+ * (by name) are numbered in their sort order, which is the order of Grammar::terminals and actions().
+ *
+ * @see Grammar::reindex()
+ */
+class SymbolTable {
+  public:
+	using Id = int;
+
+	//! ID of symbols not contained in the table.
+	static constexpr Id None = -1;
+
+	SymbolTable() = default;
+
+	/**
+	 * Interns the given symbols, ignoring duplicates.
+	 *
+	 * @param nonterminals non-terminal names, in the order of their IDs
+	 * @param terminals    terminal patterns, in any order
+	 * @param actions      action names, in any order
+	 */
+	SymbolTable(const std::vector<std::string>& nonterminals, std::vector<std::string> terminals,
+				std::vector<std::string> actions);
+
+	[[nodiscard]] Id nonterminalId(const std::string& name) const noexcept { return nonterminals_.id(name); }
+	[[nodiscard]] Id terminalId(const std::string& pattern) const noexcept { return terminals_.id(pattern); }
+	[[nodiscard]] Id actionId(const std::string& name) const noexcept { return actions_.id(name); }
+
+	[[nodiscard]] size_t nonterminalCount() const noexcept { return nonterminals_.names.size(); }
+	[[nodiscard]] size_t terminalCount() const noexcept { return terminals_.names.size(); }
+	[[nodiscard]] size_t actionCount() const noexcept { return actions_.names.size(); }
+
+	[[nodiscard]] const std::string& nonterminalName(Id id) const noexcept { return nonterminals_.names[id]; }
+	[[nodiscard]] const std::string& terminalPattern(Id id) const noexcept { return terminals_.names[id]; }
+	[[nodiscard]] const std::string& actionName(Id id) const noexcept { return actions_.names[id]; }
+
+  private:
+	struct Interned {
+		std::vector<std::string> names;
+		std::unordered_map<std::string, Id> ids;
+
+		void add(const std::string& name);
+
+		[[nodiscard]] Id id(const std::string& name) const noexcept
+		{
+			auto i = ids.find(name);
+			return i != ids.end() ? i->second : None;
+		}
+	};
+
+	Interned nonterminals_;
+	Interned terminals_;
+	Interned actions_;
+};
+
+}  // namespace klex::cfg
+
+// vim:ts=4:sw=4:noet
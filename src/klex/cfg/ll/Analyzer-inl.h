@@ -15,17 +15,25 @@ namespace klex::cfg::ll {
 
 // --------------------------------------------------------------------------------------------------------
 
-template <typename SemanticValue>
-Analyzer<SemanticValue>::Analyzer(const SyntaxTable& _st, Report* _report, std::string _source,
-								  ActionHandler actionHandler)
+template <typename SemanticValue, const bool Trace>
+Analyzer<SemanticValue, Trace>::Analyzer(const SyntaxTable& _st, Report* _report, std::string _source,
+										 ActionHandler actionHandler, TraceLogger logger)
 	: def_{_st},
+	  logger_{move(logger)},
 	  lexer_{def_.lexerDef, std::move(_source),
-			 std::bind(&Analyzer<SemanticValue>::log, this, std::placeholders::_1)},
+			 Trace ? std::bind(&Analyzer<SemanticValue, Trace>::log, this, std::placeholders::_1)
+				   : typename Lexer::DebugLogger{}},
 	  report_{_report},
 	  stack_{},
+	  valueStack_{},
+	  valueStackBase_{0},
 	  actionHandler_{move(actionHandler)}
 {
-	log(def_.lexerDef.to_string());
+	// both stacks keep their storage for the whole analysis, growing only on deeper nesting
+	stack_.reserve(64);
+	valueStack_.reserve(64);
+	if constexpr (Trace)
+		log(def_.lexerDef.to_string());
 }
 
 template <typename Container>
@@ -42,8 +50,8 @@ std::string containerToString(const Container& values)
 	return sstr.str();
 }
 
-template <typename SemanticValue>
-std::optional<SemanticValue> Analyzer<SemanticValue>::analyze()
+template <typename SemanticValue, const bool Trace>
+std::optional<SemanticValue> Analyzer<SemanticValue, Trace>::analyze()
 {
 	using namespace std;
 	using ::klex::util::reversed;
@@ -56,9 +64,12 @@ std::optional<SemanticValue> Analyzer<SemanticValue>::analyze()
 
 	for (;;)
 	{
-		log(fmt::format("current token    : {}", def_.terminalName(*currentToken)));
-		log(fmt::format("  state stack    : {}", dumpStateStack()));
-		log(fmt::format("  semantic stack : {}", dumpSemanticStack()));
+		if constexpr (Trace)
+		{
+			log(fmt::format("current token    : {}", def_.terminalName(*currentToken)));
+			log(fmt::format("  state stack    : {}", dumpStateStack()));
+			log(fmt::format("  semantic stack : {}", dumpSemanticStack()));
+		}
 
 		// if (currentToken == eof && isTerminal(X) && X == *currentToken)
 		// if (currentToken == eof && X == *currentToken)
@@ -75,10 +86,15 @@ std::optional<SemanticValue> Analyzer<SemanticValue>::analyze()
 		if (X < 0)
 		{
 			stack_.pop_back();
-			SemanticValue y = valueStack_.back();
-			valueStack_.resize(valueStack_.size() + X);
-			valueStack_.emplace_back(move(y));
-			log("    rewinding");
+			// replace the production's values by its last one
+			const size_t first = valueStack_.size() + X;
+			if (first + 1 != valueStack_.size())
+			{
+				valueStack_[first] = move(valueStack_.back());
+				valueStack_.erase(valueStack_.begin() + first + 1, valueStack_.end());
+			}
+			if constexpr (Trace)
+				log("    rewinding");
 		}
 		else if (isTerminal(X))
 		{
@@ -91,31 +107,34 @@ std::optional<SemanticValue> Analyzer<SemanticValue>::analyze()
 				// TODO: proper error recovery
 			}
 
-			valueStack_.emplace_back(SemanticValue{});  // TODO: FIXME <<EOF>> handling
+			valueStack_.emplace_back();  // TODO: FIXME <<EOF>> handling
 
-			log(fmt::format("    eat terminal: {} '{}'", def_.terminalName(X), to_string(currentToken)));
-			lastLiteral_ = to_string(currentToken);
+			if constexpr (Trace)
+				log(fmt::format("    eat terminal: {} '{}'", def_.terminalName(X),
+								to_string(currentToken.info)));
+			lastLiteral_ = to_string(currentToken.info);
 			++currentToken;
 		}
 		else if (isNonTerminal(X))
 		{
-			if (optional<SyntaxTable::Expression> handle = getHandleFor(X, *currentToken); handle.has_value())
+			if (const optional<SyntaxTable::ProductionSpan> handle = getHandleFor(X, *currentToken);
+				handle.has_value())
 			{
-				log(fmt::format("    Apply production for: ({}, {}) -> {}", def_.nonterminalName(X),
-								def_.terminalName(*currentToken), handleString(*handle)));
+				if constexpr (Trace)
+					log(fmt::format("    Apply production for: ({}, {}) -> {}", def_.nonterminalName(X),
+									def_.terminalName(*currentToken), handleString(*handle)));
 				stack_.pop_back();
 
 				if (!handle->empty())
 				{
-					stack_.push_back(-handle->size());  // XXX valueStack rewind-magic
+					stack_.push_back(-static_cast<int>(handle->size()));  // XXX valueStack rewind-magic
 					for (const int x : reversed(*handle))
 						stack_.push_back(StateValue{x});
 				}
 				else
 				{
-					// epsilon-rule being applied
-					assert(!valueStack_.empty());
-					valueStack_.emplace_back(move(valueStack_.back()));
+					// epsilon-rule being applied, leaving the values before it untouched
+					valueStack_.emplace_back();
 				}
 			}
 			else
@@ -130,65 +149,70 @@ std::optional<SemanticValue> Analyzer<SemanticValue>::analyze()
 		else  // if (isAction(X))
 		{
 			assert(isAction(X));
-			log(fmt::format("    running action: {}", actionName(X)));
+			if constexpr (Trace)
+				log(fmt::format("    running action: {}", actionName(X)));
 			stack_.pop_back();
 			if (actionHandler_)
 				valueStack_.emplace_back(actionHandler_(X, *this));
 			else
-				valueStack_.emplace_back(SemanticValue{});
+				valueStack_.emplace_back();
 		}
 	}
 }
 
-template <typename SemanticValue>
-std::optional<SyntaxTable::Expression> Analyzer<SemanticValue>::getHandleFor(StateValue nonterminal,
-																			 Terminal currentTerminal) const
+template <typename SemanticValue, const bool Trace>
+std::optional<SyntaxTable::ProductionSpan> Analyzer<SemanticValue, Trace>::getHandleFor(
+	StateValue nonterminal, Terminal currentTerminal) const
 {
-	if (std::optional<int> p_i = def_.lookup(nonterminal, currentTerminal); p_i.has_value())
-		return def_.productions[*p_i];
+	if (const SyntaxTable::ProductionId p_i = def_.handle(nonterminal, currentTerminal);
+		p_i != SyntaxTable::NoProduction)
+		return def_.production(p_i);
 
 	return std::nullopt;
 }
 
-template <typename SemanticValue>
-bool Analyzer<SemanticValue>::isTerminal(StateValue v) const noexcept
+template <typename SemanticValue, const bool Trace>
+bool Analyzer<SemanticValue, Trace>::isTerminal(StateValue v) const noexcept
 {
 	return def_.isTerminal(v);
 }
 
-template <typename SemanticValue>
-bool Analyzer<SemanticValue>::isNonTerminal(StateValue v) const noexcept
+template <typename SemanticValue, const bool Trace>
+bool Analyzer<SemanticValue, Trace>::isNonTerminal(StateValue v) const noexcept
 {
 	return def_.isNonTerminal(v);
 }
 
-template <typename SemanticValue>
-bool Analyzer<SemanticValue>::isAction(StateValue v) const noexcept
+template <typename SemanticValue, const bool Trace>
+bool Analyzer<SemanticValue, Trace>::isAction(StateValue v) const noexcept
 {
 	return def_.isAction(v);
 }
 
-template <typename SemanticValue>
-void Analyzer<SemanticValue>::log(const std::string& msg)
+template <typename SemanticValue, const bool Trace>
+void Analyzer<SemanticValue, Trace>::log(const std::string& msg) const
 {
-	fmt::print("Analyzer: {}\n", msg);
+	if (logger_)
+		logger_(msg);
+	else
+		fmt::print("Analyzer: {}\n", msg);
 }
 
-template <typename SemanticValue>
-std::string Analyzer<SemanticValue>::dumpStateStack() const
+template <typename SemanticValue, const bool Trace>
+std::string Analyzer<SemanticValue, Trace>::dumpStateStack() const
 {
 	return util::join(util::translate(stack_, [this](StateValue sv) { return stateValue(sv); }), " ");
 }
 
-template <typename SemanticValue>
-std::string Analyzer<SemanticValue>::dumpSemanticStack() const
+template <typename SemanticValue, const bool Trace>
+std::string Analyzer<SemanticValue, Trace>::dumpSemanticStack() const
 {
-	return util::join(util::translate(valueStack_, [](SemanticValue sv) { return fmt::format("{}", sv); }),
-					  " ");
+	return util::join(
+		util::translate(valueStack_, [](const SemanticValue& sv) { return fmt::format("{}", sv); }), " ");
 }
 
-template <typename SemanticValue>
-std::string Analyzer<SemanticValue>::stateValue(StateValue sv) const
+template <typename SemanticValue, const bool Trace>
+std::string Analyzer<SemanticValue, Trace>::stateValue(StateValue sv) const
 {
 	assert(isNonTerminal(sv) || isTerminal(sv) || isAction(sv) || sv < 0);
 
@@ -203,8 +227,8 @@ std::string Analyzer<SemanticValue>::stateValue(StateValue sv) const
 		return fmt::format("!{}", def_.actionName(sv));
 }
 
-template <typename SemanticValue>
-std::string Analyzer<SemanticValue>::handleString(const SyntaxTable::Expression& handle) const
+template <typename SemanticValue, const bool Trace>
+std::string Analyzer<SemanticValue, Trace>::handleString(const SyntaxTable::ProductionSpan& handle) const
 {
 	return util::join(util::translate(handle, [this](auto v) { return stateValue(v); }), " ");
 }
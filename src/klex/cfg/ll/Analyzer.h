@@ -11,7 +11,6 @@
 #include <klex/cfg/ll/SyntaxTable.h>
 #include <klex/regular/Lexer.h>
 
-#include <deque>
 #include <functional>
 #include <optional>
 #include <utility>
@@ -19,14 +18,22 @@
 
 namespace klex::cfg::ll {
 
-template <typename SemanticValue>
+/**
+ * LL(1) table driven parser.
+ *
+ * With @p Trace set, each step of the analysis (and of the underlying lexer) is formatted and
+ * passed to the TraceLogger (printed to stdout if none is given). Otherwise no tracing code is
+ * compiled in at all, and @p SemanticValue need not be formattable.
+ */
+template <typename SemanticValue, const bool Trace = false>
 class Analyzer {
   public:
 	using Terminal = regular::Tag;  // typename regular::Lexer<regular::Tag>::value_type;
 	using NonTerminal = int;
 	using Action = int;
-	using Lexer = regular::Lexer<regular::Tag, regular::StateId, true, false>;
-	using ActionHandler = std::function<SemanticValue(int, const Analyzer<SemanticValue>&)>;
+	using Lexer = regular::Lexer<regular::Tag, regular::StateId, true, Trace>;
+	using ActionHandler = std::function<SemanticValue(int, const Analyzer<SemanticValue, Trace>&)>;
+	using TraceLogger = std::function<void(const std::string&)>;
 
 	struct StateValue {
 		int value;
@@ -35,7 +42,7 @@ class Analyzer {
 	};
 
 	Analyzer(const SyntaxTable& table, Report* report, std::string input,
-			 ActionHandler actionHandler = ActionHandler());
+			 ActionHandler actionHandler = ActionHandler(), TraceLogger logger = TraceLogger());
 
 	[[nodiscard]] const Lexer& lexer() const noexcept { return lexer_; }
 	[[nodiscard]] const std::string& lastLiteral() const noexcept { return lastLiteral_; }
@@ -52,27 +59,28 @@ class Analyzer {
 	[[nodiscard]] std::optional<SemanticValue> analyze();
 
   private:
-	[[nodiscard]] std::optional<SyntaxTable::Expression> getHandleFor(StateValue nonterminal,
-																	Terminal currentTerminal) const;
+	[[nodiscard]] std::optional<SyntaxTable::ProductionSpan> getHandleFor(StateValue nonterminal,
+																		Terminal currentTerminal) const;
 
 	[[nodiscard]] bool isAction(StateValue v) const noexcept;
 	[[nodiscard]] bool isTerminal(StateValue v) const noexcept;
 	[[nodiscard]] bool isNonTerminal(StateValue v) const noexcept;
 
-	void log(const std::string& msg);
+	void log(const std::string& msg) const;
 
 	[[nodiscard]] std::string dumpStateStack() const;
 	[[nodiscard]] std::string dumpSemanticStack() const;
 	[[nodiscard]] std::string stateValue(StateValue sv) const;
-	[[nodiscard]] std::string handleString(const SyntaxTable::Expression& handle) const;
+	[[nodiscard]] std::string handleString(const SyntaxTable::ProductionSpan& handle) const;
 
   private:
 	const SyntaxTable& def_;
+	TraceLogger logger_;  //!< initialized before lexer_, which may trace already while being constructed
 	Lexer lexer_;
 	std::string lastLiteral_;
 	Report* report_;
-	std::deque<StateValue> stack_;
-	std::deque<SemanticValue> valueStack_;
+	std::vector<StateValue> stack_;
+	std::vector<SemanticValue> valueStack_;
 	size_t valueStackBase_;
 	ActionHandler actionHandler_;
 };
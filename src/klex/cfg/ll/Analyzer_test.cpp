@@ -16,6 +16,7 @@
 #include <klex/util/literals.h>
 #include <klex/util/testing.h>
 
+#include <utility>
 #include <variant>
 
 using namespace std;
@@ -182,4 +183,94 @@ TEST(cfg_ll_Analyzer, ETF_with_actions)
     // TODO EXPECT_EQ(14, *result);
 }
 
+TEST(cfg_ll_Analyzer, trace)
+{
+    BufferedReport report;
+    Grammar grammar = GrammarParser("S ::= A; A ::= '(' B; B ::= A ')' | ')';", &report).parse();
+    ASSERT_FALSE(report.containsFailures());
+    grammar.finalize();
+    const SyntaxTable st = SyntaxTable::construct(grammar);
+
+    vector<string> trace;
+    Analyzer<int, true> tracing(st, &report, "(())", {}, [&](const string& msg) { trace.push_back(msg); });
+    EXPECT_TRUE(tracing.analyze().has_value());
+    EXPECT_TRUE(count(trace.begin(), trace.end(), "    eat terminal: RND_OPEN '('") == 2);
+
+    // without the Trace policy, nothing is formatted, not even the (non-formattable) semantic values
+    struct Value {};
+    Analyzer<Value> silent(st, &report, "(())");
+    EXPECT_TRUE(silent.analyze().has_value());
+    EXPECT_FALSE(report.containsFailures());
+}
+
+TEST(cfg_ll_Analyzer, semantic_values_are_moved)
+{
+    // a moved-from Value is visibly empty, so reading one through semanticValue() changes the sum
+    struct Value {
+        int number = 0;
+        size_t* copies = nullptr;
+
+        Value() = default;
+        Value(int n, size_t* c) : number { n }, copies { c } {}
+        Value(Value&& v) noexcept
+            : number { exchange(v.number, 0) }, copies { exchange(v.copies, nullptr) }
+        {
+        }
+        Value& operator=(Value&& v) noexcept
+        {
+            number = exchange(v.number, 0);
+            copies = exchange(v.copies, nullptr);
+            return *this;
+        }
+        Value(const Value& v) : number { v.number }, copies { v.copies }
+        {
+            if (copies)
+                ++*copies;
+        }
+        Value& operator=(const Value& v)
+        {
+            number = v.number;
+            copies = v.copies;
+            if (copies)
+                ++*copies;
+            return *this;
+        }
+    };
+
+    BufferedReport report;
+    Grammar grammar = GrammarParser(R"(`token {
+                                       `  Spacing(ignore) ::= [\s\t\n]+
+                                       `  Number          ::= [0-9]+
+                                       `}
+                                       `Start     ::= Sum        {result};
+                                       `Sum       ::= F Sum_;
+                                       `Sum_      ::= '+' F Sum_ {add}
+                                       `            | ;
+                                       `F         ::= Number     {num};
+                                       `)"_multiline,
+                                    &report)
+                          .parse();
+    ASSERT_FALSE(report.containsFailures());
+    grammar.finalize();
+    const SyntaxTable st = SyntaxTable::construct(grammar);
+
+    size_t copies = 0;
+    const auto actionHandler = [&](int id, const Analyzer<Value>& analyzer) -> Value {
+        if (analyzer.actionName(id) == "num")
+            return Value { stoi(analyzer.lastLiteral()), &copies };
+        else if (analyzer.actionName(id) == "add") // the inner Sum_ at -1 is the epsilon rule
+            return Value { analyzer.semanticValue(-2).number + analyzer.semanticValue(-4).number, &copies };
+        else // result: Start ::= Sum <<EOF>> {result}
+            return Value { analyzer.semanticValue(-2).number, &copies };
+    };
+
+    Analyzer<Value> parser(st, &report, "20 + 22", actionHandler);
+    const optional<Value> result = parser.analyze();
+
+    EXPECT_FALSE(report.containsFailures());
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(42, result->number);
+    EXPECT_EQ(0, copies);
+}
+
 // vim:ts=4:sw=4:noet
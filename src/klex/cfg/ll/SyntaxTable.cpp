@@ -6,6 +6,7 @@
 // the License at: http://opensource.org/licenses/MIT
 
 #include <klex/cfg/Grammar.h>
+#include <klex/cfg/SymbolTable.h>
 #include <klex/cfg/ll/SyntaxTable.h>
 #include <klex/regular/Compiler.h>
 #include <klex/regular/LexerDef.h>
@@ -20,22 +21,44 @@
 #include <iostream>
 #include <map>
 #include <sstream>
+#include <variant>
 
 using namespace std;
 using namespace klex;
 using namespace klex::cfg;
 using namespace klex::cfg::ll;
 
-template <typename T, typename V = int, typename F = function<bool(const T&)>>
-inline map<T, V> createIdMap(
-    const vector<T>& items, V first, F select = [](const T&) { return true; })
+namespace
 {
-    map<T, V> out;
-    for (auto i = begin(items); i != end(items); ++i)
-        if (select(*i))
-            out[*i] = first + static_cast<V>(distance(begin(items), i));
-    return out;
-}
+    /**
+     * Maps the grammar's symbols onto the SyntaxTable's IDs, i.e. its symbol table's IDs with the
+     * terminals following the non-terminals and the actions following the terminals.
+     */
+    struct SymbolIds
+    {
+        const SymbolTable& symbolTable;
+        int terminalMin;
+        int actionMin;
+
+        explicit SymbolIds(const Grammar& grammar):
+            symbolTable { grammar.symbolTable },
+            terminalMin { static_cast<int>(grammar.nonterminals.size()) },
+            actionMin { terminalMin + static_cast<int>(grammar.symbolTable.terminalCount()) }
+        {
+        }
+
+        int operator()(const NonTerminal& nt) const { return symbolTable.nonterminalId(nt.name); }
+
+        //! @returns the terminal's ID, or SymbolTable::None if it is not used by any production.
+        int operator()(const Terminal& w) const
+        {
+            const SymbolTable::Id id = symbolTable.terminalId(w.pattern());
+            return id != SymbolTable::None ? terminalMin + id : SymbolTable::None;
+        }
+
+        int operator()(const Action& a) const { return actionMin + symbolTable.actionId(a.id); }
+    };
+} // namespace
 
 optional<int> SyntaxTable::lookup(int nonterminal, int lookahead) const
 {
@@ -77,35 +100,24 @@ struct TerminalRuleBuilder
 
 SyntaxTable SyntaxTable::construct(const Grammar& grammar)
 {
-    map<NonTerminal, int> idNonTerminals = createIdMap(grammar.nonterminals, 0);
-    map<Terminal, int> idTerminals =
-        createIdMap(grammar.terminals, (int) grammar.nonterminals.size(), [](const Terminal& w) -> bool {
-            return !holds_alternative<regular::Rule>(w.literal)
-                   || get<regular::Rule>(w.literal).tag != regular::IgnoreTag;
-        });
-    map<Action, int> idActions =
-        createIdMap(actions(grammar), static_cast<int>(idNonTerminals.size() + idTerminals.size()));
-    map<NonTerminal, int> idProductionsByName;
-    for (auto i = begin(grammar.productions); i != end(grammar.productions); ++i)
-        idProductionsByName[NonTerminal { i->name }] =
-            static_cast<int>(distance(begin(grammar.productions), i));
+    const SymbolIds ids { grammar };
+    const SymbolTable& symbolTable = grammar.symbolTable;
 
     SyntaxTable st;
 
-    st.names.resize(idNonTerminals.size() + idTerminals.size() + idActions.size());
+    st.names.resize(grammar.nonterminals.size() + symbolTable.terminalCount() + symbolTable.actionCount());
 
-    for (auto&& [nt, id]: idNonTerminals)
-        st.names[id] = nt.name;
+    for (const NonTerminal& nt: grammar.nonterminals)
+        st.names[ids(nt)] = nt.name;
 
-    for (auto&& [t, id]: idTerminals)
-        st.names[id] = t.name;
+    for (const Terminal& t: grammar.terminals)
+        if (const int id = ids(t); id != SymbolTable::None)
+            st.names[id] = t.name;
 
-    st.actionNames.resize(idActions.size());
-    for (auto&& [act, id]: idActions)
+    for (SymbolTable::Id i = 0; i < static_cast<SymbolTable::Id>(symbolTable.actionCount()); ++i)
     {
-        st.names[id] = act.id;
-        const size_t i = id - idNonTerminals.size() - idTerminals.size();
-        st.actionNames[i] = act.id;
+        st.names[ids.actionMin + i] = symbolTable.actionName(i);
+        st.actionNames.emplace_back(symbolTable.actionName(i));
     }
 
     // terminals
@@ -138,15 +150,15 @@ SyntaxTable SyntaxTable::construct(const Grammar& grammar)
     st.nonterminalNames.resize(grammar.nonterminals.size());
     for (const NonTerminal& nt: grammar.nonterminals)
     {
-        const int nt_ = idNonTerminals[nt];
+        const int nt_ = ids(nt);
         st.nonterminalNames[nt_] = nt.name;
-        st.names[nt_] = nt.name;
-        for (const Production* p: grammar.getProductions(nt))
+        for (size_t i: grammar.productionIndex[nt_])
         {
-            for (const Terminal& w: p->first1())
+            const Production& p = grammar.productions[i];
+            for (const Terminal& w: p.first1())
             {
-                assert(st.table[nt_].find(idTerminals[w]) == st.table[nt_].end());
-                st.table[nt_][idTerminals[w]] = p->id;
+                assert(st.table[nt_].find(ids(w)) == st.table[nt_].end());
+                st.table[nt_][ids(w)] = p.id;
             }
 
             // TODO if (p->first1().contains(eof))
@@ -154,35 +166,45 @@ SyntaxTable SyntaxTable::construct(const Grammar& grammar)
         }
     }
 
+    // freeze the syntax table into its dense form
+    st.denseTable.assign(st.nonterminalCount() * st.terminalCount(), NoProduction);
+    for (auto&& [nt, lookaheads]: st.table)
+        for (auto&& [w, p]: lookaheads)
+            st.denseTable[static_cast<size_t>(nt - st.nonterminalMin()) * st.terminalCount()
+                          + static_cast<size_t>(w - st.terminalMin())] = p;
+
     // add productions to SyntaxTable
     for (const Production& p: grammar.productions)
     {
         SyntaxTable::Expression expr;
-        expr.reserve(symbols(p.handle).size());
+        expr.reserve(p.handle.size());
 
-        for (const HandleElement b: p.handle)
-            if (holds_alternative<NonTerminal>(b))
-                expr.emplace_back(idNonTerminals[get<NonTerminal>(b)]);
-            else if (holds_alternative<Terminal>(b))
-                expr.emplace_back(idTerminals[get<Terminal>(b)]);
-            else
-                expr.emplace_back(idActions[get<Action>(b)]);
+        for (const HandleElement& b: p.handle)
+            expr.emplace_back(visit(ids, b));
 
         st.productionNames.emplace_back(p.name);
         st.productions.emplace_back(move(expr));
     }
 
+    // flatten the productions into one symbol array
+    st.productionOffsets.reserve(st.productions.size() + 1);
+    for (const SyntaxTable::Expression& expr: st.productions)
+    {
+        st.productionOffsets.emplace_back(st.productionSymbols.size());
+        st.productionSymbols.insert(st.productionSymbols.end(), expr.begin(), expr.end());
+    }
+    st.productionOffsets.emplace_back(st.productionSymbols.size());
+
     // TODO: action names
 
-    st.startSymbol = idNonTerminals[NonTerminal { grammar.productions[0].name }];
+    st.startSymbol = ids(NonTerminal { grammar.productions[0].name });
 
     return st;
 }
 
 string SyntaxTable::dump(const Grammar& grammar) const
 {
-    map<NonTerminal, int> idNonTerminals = createIdMap(grammar.nonterminals, 0);
-    map<Terminal, int> idTerminals = createIdMap(grammar.terminals, (int) grammar.nonterminals.size());
+    const SymbolIds ids { grammar };
 
     stringstream os;
 
@@ -234,16 +256,11 @@ string SyntaxTable::dump(const Grammar& grammar) const
     bprintf("\n");
 
     // table-body
-    set<NonTerminal> check;
-    for (const Production& production: grammar.productions)
+    for (const NonTerminal& nt: grammar.nonterminals)
     {
-        const NonTerminal nt { production.name };
-        if (check.count(nt))
-            continue;
-        check.insert(nt);
         bprintf("%16s |", nt.name.c_str());
         for (const Terminal& t: grammar.terminals)
-            if (optional<int> p = lookup(idNonTerminals[nt], idTerminals[t]); p.has_value())
+            if (optional<int> p = lookup(ids(nt), ids(t)); p.has_value())
                 bprintf("%10d |", *p);
             else
                 bprintf("           |");
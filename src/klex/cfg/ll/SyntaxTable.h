@@ -10,6 +10,8 @@
 #include <klex/regular/LexerDef.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <optional>
 #include <stack>
 #include <unordered_map>
@@ -32,6 +34,23 @@ struct SyntaxTable {
 	using LookAheadMap = std::unordered_map<int /*lookahead*/, int /*production*/>;
 	using NonTerminalMap = std::unordered_map<int /*nonterminals*/, LookAheadMap>;
 	using ProductionVec = std::vector<Expression>;
+	using ProductionId = int32_t;
+
+	//! Value of a handle() without any production.
+	static constexpr ProductionId NoProduction = -1;
+
+	//! Non-owning view onto the symbols of a single production (see production()).
+	struct ProductionSpan {
+		const int* first;
+		const int* last;
+
+		const int* begin() const noexcept { return first; }
+		const int* end() const noexcept { return last; }
+		std::reverse_iterator<const int*> crbegin() const noexcept { return std::reverse_iterator{last}; }
+		std::reverse_iterator<const int*> crend() const noexcept { return std::reverse_iterator{first}; }
+		size_t size() const noexcept { return static_cast<size_t>(last - first); }
+		bool empty() const noexcept { return first == last; }
+	};
 
 	std::vector<std::string> names;
 	std::vector<std::string> terminalNames;
@@ -39,7 +58,10 @@ struct SyntaxTable {
 	std::vector<std::string> actionNames;
 	std::vector<std::string> productionNames;
 	ProductionVec productions;
-	NonTerminalMap table;
+	std::vector<int> productionSymbols;     //!< all productions' symbols back to back (see production())
+	std::vector<size_t> productionOffsets;  //!< offsets into productionSymbols per production, plus the end
+	NonTerminalMap table;  //!< sparse parse table, kept for lookup() and dump()
+	std::vector<ProductionId> denseTable;  //!< nonterminals x terminals parse table, see handle()
 	int startSymbol;
 	regular::LexerDef lexerDef;
 
@@ -52,6 +74,28 @@ struct SyntaxTable {
 
 	std::optional<int> lookup(int nonterminal, int lookahead) const;
 
+	/**
+	 * Retrieves the production to expand @p nonterminal into with the given @p lookahead, as a single
+	 * indexed load from the dense parse table.
+	 *
+	 * @returns the production's ID or NoProduction if there is none (or @p lookahead is no terminal).
+	 */
+	ProductionId handle(int nonterminal, int lookahead) const noexcept
+	{
+		if (!isTerminal(lookahead))
+			return NoProduction;
+
+		return denseTable[static_cast<size_t>(nonterminal - nonterminalMin()) * terminalCount()
+						  + static_cast<size_t>(lookahead - terminalMin())];
+	}
+
+	//! Retrieves the symbols of the production @p id without copying them.
+	ProductionSpan production(ProductionId id) const noexcept
+	{
+		const int* symbols = productionSymbols.data();
+		return ProductionSpan{symbols + productionOffsets[id], symbols + productionOffsets[id + 1]};
+	}
+
 	size_t nonterminalCount() const noexcept { return nonterminalNames.size(); }
 	size_t terminalCount() const noexcept { return terminalNames.size(); }
 
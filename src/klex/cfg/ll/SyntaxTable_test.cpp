@@ -12,6 +12,8 @@
 #include <klex/util/literals.h>
 #include <klex/util/testing.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace klex;
 using namespace klex::cfg;
@@ -53,7 +55,35 @@ TEST(cfg_ll_SyntaxTable, construct_right_recursive)
     log("Syntax Table:");
     log(st.dump(grammar));
 
-    // TODO
+    // the dense table agrees with the sparse one
+    for (int nt = st.nonterminalMin(); nt <= st.nonterminalMax(); ++nt)
+        for (int w = st.terminalMin(); w <= st.terminalMax(); ++w)
+            EXPECT_EQ(st.lookup(nt, w).value_or(SyntaxTable::NoProduction), st.handle(nt, w));
+
+    const auto nonterminal = [&](const string& name) {
+        return static_cast<int>(find(st.nonterminalNames.begin(), st.nonterminalNames.end(), name)
+                                - st.nonterminalNames.begin());
+    };
+    const auto terminal = [&](const string& name) {
+        return st.terminalMin()
+               + static_cast<int>(find(st.terminalNames.begin(), st.terminalNames.end(), name)
+                                  - st.terminalNames.begin());
+    };
+
+    const SyntaxTable::ProductionId p = st.handle(nonterminal("Factor"), terminal("Number"));
+    ASSERT_NE(SyntaxTable::NoProduction, p);
+    EXPECT_EQ("Factor", st.productionNames[p]);
+    EXPECT_EQ(1, st.productions[p].size());
+    EXPECT_EQ(SyntaxTable::NoProduction, st.handle(nonterminal("Factor"), terminal("Spacing")));
+    EXPECT_EQ(SyntaxTable::NoProduction, st.handle(nonterminal("Factor"), nonterminal("Term")));
+
+    // the production spans view the same symbols
+    for (size_t i = 0; i < st.productions.size(); ++i)
+    {
+        const SyntaxTable::ProductionSpan span = st.production(static_cast<SyntaxTable::ProductionId>(i));
+        EXPECT_TRUE(st.productions[i] == vector<int>(span.begin(), span.end()));
+    }
+    EXPECT_TRUE(st.production(st.handle(nonterminal("Expr_"), terminal("EOF"))).empty());
 }
 
 // vim:ts=4:sw=4:noet
@@ -0,0 +1,281 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/BitParallelNFA.h>
+#include <klex/regular/Symbols.h>
+#include <klex/util/bits.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+/* Bit-parallel simulation visualization
+  NFA:        n0 --a--> n1 --ε--> n2 --b--> n3 --ε--> n2 (accepting: n3)   (ab+)
+
+  POSITIONS:  p0 = (n0,n1) on a,  p1 = (n2,n3) on b
+
+  FOLLOW:     p0: {p1}   (closure(n1) = {n1,n2}, n2 is the source of p1)
+              p1: {p1}   (closure(n3) = {n3,n2})
+
+  SCAN "abb": D1 = initial & B[a]    = {p0}
+              D2 = Follow(D1) & B[b] = {p1}   (accepting)
+              D3 = Follow(D2) & B[b] = {p1}   (accepting)
+*/
+
+namespace
+{
+    using Bits = array<uint64_t, BitParallelNFA::MaxPositions / 64>;
+
+    void set(Bits& bits, size_t i)
+    {
+        bits[i / 64] |= uint64_t(1) << (i % 64);
+    }
+
+    Bits operator&(const Bits& a, const Bits& b)
+    {
+        Bits result;
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = a[i] & b[i];
+        return result;
+    }
+
+    Bits& operator|=(Bits& a, const Bits& b)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] |= b[i];
+        return a;
+    }
+
+    bool any(const Bits& bits)
+    {
+        for (uint64_t word: bits)
+            if (word)
+                return true;
+        return false;
+    }
+
+    //! Invokes @p f for each bit set in @p bits, in ascending order.
+    template <typename F>
+    void forEach(const Bits& bits, F f)
+    {
+        for (size_t i = 0; i < bits.size(); ++i)
+            for (uint64_t word = bits[i]; word != 0; word &= word - 1)
+                f(i * 64 + util::countTrailingZeros(word));
+    }
+
+    size_t symbolIndex(Symbol s)
+    {
+        return s == Symbols::EndOfFile ? 256 : static_cast<size_t>(s);
+    }
+} // namespace
+
+BitParallelNFA::BitParallelNFA(const map<string, NFA>& automata): programs_ {}, machines_ {}
+{
+    for (const pair<const string, NFA>& fa: automata)
+    {
+        machines_[fa.first] = programs_.size();
+        programs_.emplace_back(compile(fa.first, fa.second));
+    }
+}
+
+BitParallelNFA::Program BitParallelNFA::compile(const string& machine, const NFA& nfa)
+{
+    // collect positions, i.e. all (source, target) pairs of symbol transitions
+    vector<pair<StateId, StateId>> edges;
+    vector<vector<Symbol>> edgeSymbols;
+    map<pair<StateId, StateId>, size_t> edgeIds;
+    for (StateId s = 0; s < nfa.size(); ++s)
+    {
+        for (const pair<const Symbol, StateIdVec>& transition: nfa.states()[s])
+        {
+            if (transition.first != Symbols::EndOfFile && (transition.first < 0 || transition.first > 255))
+                continue; // epsilon, or never fed to the simulation
+
+            for (StateId t: transition.second)
+            {
+                auto [i, inserted] = edgeIds.emplace(make_pair(s, t), edges.size());
+                if (inserted)
+                {
+                    edges.emplace_back(s, t);
+                    edgeSymbols.emplace_back();
+                }
+                edgeSymbols[i->second].push_back(transition.first);
+            }
+        }
+    }
+
+    if (edges.size() > MaxPositions)
+        throw TooManyPositions { machine, edges.size() };
+
+    Program program {};
+    program.positions = edges.size();
+    program.symbols.resize(SymbolCount);
+    program.tags.resize(edges.size());
+    program.backtrack.resize(edges.size());
+
+    // positions leaving each NFA state
+    vector<vector<size_t>> leaving(nfa.size());
+    for (size_t p = 0; p < edges.size(); ++p)
+    {
+        leaving[edges[p].first].push_back(p);
+        for (Symbol c: edgeSymbols[p])
+            set(program.symbols[symbolIndex(c)], p);
+    }
+
+    for (StateId s = 0; s < nfa.size(); ++s)
+    {
+        if (optional<StateId> target = nfa.backtrack(s); target.has_value())
+        {
+            auto i = program.backtrackTargets.emplace(*target, program.backtrackTargets.size()).first;
+            program.backtrackSlots[s] = i->second;
+        }
+    }
+    program.containing.resize(program.backtrackTargets.size());
+
+    // if multiple rules accept, the one declared first (lowest tag) wins
+    auto lowestTag = [&](const StateIdVec& configuration) {
+        optional<Tag> result;
+        for (StateId q: configuration)
+            if (optional<Tag> tag = nfa.acceptTag(q); tag.has_value() && (!result || *tag < *result))
+                result = tag;
+        return result;
+    };
+
+    const StateIdVec initial = nfa.epsilonClosure({ nfa.initialStateId() });
+    program.initialTag = lowestTag(initial);
+    for (StateId q: initial)
+        for (size_t p: leaving[q])
+            set(program.initial, p);
+
+    if (optional<StateId> bol = nfa.beginOfLineStateId(); bol.has_value())
+    {
+        const StateIdVec configuration = nfa.epsilonClosure({ *bol });
+        program.beginOfLineTag = lowestTag(configuration);
+        program.beginOfLine.emplace();
+        for (StateId q: configuration)
+            for (size_t p: leaving[q])
+                set(*program.beginOfLine, p);
+    }
+
+    vector<Bits> follow(edges.size());
+    for (size_t p = 0; p < edges.size(); ++p)
+    {
+        const StateIdVec configuration = nfa.epsilonClosure({ edges[p].second });
+        for (StateId q: configuration)
+        {
+            for (size_t f: leaving[q])
+                set(follow[p], f);
+            if (auto i = program.backtrackTargets.find(q); i != program.backtrackTargets.end())
+                set(program.containing[i->second], p);
+        }
+
+        if ((program.tags[p] = lowestTag(configuration)).has_value())
+            set(program.accepting, p);
+
+        for (StateId q: configuration)
+        {
+            if (nfa.backtrack(q).has_value())
+            {
+                program.backtrack[p] = q;
+                set(program.backtracking, p);
+                break;
+            }
+        }
+    }
+
+    // Follow(D) is the union of follow(p) for all p in D, looked up byte by byte, such that
+    // follow[256 * i + v] is the union for the byte value v at byte offset i of D.
+    const size_t bytes = (edges.size() + 7) / 8;
+    program.follow.resize(256 * bytes);
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        for (unsigned v = 1; v < 256; ++v)
+        {
+            const size_t p = 8 * i + util::countTrailingZeros(v);
+            Bits& entry = program.follow[256 * i + v];
+            entry = program.follow[256 * i + (v & (v - 1))];
+            if (p < edges.size())
+                entry |= follow[p];
+        }
+    }
+
+    return program;
+}
+
+BitParallelNFA::Bits BitParallelNFA::followOf(const Program& program, const Bits& D)
+{
+    Bits result {};
+    const size_t bytes = program.follow.size() / 256;
+    for (size_t i = 0; i < bytes; ++i)
+        if (const unsigned v = (D[i / 8] >> (8 * (i % 8))) & 0xFF; v != 0)
+            result |= program.follow[256 * i + v];
+    return result;
+}
+
+optional<BitParallelNFA::Match> BitParallelNFA::recognize(string_view input,
+                                                          bool isBeginOfLine,
+                                                          const string& machine) const
+{
+    auto m = machines_.find(machine);
+    assert(m != machines_.end() && "No such machine.");
+    const Program& program = programs_[m->second];
+    const bool bol = isBeginOfLine && program.beginOfLine.has_value();
+
+    optional<Tag> tag = bol ? program.beginOfLineTag : program.initialTag;
+    size_t length = 0;
+
+    // lastSeen[slot] is the last offset whose configuration contained the slot's backtracking target,
+    // falling back to the very beginning (as the Lexer does)
+    vector<size_t> lastSeen(program.backtrackTargets.size(), 0);
+
+    Bits D = bol ? *program.beginOfLine : program.initial;
+    for (size_t i = 0; i <= input.size(); ++i)
+    {
+        const Symbol c = i < input.size() ? static_cast<unsigned char>(input[i]) : Symbols::EndOfFile;
+        D = (i == 0 ? D : followOf(program, D)) & program.symbols[symbolIndex(c)];
+        if (!any(D))
+            break;
+
+        if (const Bits accepting = D & program.accepting; any(accepting))
+        {
+            tag.reset();
+            forEach(accepting, [&](size_t p) {
+                if (!tag || *program.tags[p] < *tag)
+                    tag = program.tags[p];
+            });
+
+            optional<StateId> backtrack;
+            forEach(D & program.backtracking, [&](size_t p) {
+                if (!backtrack || *program.backtrack[p] < *backtrack)
+                    backtrack = program.backtrack[p];
+            });
+
+            // backtrack to the right-most non-lookahead position
+            length = backtrack ? lastSeen[program.backtrackSlots.at(*backtrack)] : i + 1;
+        }
+
+        for (size_t slot = 0; slot < lastSeen.size(); ++slot)
+            if (any(D & program.containing[slot]))
+                lastSeen[slot] = i + 1;
+    }
+
+    if (!tag.has_value())
+        return nullopt;
+
+    return Match { *tag, min(length, input.size()) };
+}
+
+size_t BitParallelNFA::size(const string& machine) const
+{
+    return programs_[machines_.at(machine)].positions;
+}
+
+} // namespace klex::regular
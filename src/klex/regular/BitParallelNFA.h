@@ -0,0 +1,130 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/NFA.h>
+#include <klex/regular/State.h>
+
+#include <fmt/format.h>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Bit-parallel NFA simulation (Shift-And generalized to Glushkov positions).
+ *
+ * Every symbol transition (source, target) of an NFA becomes a position, that is, one bit.
+ * The set of active positions is then advanced by one input symbol via
+ *
+ *   D' := Follow(D) & B[c]
+ *
+ * where B[c] is the set of positions consuming c and Follow(D) is looked up byte-wise in
+ * precomputed tables. No DFA is built, so compiling is cheap, and scanning is linear
+ * in the input with a small constant.
+ *
+ * Only NFAs with at most MaxPositions symbol transitions are supported. Accept tags (lowest tag
+ * wins), lookahead backtracking and begin-of-line rules behave like the tables generated
+ * by the Compiler.
+ */
+class BitParallelNFA {
+  public:
+	//! Maximum number of positions (symbol transitions) per machine.
+	static constexpr size_t MaxPositions = 256;
+
+	class TooManyPositions;
+
+	struct Match {
+		Tag tag;
+		size_t length;  //!< number of input bytes matched (matching <<EOF>> does not count)
+	};
+
+	/**
+	 * Constructs a bit-parallel matcher for the given NFAs.
+	 *
+	 * @param automata one NFA per machine (condition), such as Compiler::automata()
+	 *
+	 * @throws TooManyPositions if any of the NFAs exceeds MaxPositions.
+	 */
+	explicit BitParallelNFA(const std::map<std::string, NFA>& automata);
+
+	/**
+	 * Recognizes the longest match of any rule at the beginning of @p input.
+	 *
+	 * @param input         the remaining input, whose end denotes the end of file
+	 * @param isBeginOfLine whether or not @p input starts at the beginning of a line
+	 * @param machine       the machine (condition) to run
+	 *
+	 * @returns the match or std::nullopt if no rule matches.
+	 */
+	std::optional<Match> recognize(std::string_view input, bool isBeginOfLine = false,
+								   const std::string& machine = "INITIAL") const;
+
+	//! Retrieves the number of positions of the given @p machine.
+	size_t size(const std::string& machine = "INITIAL") const;
+
+  private:
+	static constexpr size_t Words = MaxPositions / 64;
+	static constexpr size_t SymbolCount = 257;  // all bytes plus <<EOF>>
+
+	using Bits = std::array<uint64_t, Words>;
+
+	//! The compiled form of a single NFA.
+	struct Program {
+		size_t positions;
+		Bits initial;                        // positions leaving the initial configuration
+		std::optional<Tag> initialTag;       // tag of the initial configuration (empty match)
+		std::optional<Bits> beginOfLine;     // positions leaving the begin-of-line initial configuration
+		std::optional<Tag> beginOfLineTag;
+		std::vector<Bits> symbols;           // B[c], indexed by symbol
+		std::vector<Bits> follow;            // Follow(D) per byte of D, 256 entries per byte
+		std::vector<std::optional<Tag>> tags;  // lowest tag reachable after having consumed a position
+		Bits accepting;
+		std::vector<std::optional<StateId>> backtrack;  // lowest NFA state with a backtrack, per position
+		Bits backtracking;
+		std::map<StateId, size_t> backtrackTargets;     // NFA state to backtrack to -> slot
+		std::map<StateId, size_t> backtrackSlots;       // NFA state with a backtrack -> its target's slot
+		std::vector<Bits> containing;                   // positions whose configuration contains slot's state
+	};
+
+	static Program compile(const std::string& machine, const NFA& nfa);
+	static Bits followOf(const Program& program, const Bits& D);
+
+  private:
+	std::vector<Program> programs_;
+	std::map<std::string, size_t> machines_;
+};
+
+/**
+ * Thrown when an NFA has too many symbol transitions to be simulated bit-parallel.
+ */
+class BitParallelNFA::TooManyPositions : public std::runtime_error {
+  public:
+	TooManyPositions(std::string machine, size_t positions)
+		: std::runtime_error{fmt::format(
+			  "Machine {} needs {} positions, exceeding the limit of {} for bit-parallel simulation.",
+			  machine, positions, MaxPositions)},
+		  machine_{std::move(machine)},
+		  positions_{positions}
+	{
+	}
+
+	const std::string& machine() const noexcept { return machine_; }
+	size_t positions() const noexcept { return positions_; }
+
+  private:
+	std::string machine_;
+	size_t positions_;
+};
+
+}  // namespace klex::regular
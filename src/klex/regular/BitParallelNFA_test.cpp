@@ -0,0 +1,67 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/BitParallelNFA.h>
+#include <klex/regular/Compiler.h>
+#include <klex/regular/test_util.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+TEST(regular_BitParallelNFA, lexing_equivalence)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    expectSameTokens(cc.compileMulti(), cc.compileBitParallelNFA(), sampleInput);
+}
+
+TEST(regular_BitParallelNFA, literal_rules)
+{
+    Compiler cc;
+    cc.parse(R"(|Spacing(ignore)  ::= [\s\t\n]+
+                |Eof              ::= <<EOF>>
+                |Less             ::= "<"
+                |LessEqual        ::= "<="
+                |ShiftLeft        ::= "<<"
+                |If               ::= if
+                |Ident            ::= [a-z]+
+                |)"_multiline);
+    expectSameTokens(cc.compileMulti(), cc.compileBitParallelNFA(), "< <= << <<<= if iff");
+}
+
+TEST(regular_BitParallelNFA, no_match)
+{
+    Compiler cc;
+    cc.parse(R"(|Eof     ::= <<EOF>>
+                |Number  ::= [0-9]{2,3}
+                |)"_multiline);
+    BitParallelNFA bp = cc.compileBitParallelNFA();
+
+    EXPECT_FALSE(bp.recognize("#").has_value());
+    EXPECT_FALSE(bp.recognize("9").has_value()); // Number needs 2 digits at least
+
+    optional<BitParallelNFA::Match> match = bp.recognize("12345");
+    ASSERT_TRUE(match.has_value());
+    EXPECT_EQ(2, match->tag);
+    EXPECT_EQ(3, match->length);
+}
+
+TEST(regular_BitParallelNFA, too_many_positions)
+{
+    Compiler cc;
+    cc.parse(R"(|Eof   ::= <<EOF>>
+                |Word  ::= [a-z]{300}
+                |)"_multiline);
+
+    EXPECT_THROW(cc.compileBitParallelNFA(), BitParallelNFA::TooManyPositions);
+}
@@ -0,0 +1,222 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/CombTable.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+namespace
+{
+    using Index = CombTable::Index;
+
+    //! A state's non-error cells, as (symbol index, target state) pairs in ascending symbol order.
+    using Row = vector<pair<Index, Index>>;
+
+    //! Number of most recent template states a state is compared against when choosing its default.
+    constexpr size_t MaxTemplateCandidates = 64;
+
+    //! Retrieves the cells of @p a that differ from @p b, with cells only @p b defines mapped to ErrorState.
+    Row difference(const Row& a, const Row& b)
+    {
+        Row diff;
+        auto i = a.begin();
+        auto k = b.begin();
+        while (i != a.end() || k != b.end())
+        {
+            if (k == b.end() || (i != a.end() && i->first < k->first))
+                diff.emplace_back(*i++);
+            else if (i == a.end() || k->first < i->first)
+                diff.emplace_back((k++)->first, static_cast<Index>(ErrorState));
+            else
+            {
+                if (i->second != k->second)
+                    diff.emplace_back(*i);
+                ++i;
+                ++k;
+            }
+        }
+        return diff;
+    }
+
+    //! The rows to store of all states, each relative to its default state (if any).
+    struct Rows
+    {
+        Symbol lo;
+        Symbol hi;
+        vector<Row> cells;
+        vector<Index> defaults;
+    };
+
+    Rows splitRows(const map<StateId, TransitionRanges>& transitions)
+    {
+        Symbol lo = numeric_limits<Symbol>::max();
+        Symbol hi = numeric_limits<Symbol>::min();
+        for (const pair<const StateId, TransitionRanges>& T: transitions)
+            for (const TransitionRanges::Range& r: T.second)
+            {
+                lo = min(lo, r.first);
+                hi = max(hi, r.last);
+            }
+
+        const size_t stateCount = transitions.rbegin()->first + 1;
+        vector<Row> rows(stateCount);
+        for (const pair<const StateId, TransitionRanges>& T: transitions)
+            for (const TransitionRanges::Range& r: T.second)
+                for (Symbol c = r.first; c <= r.last; ++c)
+                    rows[T.first].emplace_back(static_cast<Index>(c - lo), static_cast<Index>(r.target));
+
+        // choose a default state for each state, among those states that are fully stored themselves
+        vector<Row> cells(stateCount);
+        vector<Index> defaults(stateCount, CombTable::None);
+        vector<StateId> templates;
+        for (StateId s = 0; s < stateCount; ++s)
+        {
+            cells[s] = rows[s];
+            const size_t first = templates.size() > MaxTemplateCandidates
+                                     ? templates.size() - MaxTemplateCandidates
+                                     : 0;
+            for (size_t t = first; t < templates.size() && !cells[s].empty(); ++t)
+            {
+                if (Row diff = difference(rows[s], rows[templates[t]]); diff.size() < cells[s].size())
+                {
+                    cells[s] = move(diff);
+                    defaults[s] = static_cast<Index>(templates[t]);
+                }
+            }
+
+            if (defaults[s] == CombTable::None && !rows[s].empty())
+                templates.push_back(s);
+        }
+
+        return Rows { lo, hi, move(cells), move(defaults) };
+    }
+} // namespace
+
+CombTable CombTable::compress(const std::map<StateId, TransitionRanges>& transitions)
+{
+    if (transitions.empty())
+        return CombTable {};
+
+    Rows rows = splitRows(transitions);
+    const vector<Row>& cells = rows.cells;
+    const size_t stateCount = cells.size();
+
+    // place the widest rows first, each at the lowest offset it does not collide at
+    vector<StateId> order(stateCount);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](StateId a, StateId b) {
+        return cells[a].size() > cells[b].size();
+    });
+
+    vector<Index> base(stateCount, 0);
+    vector<Index> next;
+    vector<Index> check;
+    size_t firstFree = 0;                         // all cells before are in use
+    std::map<vector<Index>, size_t> shapeCursor; // per row shape, where to resume the search
+    for (StateId s: order)
+    {
+        const Row& row = cells[s];
+        if (row.empty())
+            continue;
+
+        // rows of the same shape (cells relative to the first one) collide at the same positions,
+        // so the search resumes right after where the last row of this shape was placed
+        const size_t lead = row.front().first;
+        vector<Index> shape;
+        for (const pair<Index, Index>& cell: row)
+            shape.push_back(cell.first - static_cast<Index>(lead));
+        size_t& cursor = shapeCursor[move(shape)];
+
+        auto isFree = [&](size_t i) { return i >= check.size() || check[i] == None; };
+        auto fits = [&](size_t p) {
+            return all_of(row.begin() + 1, row.end(), [&](const pair<Index, Index>& cell) {
+                return isFree(p - lead + cell.first);
+            });
+        };
+
+        // the first cell must land on a free one, which none before firstFree is
+        size_t p = max({ lead, firstFree, cursor });
+        while (!isFree(p) || !fits(p))
+            ++p;
+        cursor = p + 1;
+        const size_t b = p - lead;
+
+        const size_t end = b + row.back().first + 1;
+        if (end > check.size())
+        {
+            next.resize(end, None);
+            check.resize(end, None);
+        }
+
+        base[s] = static_cast<Index>(b);
+        for (const pair<Index, Index>& cell: row)
+        {
+            next[b + cell.first] = cell.second;
+            check[b + cell.first] = static_cast<Index>(s);
+        }
+        while (!isFree(firstFree))
+            ++firstFree;
+    }
+
+    return CombTable { rows.lo,
+                       static_cast<Index>(rows.hi - rows.lo + 1),
+                       move(base),
+                       move(next),
+                       move(check),
+                       move(rows.defaults) };
+}
+
+size_t CombTable::estimateFootprint(const std::map<StateId, TransitionRanges>& transitions)
+{
+    if (transitions.empty())
+        return 0;
+
+    // packed without gaps, though never shorter than the widest row
+    const Rows rows = splitRows(transitions);
+    size_t cells = 0;
+    size_t width = 0;
+    for (const Row& row: rows.cells)
+    {
+        cells += row.size();
+        if (!row.empty())
+            width = max(width, static_cast<size_t>(row.back().first - row.front().first + 1));
+    }
+    return sizeof(Index) * (2 * rows.cells.size() + 2 * max(cells, width));
+}
+
+std::map<Symbol, StateId> CombTable::map(StateId s) const
+{
+    std::map<Symbol, StateId> m;
+    for (Index i = 0; i < symbolCount_; ++i)
+        if (StateId t = apply(s, firstSymbol_ + static_cast<Symbol>(i)); t != ErrorState)
+            m[firstSymbol_ + static_cast<Symbol>(i)] = t;
+    return m;
+}
+
+vector<StateId> CombTable::states() const
+{
+    vector<StateId> v;
+    for (StateId s = 0; s < base_.size(); ++s)
+        if (!map(s).empty())
+            v.push_back(s);
+    return v;
+}
+
+size_t CombTable::usedCells() const
+{
+    return static_cast<size_t>(count_if(check_.begin(), check_.end(), [](Index i) { return i != None; }));
+}
+
+} // namespace klex::regular
@@ -0,0 +1,114 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/State.h>
+#include <klex/regular/Symbols.h>
+#include <klex/regular/TransitionRanges.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Row-displacement ("comb-vector") compressed transition table, as known from yacc and flex.
+ *
+ * The rows of all states are overlaid into the shared @c next and @c check vectors, each row
+ * shifted by its state's @c base offset such that no two non-empty cells collide:
+ *
+ * @code
+ *   i = base[s] + (c - firstSymbol)
+ *   phi(s, c) = check[i] == s ? next[i] : phi(default[s], c)
+ * @endcode
+ *
+ * A state may name a @c default state whose row it shares, storing only the cells it differs
+ * in (cells the default state defines but this state does not are stored as ErrorState).
+ */
+class CombTable {
+  public:
+	using Index = uint32_t;
+
+	//! Marks unused cells and states without a default state.
+	static constexpr Index None = static_cast<Index>(-1);
+
+	CombTable() : firstSymbol_{0}, symbolCount_{0}, base_{}, next_{}, check_{}, default_{} {}
+
+	CombTable(Symbol firstSymbol, Index symbolCount, std::vector<Index> base, std::vector<Index> next,
+			  std::vector<Index> check, std::vector<Index> defaults)
+		: firstSymbol_{firstSymbol},
+		  symbolCount_{symbolCount},
+		  base_{std::move(base)},
+		  next_{std::move(next)},
+		  check_{std::move(check)},
+		  default_{std::move(defaults)}
+	{
+	}
+
+	//! Compresses the given per-state transition ranges.
+	static CombTable compress(const std::map<StateId, TransitionRanges>& transitions);
+
+	/**
+	 * Predicts the footprint() of compress()'s table for the same @p transitions, choosing the
+	 * default states but not packing the rows, which are assumed to leave no gaps.
+	 */
+	static size_t estimateFootprint(const std::map<StateId, TransitionRanges>& transitions);
+
+	//! Retrieves the next state for the input (s, c) or ErrorState if not defined.
+	StateId apply(StateId s, Symbol c) const
+	{
+		const long i = static_cast<long>(c) - firstSymbol_;
+		if (i < 0 || i >= static_cast<long>(symbolCount_))
+			return ErrorState;
+
+		while (s < base_.size())
+		{
+			const size_t k = base_[s] + static_cast<size_t>(i);
+			if (k < check_.size() && check_[k] == s)
+				return next_[k];
+
+			if (default_[s] == None)
+				break;
+
+			s = default_[s];
+		}
+		return ErrorState;
+	}
+
+	//! Retrieves all transitions from state @p s.
+	std::map<Symbol, StateId> map(StateId s) const;
+
+	//! Retrieves the list of all states having at least one transition.
+	std::vector<StateId> states() const;
+
+	Symbol firstSymbol() const noexcept { return firstSymbol_; }
+	Index symbolCount() const noexcept { return symbolCount_; }
+	const std::vector<Index>& base() const noexcept { return base_; }
+	const std::vector<Index>& next() const noexcept { return next_; }
+	const std::vector<Index>& check() const noexcept { return check_; }
+	const std::vector<Index>& defaults() const noexcept { return default_; }
+
+	//! Number of cells in next/check that are actually in use.
+	size_t usedCells() const;
+
+	//! Number of bytes occupied by the table's arrays.
+	size_t footprint() const noexcept
+	{
+		return sizeof(Index) * (base_.size() + next_.size() + check_.size() + default_.size());
+	}
+
+  private:
+	Symbol firstSymbol_;
+	Index symbolCount_;
+	std::vector<Index> base_;
+	std::vector<Index> next_;
+	std::vector<Index> check_;
+	std::vector<Index> default_;
+};
+
+}  // namespace klex::regular
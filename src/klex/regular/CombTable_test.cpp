@@ -0,0 +1,145 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/CombTable.h>
+#include <klex/regular/Compiler.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/regular/test_util.h>
+#include <klex/util/testing.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+
+TEST(regular_CombTable, compress_equivalence)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    const LexerDef def = cc.compileMulti();
+
+    TransitionMap::Container container;
+    for (StateId s: def.transitions.states())
+        container[s] = *def.transitions.ranges(s);
+    const CombTable comb = CombTable::compress(container);
+
+    for (StateId s = 0; s < comb.base().size() + 2; ++s)
+        for (Symbol c = Symbols::EndOfFile - 1; c <= 300; ++c)
+            EXPECT_EQ(def.transitions.apply(s, c), comb.apply(s, c));
+
+    // far below a dense table
+    EXPECT_TRUE(comb.footprint() < comb.base().size() * comb.symbolCount() * sizeof(CombTable::Index));
+}
+
+TEST(regular_CombTable, default_states)
+{
+    // both states share all transitions on [a-z] but for 'x'
+    TransitionMap::Container container;
+    container[0].define('a', 'z', 1);
+    container[1].define('a', 'w', 1);
+    container[1].define('x', 2);
+    container[1].define('y', 'z', 1);
+
+    const CombTable comb = CombTable::compress(container);
+    EXPECT_TRUE(comb.defaults()[0] == CombTable::None);
+    EXPECT_EQ(0, comb.defaults()[1]);
+    EXPECT_EQ(27, comb.usedCells());
+
+    EXPECT_EQ(1, comb.apply(1, 'a'));
+    EXPECT_EQ(2, comb.apply(1, 'x'));
+    EXPECT_EQ(1, comb.apply(0, 'x'));
+    EXPECT_EQ(ErrorState, comb.apply(1, 'A'));
+}
+
+TEST(regular_CombTable, lexing_equivalence)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    const LexerDef ranges = cc.compileMulti();
+
+    Compiler cc2;
+    cc2.parse(sampleRules);
+    MultiDFA multiDFA = cc2.compileMultiDFA();
+    const LexerDef comb =
+        Compiler::generateTables(multiDFA, cc2.containsBeginOfLine(), cc2.names(), TableLayout::Comb);
+    EXPECT_TRUE(comb.transitions.layout() == TableLayout::Comb);
+
+    expectSameTokens(ranges, comb, sampleInput);
+}
+
+// ############################################################################
+
+class regular_TransitionMap : public klex::util::testing::Benchmark {
+  public:
+    regular_TransitionMap() : def_ { compile() }, input_ {}
+    {
+        for (int i = 0; i < 64; ++i)
+            input_ += sampleInput;
+        setBytesProcessed(input_.size());
+    }
+
+  protected:
+    static LexerDef compile()
+    {
+        Compiler cc;
+        cc.parse(sampleRules);
+        return cc.compileMulti();
+    }
+
+    //! Walks the transitions along the input, restarting in the initial state on error.
+    StateId scan(const TransitionMap& transitions) const
+    {
+        const StateId initialState = def_.initialStates.at("INITIAL");
+        StateId s = initialState;
+        for (const char ch: input_)
+            if ((s = transitions.apply(s, static_cast<unsigned char>(ch))) == ErrorState)
+                s = initialState;
+        return s;
+    }
+
+    TransitionMap converted(TableLayout layout) const
+    {
+        TransitionMap transitions = def_.transitions;
+        transitions.convert(layout);
+        return transitions;
+    }
+
+    const LexerDef def_;
+    string input_;
+};
+
+BENCHMARK_F(regular_TransitionMap, apply_ranges)
+{
+    klex::util::testing::doNotOptimize(scan(def_.transitions));
+}
+
+class regular_TransitionMap_comb : public regular_TransitionMap {
+  public:
+    regular_TransitionMap_comb() : transitions_ { converted(TableLayout::Comb) } {}
+
+  protected:
+    const TransitionMap transitions_;
+};
+
+BENCHMARK_F(regular_TransitionMap_comb, apply)
+{
+    klex::util::testing::doNotOptimize(scan(transitions_));
+}
+
+class regular_TransitionMap_classes : public regular_TransitionMap {
+  public:
+    regular_TransitionMap_classes() : transitions_ { converted(TableLayout::Classes) } {}
+
+  protected:
+    const TransitionMap transitions_;
+};
+
+BENCHMARK_F(regular_TransitionMap_classes, apply)
+{
+    klex::util::testing::doNotOptimize(scan(transitions_));
+}
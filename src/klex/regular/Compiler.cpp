@@ -13,12 +13,17 @@
 #include <klex/regular/MultiDFA.h>
 #include <klex/regular/NFA.h>
 #include <klex/regular/NFABuilder.h>
+#include <klex/regular/PositionDFABuilder.h>
 #include <klex/regular/RegExpr.h>
 #include <klex/regular/RegExprParser.h>
 #include <klex/regular/Rule.h>
 #include <klex/regular/RuleParser.h>
+#include <klex/regular/TableLayoutPlanner.h>
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
+#include <set>
 
 using namespace std;
 
@@ -41,36 +46,74 @@ void Compiler::declareAll(RuleList rules)
 
     // populate RegExpr
     for (Rule& rule: rules)
-        rule.regexpr = make_unique<RegExpr>(RegExprParser {}.parse(rule.pattern, rule.line, rule.column));
+        rule.regexpr = RegExprParser {}.parse(rule.pattern, rule.line, rule.column);
 
-    containsBeginOfLine_ = any_of(rules.begin(), rules.end(), ruleContainsBeginOfLine);
+    containsBeginOfLine_ =
+        containsBeginOfLine_ || any_of(rules.begin(), rules.end(), ruleContainsBeginOfLine);
 
-    if (containsBeginOfLine_)
+    if (construction_ == DFAConstruction::PositionAutomaton)
     {
-        // We have at least one BOL-rule.
-        for (Rule& rule: rules)
+        // No NFA needed, the DFA is built straight from each rule's RegExpr upon compilation.
+    }
+    else
+    {
+        // Collect all rule NFAs per condition first, then unite each condition's NFAs in one go.
+        // If there is at least one BOL-rule, each condition's NFA gets a second (begin-of-line) initial
+        // state, which additionally leads to the BOL-rules, such that no rule is declared twice.
+        //
+        // Plain literal rules (keywords, operators) do not go through NFABuilder but are collected
+        // into one trie per condition instead, which is deterministic already.
+        map<string, vector<NFA>> alternatives;
+        map<string, vector<NFA>> anchored;
+        for (pair<const string, NFA>& fa: fa_)
+            alternatives[fa.first].emplace_back(move(fa.second));
+
+        map<string, vector<pair<vector<Symbol>, Tag>>> literals;
+        map<string, set<vector<Symbol>>> literalsSeen;
+
+        for (const Rule& rule: rules)
         {
-            if (!klex::regular::containsBeginOfLine(*rule.regexpr))
+            const bool bol = klex::regular::containsBeginOfLine(*rule.regexpr);
+
+            if (optional<vector<Symbol>> literal = literalOf(*rule.regexpr); literal.has_value())
             {
-                NFA nfa = NFABuilder {}.construct(*rule.regexpr, rule.tag);
-                for (const string& condition: rule.conditions)
+                // duplicate literals (overshadowed rules) are left to the general path below
+                if (all_of(rule.conditions.begin(), rule.conditions.end(), [&](const string& condition) {
+                        return literalsSeen[condition].count(*literal) == 0;
+                    }))
                 {
-                    NFA& fa = fa_[condition];
-                    if (fa.empty())
-                        fa = nfa.clone();
-                    else
-                        fa.alternate(nfa.clone());
+                    for (const string& condition: rule.conditions)
+                    {
+                        literalsSeen[condition].insert(*literal);
+                        literals[condition].emplace_back(*literal, rule.tag);
+                    }
+                    continue;
                 }
-                declare(rule);
             }
-            declare(rule, "_0"); // BOL
+
+            if (rule.conditions.empty())
+                continue;
+
+            map<string, vector<NFA>>& targets = bol ? anchored : alternatives;
+            NFA nfa = NFABuilder {}.construct(*rule.regexpr, rule.tag);
+            for (size_t i = 0; i + 1 < rule.conditions.size(); ++i)
+                targets[rule.conditions[i]].emplace_back(nfa.clone());
+            targets[rule.conditions.back()].emplace_back(move(nfa));
+        }
+
+        for (const pair<const string, vector<pair<vector<Symbol>, Tag>>>& trie: literals)
+            alternatives[trie.first].emplace_back(NFA::trie(trie.second));
+
+        for (pair<const string, vector<NFA>>& condition: anchored)
+            alternatives[condition.first]; // conditions with BOL-rules only
+
+        for (pair<const string, vector<NFA>>& condition: alternatives)
+        {
+            if (containsBeginOfLine_)
+                fa_[condition.first] = NFA::unite(move(condition.second), move(anchored[condition.first]));
+            else
+                fa_[condition.first] = NFA::unite(move(condition.second));
         }
-    }
-    else
-    {
-        // No BOL-rules present, just declare them then.
-        for (Rule& rule: rules)
-            declare(rule);
     }
 
     for (Rule& rule: rules)
@@ -93,27 +136,33 @@ size_t Compiler::size() const
     return result;
 }
 
-void Compiler::declare(const Rule& rule, const string& conditionSuffix)
+// const map<string, NFA>& Compiler::automata() const {
+//   return fa_;
+// }
+
+map<string, DFA> Compiler::compilePositionAutomata(OvershadowMap* overshadows) const
 {
-    NFA nfa = NFABuilder {}.construct(*rule.regexpr, rule.tag);
+    // one DFA per condition, with a begin-of-line initial state if there is at least one BOL-rule
+    map<string, PositionDFABuilder> builders;
+    for (const Rule& rule: rules_)
+        for (const string& condition: rule.conditions)
+        {
+            PositionDFABuilder& builder = builders.try_emplace(condition, containsBeginOfLine_).first->second;
+            builder.declare(*rule.regexpr, rule.tag);
+        }
 
-    for (const string& condition: rule.conditions)
-    {
-        NFA& fa = fa_[condition + conditionSuffix];
+    map<string, DFA> dfaMap;
+    for (pair<const string, PositionDFABuilder>& builder: builders)
+        dfaMap[builder.first] = builder.second.construct(overshadows);
 
-        if (fa.empty())
-            fa = nfa.clone();
-        else
-            fa.alternate(nfa.clone());
-    }
+    return dfaMap;
 }
 
-// const map<string, NFA>& Compiler::automata() const {
-//   return fa_;
-// }
-
 MultiDFA Compiler::compileMultiDFA(OvershadowMap* overshadows)
 {
+    if (construction_ == DFAConstruction::PositionAutomaton)
+        return constructMultiDFA(compilePositionAutomata(overshadows));
+
     map<string, DFA> dfaMap;
     for (const auto& fa: fa_)
         dfaMap[fa.first] = DFABuilder { fa.second.clone() }.construct(overshadows);
@@ -123,7 +172,14 @@ MultiDFA Compiler::compileMultiDFA(OvershadowMap* overshadows)
 
 DFA Compiler::compileDFA(OvershadowMap* overshadows)
 {
-    assert((!containsBeginOfLine_ && fa_.size() == 1) || (containsBeginOfLine_ && fa_.size() == 2));
+    if (construction_ == DFAConstruction::PositionAutomaton)
+    {
+        map<string, DFA> dfaMap = compilePositionAutomata(overshadows);
+        assert(dfaMap.size() == 1);
+        return move(dfaMap.begin()->second);
+    }
+
+    assert(fa_.size() == 1);
     return DFABuilder { fa_.begin()->second.clone() }.construct(overshadows);
 }
 
@@ -144,48 +200,81 @@ LexerDef Compiler::compileMulti(OvershadowMap* overshadows)
     return generateTables(multiDFA, containsBeginOfLine_, names());
 }
 
-LexerDef Compiler::generateTables(const DFA& dfa, bool requiresBeginOfLine, const map<Tag, string>& names)
+LazyDFA Compiler::compileLazyDFA(size_t memoryBudget) const
+{
+    assert(construction_ == DFAConstruction::SubsetConstruction);
+
+    map<string, NFA> automata;
+    for (const pair<const string, NFA>& fa: fa_)
+        automata[fa.first] = fa.second.clone();
+
+    return LazyDFA { move(automata), memoryBudget };
+}
+
+BitParallelNFA Compiler::compileBitParallelNFA() const
+{
+    assert(construction_ == DFAConstruction::SubsetConstruction);
+
+    return BitParallelNFA { fa_ };
+}
+
+LexerDef Compiler::generateTables(const DFA& dfa,
+                                  bool requiresBeginOfLine,
+                                  const map<Tag, string>& names,
+                                  TableLayout layout)
 {
-    const Alphabet alphabet = dfa.alphabet();
     TransitionMap transitionMap;
 
     for (StateId state = 0, sE = dfa.lastState(); state <= sE; ++state)
-        for (Symbol c: alphabet)
-            if (optional<StateId> nextState = dfa.delta(state, c); nextState.has_value())
-                transitionMap.define(state, c, nextState.value());
+        for (const TransitionRanges::Range& r: dfa.stateTransitions(state))
+            transitionMap.define(state, r.first, r.last, r.target);
 
     map<StateId, Tag> acceptStates;
     for (StateId s: dfa.acceptStates())
         acceptStates.emplace(s, *dfa.acceptTag(s));
 
-    // TODO: many initial states !
-    return LexerDef { { { "INITIAL", dfa.initialState() } },
-                      requiresBeginOfLine,
-                      move(transitionMap),
-                      move(acceptStates),
-                      dfa.backtracking(),
-                      move(names) };
+    map<string, StateId> initialStates { { "INITIAL", dfa.initialState() } };
+    if (optional<StateId> bol = dfa.beginOfLineState(); bol.has_value())
+        initialStates["INITIAL_0"] = *bol;
+
+    LexerDef lexerDef { move(initialStates),
+                        requiresBeginOfLine,
+                        move(transitionMap),
+                        move(acceptStates),
+                        dfa.backtracking(),
+                        move(names) };
+
+    if (layout == TableLayout::Auto)
+        layout = planTableLayout(lexerDef).layout;
+    lexerDef.transitions.convert(layout);
+
+    return lexerDef;
 }
 
 LexerDef Compiler::generateTables(const MultiDFA& multiDFA,
                                   bool requiresBeginOfLine,
-                                  const map<Tag, string>& names)
+                                  const map<Tag, string>& names,
+                                  TableLayout layout)
 {
-    const Alphabet alphabet = multiDFA.dfa.alphabet();
     TransitionMap transitionMap;
 
     for (StateId state = 0, sE = multiDFA.dfa.lastState(); state <= sE; ++state)
-        for (const Symbol c: alphabet)
-            if (optional<StateId> nextState = multiDFA.dfa.delta(state, c); nextState.has_value())
-                transitionMap.define(state, c, nextState.value());
+        for (const TransitionRanges::Range& r: multiDFA.dfa.stateTransitions(state))
+            transitionMap.define(state, r.first, r.last, r.target);
 
     map<StateId, Tag> acceptStates;
     for (StateId s: multiDFA.dfa.acceptStates())
         acceptStates.emplace(s, *multiDFA.dfa.acceptTag(s));
 
     // TODO: many initial states !
-    return LexerDef { multiDFA.initialStates, requiresBeginOfLine,         move(transitionMap),
-                      move(acceptStates),     multiDFA.dfa.backtracking(), move(names) };
+    LexerDef lexerDef { multiDFA.initialStates, requiresBeginOfLine,         move(transitionMap),
+                        move(acceptStates),     multiDFA.dfa.backtracking(), move(names) };
+
+    if (layout == TableLayout::Auto)
+        layout = planTableLayout(lexerDef).layout;
+    lexerDef.transitions.convert(layout);
+
+    return lexerDef;
 }
 
 } // namespace klex::regular
@@ -6,7 +6,9 @@
 // the License at: http://opensource.org/licenses/MIT
 #pragma once
 
+#include <klex/regular/BitParallelNFA.h>
 #include <klex/regular/DFABuilder.h>
+#include <klex/regular/LazyDFA.h>
 #include <klex/regular/LexerDef.h>
 #include <klex/regular/NFA.h>
 #include <klex/regular/Rule.h>
@@ -33,7 +35,20 @@ class Compiler {
 	using OvershadowMap = DFABuilder::OvershadowMap;
 	using AutomataMap = std::map<std::string, NFA>;
 
-	Compiler() : rules_{}, containsBeginOfLine_{false}, fa_{}, names_{} {}
+	//! Algorithm used to turn the declared rules into a DFA.
+	enum class DFAConstruction {
+		//! RegExpr to Thompson NFA (NFABuilder), followed by subset construction (DFABuilder).
+		SubsetConstruction,
+		//! RegExpr directly to DFA via followpos (PositionDFABuilder), no NFA is built at all.
+		PositionAutomaton,
+	};
+
+	explicit Compiler(DFAConstruction construction = DFAConstruction::SubsetConstruction)
+		: construction_{construction}, rules_{}, containsBeginOfLine_{false}, fa_{}, names_{}
+	{
+	}
+
+	DFAConstruction construction() const noexcept { return construction_; }
 
 	/**
 	 * Parses a @p stream of textual rule definitions to construct their internal data structures.
@@ -74,13 +89,38 @@ class Compiler {
 	 */
 	LexerDef compileMulti(OvershadowMap* overshadows = nullptr);
 
+	/**
+	 * Creates a LazyDFA out of all previousely parsed rules, whose states are only constructed
+	 * on demand while scanning.
+	 *
+	 * Requires DFAConstruction::SubsetConstruction.
+	 *
+	 * @see LazyDFA
+	 */
+	LazyDFA compileLazyDFA(size_t memoryBudget = LazyDFA::DefaultMemoryBudget) const;
+
+	/**
+	 * Creates a BitParallelNFA out of all previousely parsed rules, simulating the NFAs directly
+	 * without building any DFA.
+	 *
+	 * Requires DFAConstruction::SubsetConstruction.
+	 *
+	 * @throws BitParallelNFA::TooManyPositions if the rule set is too big.
+	 * @see BitParallelNFA
+	 */
+	BitParallelNFA compileBitParallelNFA() const;
+
 	/**
 	 * Translates the given DFA @p dfa with a given TagNameMap @p names into trivial table mappings.
 	 *
+	 * The transitions are laid out as requested by @p layout.
+	 *
 	 * @see Lexer
 	 */
-	static LexerDef generateTables(const DFA& dfa, bool requiresBeginOfLine, const TagNameMap& names);
-	static LexerDef generateTables(const MultiDFA& dfa, bool requiresBeginOfLine, const TagNameMap& names);
+	static LexerDef generateTables(const DFA& dfa, bool requiresBeginOfLine, const TagNameMap& names,
+								   TableLayout layout = TableLayout::Ranges);
+	static LexerDef generateTables(const MultiDFA& dfa, bool requiresBeginOfLine, const TagNameMap& names,
+								   TableLayout layout = TableLayout::Ranges);
 
 	const std::map<std::string, NFA>& automata() const { return fa_; }
 
@@ -88,11 +128,12 @@ class Compiler {
 
   private:
 	/**
-	 * Parses a single @p rule to construct their internal data structures.
+	 * Constructs one DFA per condition directly from the declared rules' regular expressions.
 	 */
-	void declare(const Rule& rule, const std::string& conditionSuffix = "");
+	std::map<std::string, DFA> compilePositionAutomata(OvershadowMap* overshadows) const;
 
   private:
+	const DFAConstruction construction_;
 	RuleList rules_;
 	bool containsBeginOfLine_;
 	AutomataMap fa_;
@@ -0,0 +1,556 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/CorpusGenerator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <ostream>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+namespace
+{
+    constexpr Tag NoTag = numeric_limits<Tag>::min();
+    constexpr unsigned Unreachable = numeric_limits<unsigned>::max();
+
+    //! number of consecutive failures to chain a token after which its tag is no longer picked
+    constexpr unsigned MaxFailures = 256;
+
+    //! number of consecutive failures to chain any token after which the last token is dropped
+    constexpr unsigned MaxRetries = 64;
+
+    //! number of consecutive failures to chain any token after which generation is given up
+    constexpr unsigned MaxIdle = 4096;
+
+    //! tokens are emitted at the latest when the window of pending tokens exceeds this size
+    constexpr size_t MaxWindow = 65536;
+
+    bool isPrintable(Symbol c)
+    {
+        return (c >= 0x20 && c < 0x7F) || c == '\t' || c == '\n';
+    }
+} // namespace
+
+CorpusGenerator::CorpusGenerator(const LexerDef& lexerDef, uint64_t seed, Mode mode)
+    : def_ { lexerDef },
+      mode_ { mode },
+      rng_ { seed },
+      initialState_ { 0 },
+      transitions_ { lexerDef.transitions },
+      edges_ {},
+      predecessors_ {},
+      acceptTags_ {},
+      unstoppable_ {},
+      weights_ {},
+      cumulativeWeights_ {},
+      paths_ {},
+      failures_ {},
+      viable_ {},
+      extension_ {},
+      window_ {},
+      pending_ {},
+      settledScanEnd_ { 0 },
+      beginOfLine_ { true }
+{
+    // scanning is the generator's inner loop, so go for the fastest compact layout
+    if (transitions_.layout() == TableLayout::Ranges)
+        transitions_.convert(TableLayout::Classes);
+
+    auto q0 = def_.initialStates.find("INITIAL");
+    if (q0 == def_.initialStates.end())
+        q0 = def_.initialStates.begin();
+    assert(q0 != def_.initialStates.end());
+    initialState_ = q0->second;
+
+    auto startsToken = [&](Symbol c) {
+        return transitions_.apply(initialState_, c) != ErrorState
+               || (def_.containsBeginOfLineStates && transitions_.apply(initialState_ + 1, c) != ErrorState);
+    };
+
+    StateId stateCount = initialState_ + 2;
+    map<StateId, map<StateId, vector<char>>> transitions;
+    for (StateId s: def_.transitions.states())
+    {
+        stateCount = max(stateCount, s + 1);
+        for (const pair<const Symbol, StateId>& t: def_.transitions.map(s))
+        {
+            if (t.first < 0 || t.first > 0xFF)
+                continue; // not an input byte
+            stateCount = max(stateCount, t.second + 1);
+            transitions[s][t.second].push_back(static_cast<char>(t.first));
+        }
+    }
+    for (const pair<const StateId, Tag>& accept: def_.acceptStates)
+        stateCount = max(stateCount, accept.first + 1);
+
+    edges_.resize(stateCount);
+    predecessors_.resize(stateCount);
+    unstoppable_.resize(stateCount, false);
+    for (pair<const StateId, map<StateId, vector<char>>>& source: transitions)
+    {
+        // the symbols a scanner may stop at, as they start another token
+        size_t symbols = 0;
+        for (const pair<const StateId, vector<char>>& target: source.second)
+            symbols += target.second.size();
+        for (Symbol c = 0; c <= 0xFF; ++c)
+            if (transitions_.apply(source.first, c) == ErrorState && !startsToken(c))
+                ++symbols;
+        unstoppable_[source.first] = symbols == 0x100;
+
+        for (pair<const StateId, vector<char>>& target: source.second)
+        {
+            // prefer readable output, unless only non-printable symbols lead there
+            vector<char> printable;
+            copy_if(target.second.begin(),
+                    target.second.end(),
+                    back_inserter(printable),
+                    [](char ch) { return isPrintable(static_cast<unsigned char>(ch)); });
+
+            edges_[source.first].emplace_back(
+                Edge { target.first, printable.empty() ? move(target.second) : move(printable) });
+            predecessors_[target.first].push_back(source.first);
+        }
+    }
+
+    // states accepting any input byte (that could start another token) can only be left at the end
+    // of the input, such as the one of "//"[^$]*, and so can those only leading to such states
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (StateId s = 0; s < stateCount; ++s)
+        {
+            auto leaves = [&](const Edge& e) { return !unstoppable_[e.target]; };
+            if (unstoppable_[s] && any_of(edges_[s].begin(), edges_[s].end(), leaves))
+            {
+                unstoppable_[s] = false;
+                changed = true;
+            }
+        }
+    }
+
+    acceptTags_.resize(stateCount, NoTag);
+    for (const pair<const StateId, Tag>& accept: def_.acceptStates)
+    {
+        acceptTags_[accept.first] = accept.second;
+        weights_[accept.second] = 1.0;
+    }
+}
+
+void CorpusGenerator::setWeight(Tag t, double weight)
+{
+    weights_[t] = max(weight, 0.0);
+    cumulativeWeights_.clear();
+}
+
+void CorpusGenerator::setWeight(const string& tokenName, double weight)
+{
+    for (const pair<const Tag, string>& name: def_.tagNames)
+    {
+        if (name.second == tokenName)
+        {
+            setWeight(name.first, weight);
+            return;
+        }
+    }
+    throw invalid_argument { "Unknown token: " + tokenName };
+}
+
+Tag CorpusGenerator::pickTag()
+{
+    if (cumulativeWeights_.empty())
+    {
+        double sum = 0;
+        for (const pair<const Tag, double>& weight: weights_)
+            if (weight.second > 0)
+                cumulativeWeights_.emplace_back(sum += weight.second, weight.first);
+
+        if (cumulativeWeights_.empty())
+            throw Unproductive {};
+    }
+
+    const double r = real() * cumulativeWeights_.back().first;
+    auto i = upper_bound(cumulativeWeights_.begin(),
+                         cumulativeWeights_.end(),
+                         r,
+                         [](double value, const pair<double, Tag>& w) { return value < w.first; });
+    return i != cumulativeWeights_.end() ? i->second : cumulativeWeights_.back().second;
+}
+
+auto CorpusGenerator::paths(Tag t) -> const Paths&
+{
+    const size_t index = static_cast<size_t>(t - IgnoreTag);
+    if (index >= paths_.size())
+        paths_.resize(index + 1);
+    else if (!paths_[index].distance.empty())
+        return paths_[index];
+
+    // breadth-first search backwards from all states accepting t
+    vector<unsigned>& distance = paths_[index].distance;
+    distance.resize(edges_.size(), Unreachable);
+    deque<StateId> queue;
+    for (StateId s = 0; s < acceptTags_.size(); ++s)
+    {
+        if (acceptTags_[s] == t)
+        {
+            distance[s] = 0;
+            queue.push_back(s);
+        }
+    }
+
+    while (!queue.empty())
+    {
+        const StateId s = queue.front();
+        queue.pop_front();
+        for (StateId p: predecessors_[s])
+        {
+            if (distance[p] == Unreachable)
+            {
+                distance[p] = distance[s] + 1;
+                queue.push_back(p);
+            }
+        }
+    }
+
+    // every walk starts at an initial state, which usually has the most edges by far
+    for (StateId i = 0; i < 2; ++i)
+        for (const Edge& edge: edges_[initialState_ + i])
+            if (distance[edge.target] != Unreachable)
+                paths_[index].initialEdges[i].push_back(&edge);
+
+    return paths_[index];
+}
+
+StateId CorpusGenerator::initialState(bool beginOfLine) const noexcept
+{
+    return beginOfLine && def_.containsBeginOfLineStates ? initialState_ + 1 : initialState_;
+}
+
+string CorpusGenerator::lexeme(Tag t, bool beginOfLine)
+{
+    const size_t maxLength = mode_ == Mode::Adversarial ? 64 : 32;
+    const double stopChance = mode_ == Mode::Adversarial ? 0.1 : 0.3;
+    const Paths& paths = this->paths(t);
+    const vector<unsigned>& distance = paths.distance;
+
+    StateId s = initialState(beginOfLine);
+    if (distance[s] == Unreachable)
+        return {};
+
+    // the walk ends at the first accept state beyond a geometrically distributed length
+    const size_t minLength = min(maxLength, static_cast<size_t>(log1p(-real()) / log1p(-stopChance)));
+
+    string text;
+    while (acceptTags_[s] != t || text.size() < minLength)
+    {
+        if (!text.empty())
+        {
+            // beyond the maximum length, head straight for the nearest accept state
+            const bool overlong = text.size() >= maxLength;
+            viable_.clear();
+            for (const Edge& edge: edges_[s])
+            {
+                const unsigned d = distance[edge.target];
+                if (d != Unreachable && (!overlong || d < distance[s]))
+                    viable_.push_back(&edge);
+            }
+        }
+        const vector<const Edge*>& viable = text.empty() ? paths.initialEdges[s - initialState_] : viable_;
+
+        if (viable.empty())
+            break;
+
+        const uint64_t r = next();
+        const Edge& edge = *viable[(r >> 32) % viable.size()];
+        text.push_back(edge.symbols[(r & 0xFFFFFFFF) % edge.symbols.size()]);
+        s = edge.target;
+    }
+
+    return text;
+}
+
+bool CorpusGenerator::extend(const Token& token, string_view text, vector<StateId>& extension) const
+{
+    if (token.stopped)
+        return true;
+
+    StateId state = token.path.back();
+    for (char ch: text)
+    {
+        state = transitions_.apply(state, static_cast<Symbol>(static_cast<unsigned char>(ch)));
+        if (state == ErrorState)
+            return true;
+        extension.push_back(state);
+    }
+    return false;
+}
+
+pair<size_t, Tag> CorpusGenerator::longestMatch(const Token& token, const vector<StateId>& extension) const
+{
+    // mirrors Lexer::recognizeOne() on the path continued by the extension
+    auto state = [&](size_t i) {
+        return i < token.path.size() ? token.path[i] : extension[i - token.path.size()];
+    };
+
+    size_t length = token.lastAccept;
+    for (size_t i = token.path.size() + extension.size(); i > token.path.size(); --i)
+    {
+        if (acceptTags_[state(i - 1)] != NoTag)
+        {
+            length = i - 1;
+            break;
+        }
+    }
+
+    if (length == 0)
+        return { 0, NoTag };
+
+    const Tag tag = acceptTags_[state(length)];
+    if (auto bt = def_.backtrackingStates.find(state(length)); bt != def_.backtrackingStates.end())
+    {
+        size_t k = length;
+        while (k > 0 && state(k) != bt->second)
+            --k;
+        if (k > 0)
+            length = k;
+    }
+
+    return { length, tag };
+}
+
+void CorpusGenerator::advance(Token& token, string_view text) const
+{
+    for (size_t i = 0; i < text.size() && !token.stopped; ++i)
+    {
+        const StateId s =
+            transitions_.apply(token.path.back(), static_cast<Symbol>(static_cast<unsigned char>(text[i])));
+        if (s == ErrorState)
+            token.stopped = true;
+        else
+        {
+            token.path.push_back(s);
+            if (acceptTags_[s] != NoTag)
+                token.lastAccept = token.path.size() - 1;
+        }
+    }
+}
+
+bool CorpusGenerator::check(Candidate& c)
+{
+    auto recognized = [&](const Token& token, bool stopped) {
+        const pair<size_t, Tag> match = longestMatch(token, extension_);
+        if (match.first != token.length || match.second != token.tag)
+            return false;
+
+        // nothing could follow a scanner that does not stop before the end of the input
+        const StateId state = extension_.empty() ? token.path.back() : extension_.back();
+        if (!stopped && unstoppable_[state])
+            return false;
+
+        // the symbol the scanner stopped at is the regular lookahead of a longest match
+        c.lookahead = max(c.lookahead, token.path.size() - 1 + extension_.size() - token.length);
+        return true;
+    };
+
+    for (const Token& token: pending_)
+    {
+        if (token.stopped)
+            continue;
+
+        extension_.clear();
+        if (!recognized(token, extend(token, c.text, extension_)))
+            return false;
+    }
+
+    extension_.clear();
+    for (Token& token: c.tokens)
+    {
+        advance(token, string_view { c.text }.substr(token.offset - window_.size()));
+        if (!recognized(token, token.stopped))
+            return false;
+    }
+
+    return true;
+}
+
+auto CorpusGenerator::candidate(Tag t) -> optional<Candidate>
+{
+    const bool beginOfLine = window_.empty() ? beginOfLine_ : window_.back() == '\n';
+    auto token = [this](size_t offset, const string& text, Tag t, bool beginOfLine) {
+        return Token { offset, text.size(), t, { initialState(beginOfLine) }, 0, false };
+    };
+
+    if (string text = lexeme(t, beginOfLine); !text.empty())
+    {
+        Candidate c { text, { token(window_.size(), text, t, beginOfLine) }, 0 };
+        if (check(c))
+            return c;
+    }
+
+    if (t == IgnoreTag)
+        return nullopt;
+
+    // separate the token from its predecessor by an ignored one
+    const string separator = lexeme(IgnoreTag, beginOfLine);
+    if (separator.empty())
+        return nullopt;
+
+    const bool separatedBeginOfLine = separator.back() == '\n';
+    const string text = lexeme(t, separatedBeginOfLine);
+    if (text.empty())
+        return nullopt;
+
+    Candidate c { separator + text,
+                  { token(window_.size(), separator, IgnoreTag, beginOfLine),
+                    token(window_.size() + separator.size(), text, t, separatedBeginOfLine) },
+                  0 };
+    if (check(c))
+        return c;
+
+    return nullopt;
+}
+
+bool CorpusGenerator::appendToken(const TokenSink& sink)
+{
+    const unsigned attempts = mode_ == Mode::Adversarial ? 16 : 1;
+
+    optional<Candidate> best;
+    for (unsigned i = 0; i < attempts; ++i)
+    {
+        const Tag t = pickTag();
+        optional<Candidate> c = candidate(t);
+        if (!c)
+        {
+            if (++failures_[t] == MaxFailures && weights_[t] > 0)
+                setWeight(t, 0); // never chains, so stop wasting time on it
+            continue;
+        }
+
+        failures_[t] = 0;
+        if (!best || c->lookahead > best->lookahead)
+            best = move(c);
+    }
+
+    if (!best)
+        return false;
+
+    for (Token& token: pending_)
+        advance(token, best->text);
+
+    window_ += best->text;
+    move(best->tokens.begin(), best->tokens.end(), back_inserter(pending_));
+    commit(false, sink);
+    return true;
+}
+
+bool CorpusGenerator::retract()
+{
+    // drops the most recent token, which no other token seems to be able to follow, unless
+    // an already emitted token has been recognized in view of it
+    if (pending_.empty() || pending_.back().offset < settledScanEnd_)
+        return false;
+
+    const Token& last = pending_.back();
+    if (++failures_[last.tag] == MaxFailures && weights_[last.tag] > 0)
+        setWeight(last.tag, 0);
+
+    window_.resize(last.offset);
+    pending_.pop_back();
+
+    for (Token& token: pending_)
+    {
+        const size_t available = window_.size() - token.offset;
+        if (token.path.size() - 1 + (token.stopped ? 1 : 0) <= available)
+            continue;
+
+        token.path.resize(available + 1);
+        token.stopped = false;
+        while (token.lastAccept >= token.path.size()
+               || (token.lastAccept > 0 && acceptTags_[token.path[token.lastAccept]] == NoTag))
+            --token.lastAccept;
+    }
+
+    return true;
+}
+
+void CorpusGenerator::commit(bool all, const TokenSink& sink)
+{
+    // a token is settled once the scanner stopped, as no token to come can change its recognition
+    // anymore (or once the window grew too large to keep track of it)
+    const bool overflow = window_.size() > MaxWindow;
+    size_t settled = 0;
+    while (settled < pending_.size())
+    {
+        const Token& token = pending_[settled];
+        if (!all && !token.stopped && !(overflow && window_.size() - token.offset > MaxWindow / 2))
+            break;
+
+        sink(string_view { window_ }.substr(token.offset, token.length), token.tag);
+        settledScanEnd_ = max(settledScanEnd_, token.offset + token.path.size());
+        ++settled;
+    }
+
+    if (settled == 0)
+        return;
+
+    const size_t offset = settled < pending_.size() ? pending_[settled].offset : window_.size();
+    beginOfLine_ = window_[offset - 1] == '\n';
+    window_.erase(0, offset);
+    settledScanEnd_ -= min(settledScanEnd_, offset);
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(settled));
+    for (Token& token: pending_)
+        token.offset -= offset;
+}
+
+void CorpusGenerator::generate(size_t size, const TokenSink& sink)
+{
+    size_t emitted = 0;
+    const TokenSink counting = [&](string_view lexeme, Tag tag) {
+        emitted += lexeme.size();
+        sink(lexeme, tag);
+    };
+
+    // every corpus is a separate input, starting at the beginning of a line
+    beginOfLine_ = true;
+    settledScanEnd_ = 0;
+
+    unsigned idle = 0;
+    while (emitted + window_.size() < size)
+    {
+        if (appendToken(counting))
+            idle = 0;
+        else if (++idle >= MaxIdle)
+            throw Unproductive {};
+        else if (idle % MaxRetries == 0)
+            retract();
+    }
+
+    commit(true, counting);
+}
+
+void CorpusGenerator::generate(size_t size, ostream& os)
+{
+    generate(size, [&](string_view lexeme, Tag) {
+        os.write(lexeme.data(), static_cast<streamsize>(lexeme.size()));
+    });
+}
+
+string CorpusGenerator::generate(size_t size)
+{
+    string corpus;
+    corpus.reserve(size + MaxWindow);
+    generate(size, [&](string_view lexeme, Tag) { corpus += lexeme; });
+    return corpus;
+}
+
+} // namespace klex::regular
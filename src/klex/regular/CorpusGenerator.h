@@ -0,0 +1,154 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/LexerDef.h>
+#include <klex/regular/State.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Generates random input that a lexer of the given LexerDef splits into a known sequence of tokens.
+ *
+ * Each token's lexeme is a random walk through the transition table from the initial state
+ * (of the initial condition) to an accept state of the token's tag. Tokens are chained such that
+ * the lexer recognizes exactly the lexemes generated, inserting ignored tokens (such as spacing)
+ * between tokens that would otherwise merge.
+ *
+ * The output solely depends on the LexerDef, the seed and the weights, on any platform.
+ */
+class CorpusGenerator {
+  public:
+	class Unproductive;
+
+	enum class Mode {
+		//! tokens of moderate length, picked by their weights only
+		Regular,
+
+		//! longer tokens, each chosen (out of a few candidates) to maximize the lookahead the lexer
+		//! scans beyond the previous tokens, and thus the distance it has to roll back
+		Adversarial,
+	};
+
+	//! Receives each generated lexeme along with its tag (IgnoreTag for ignored tokens).
+	using TokenSink = std::function<void(std::string_view lexeme, Tag tag)>;
+
+	CorpusGenerator(const LexerDef& lexerDef, uint64_t seed, Mode mode = Mode::Regular);
+
+	/**
+	 * Sets the relative frequency of tokens with the given tag @p t (1 by default).
+	 *
+	 * A weight of 0 disables the token, unless it is needed as a separator (IgnoreTag).
+	 */
+	void setWeight(Tag t, double weight);
+
+	/**
+	 * Sets the relative frequency of tokens of the given name.
+	 *
+	 * @throws std::invalid_argument if there is no such token.
+	 */
+	void setWeight(const std::string& tokenName, double weight);
+
+	//! Generates tokens until at least @p size bytes have been passed to @p sink.
+	void generate(size_t size, const TokenSink& sink);
+
+	//! Generates tokens until at least @p size bytes have been written to @p os.
+	void generate(size_t size, std::ostream& os);
+
+	//! Generates a corpus of at least @p size bytes.
+	std::string generate(size_t size);
+
+  private:
+	struct Edge {
+		StateId target;
+		std::vector<char> symbols;
+	};
+
+	struct Paths {
+		//! per state, the length of the shortest path to an accept state of the tag
+		std::vector<unsigned> distance;
+
+		//! edges out of the initial state (and its begin-of-line counterpart) leading to the tag
+		std::array<std::vector<const Edge*>, 2> initialEdges;
+	};
+
+	struct Token {
+		size_t offset;  //!< offset into window_
+		size_t length;
+		Tag tag;
+		std::vector<StateId> path;  //!< path[i] is the scanner's state after reading i symbols of the token
+		size_t lastAccept;          //!< the highest i of an accepting path[i] (0 if none)
+		bool stopped;               //!< whether the scanner stopped (at symbol path.size() - 1)
+	};
+
+	struct Candidate {
+		std::string text;
+		std::vector<Token> tokens;
+		size_t lookahead;  //!< the longest distance the lexer scans beyond the end of a token
+	};
+
+	uint64_t next() { return rng_(); }
+	double real() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+	Tag pickTag();
+	const Paths& paths(Tag t);
+	StateId initialState(bool beginOfLine) const noexcept;
+	std::string lexeme(Tag t, bool beginOfLine);
+	bool extend(const Token& token, std::string_view text, std::vector<StateId>& extension) const;
+	std::pair<size_t, Tag> longestMatch(const Token& token, const std::vector<StateId>& extension) const;
+	void advance(Token& token, std::string_view text) const;
+	std::optional<Candidate> candidate(Tag t);
+	bool check(Candidate& c);
+	bool appendToken(const TokenSink& sink);
+	bool retract();
+	void commit(bool all, const TokenSink& sink);
+
+  private:
+	const LexerDef& def_;
+	Mode mode_;
+	std::mt19937_64 rng_;
+	StateId initialState_;
+	TransitionMap transitions_;
+	std::vector<std::vector<Edge>> edges_;
+	std::vector<std::vector<StateId>> predecessors_;
+	std::vector<Tag> acceptTags_;
+	std::vector<bool> unstoppable_;
+	std::map<Tag, double> weights_;
+	std::vector<std::pair<double, Tag>> cumulativeWeights_;
+	std::vector<Paths> paths_;  //!< indexed by tag - IgnoreTag, computed on demand
+	std::map<Tag, unsigned> failures_;
+
+	// scratch space
+	std::vector<const Edge*> viable_;
+	std::vector<StateId> extension_;
+
+	//! text of the tokens whose recognition may still depend on the tokens yet to come
+	std::string window_;
+	std::vector<Token> pending_;
+	size_t settledScanEnd_;  //!< window offset up to which the scans of emitted tokens depend on
+	bool beginOfLine_;
+};
+
+class CorpusGenerator::Unproductive : public std::runtime_error {
+  public:
+	Unproductive() : std::runtime_error{"The lexer definition does not produce any chainable tokens."} {}
+};
+
+}  // namespace klex::regular
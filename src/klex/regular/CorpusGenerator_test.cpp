@@ -0,0 +1,113 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/CorpusGenerator.h>
+#include <klex/regular/Lexer.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+namespace
+{
+    const string rules = R"(|Spacing(ignore)  ::= [\s\t\n]+
+                            |Comment(ignore)  ::= "//"[^$]*
+                            |Eof              ::= <<EOF>>
+                            |Pragma           ::= ^pragma
+                            |If               ::= if
+                            |Else             ::= else
+                            |Float            ::= [0-9]+\.[0-9]+e[0-9]+
+                            |Number           ::= [0-9]+
+                            |Dot              ::= \.
+                            |Ident            ::= [a-z][a-z0-9]*
+                            |)"_multiline;
+
+    LexerDef compile()
+    {
+        Compiler cc;
+        cc.parse(rules);
+        return cc.compileMulti();
+    }
+
+    LexerStats lex(const LexerDef& ld, const string& corpus, vector<pair<Tag, string>>* tokens = nullptr)
+    {
+        Lexer<Tag, StateId, true, false, true> lexer { ld, corpus };
+        for (Tag t = lexer.recognize(); t != 1; t = lexer.recognize()) // until Eof
+            if (tokens)
+                tokens->emplace_back(t, lexer.word());
+        return lexer.stats();
+    }
+} // namespace
+
+TEST(regular_CorpusGenerator, deterministic)
+{
+    const LexerDef ld = compile();
+    const string corpus = CorpusGenerator(ld, 42).generate(4096);
+    EXPECT_TRUE(corpus.size() >= 4096);
+    EXPECT_EQ(corpus, CorpusGenerator(ld, 42).generate(4096));
+    EXPECT_TRUE(corpus != CorpusGenerator(ld, 43).generate(4096));
+}
+
+TEST(regular_CorpusGenerator, tokens)
+{
+    const LexerDef ld = compile();
+    for (CorpusGenerator::Mode mode: { CorpusGenerator::Mode::Regular, CorpusGenerator::Mode::Adversarial })
+    {
+        string corpus;
+        vector<pair<Tag, string>> generated;
+        CorpusGenerator { ld, 1, mode }.generate(8192, [&](string_view lexeme, Tag t) {
+            corpus += lexeme;
+            if (t != IgnoreTag)
+                generated.emplace_back(t, string(lexeme));
+        });
+
+        // the lexer splits the corpus exactly into the generated tokens
+        vector<pair<Tag, string>> lexed;
+        lex(ld, corpus, &lexed);
+        ASSERT_EQ(generated.size(), lexed.size());
+        for (size_t i = 0; i < generated.size(); ++i)
+        {
+            EXPECT_EQ(generated[i].first, lexed[i].first);
+            EXPECT_EQ(generated[i].second, lexed[i].second);
+        }
+    }
+}
+
+TEST(regular_CorpusGenerator, weights)
+{
+    const LexerDef ld = compile();
+    CorpusGenerator generator { ld, 1 };
+    generator.setWeight("Ident", 0);
+    generator.setWeight("Number", 10);
+    const LexerStats stats = lex(ld, generator.generate(8192));
+
+    const Tag number = 6;
+    const Tag ident = 8;
+    EXPECT_EQ(0, stats.tokenCount(ident));
+    EXPECT_TRUE(stats.tokenCount(number) > stats.tokenCount() / 2);
+
+    EXPECT_THROW(generator.setWeight("NoSuchToken", 1), invalid_argument);
+}
+
+TEST(regular_CorpusGenerator, adversarial)
+{
+    const LexerDef ld = compile();
+    const LexerStats regular = lex(ld, CorpusGenerator { ld, 1 }.generate(16384));
+    const LexerStats adversarial =
+        lex(ld, CorpusGenerator { ld, 1, CorpusGenerator::Mode::Adversarial }.generate(16384));
+
+    // e.g. "12.5e" followed by an identifier makes the lexer roll back to "12"
+    EXPECT_TRUE(adversarial.rollbacks > regular.rollbacks);
+    EXPECT_TRUE(adversarial.longestLookahead > regular.longestLookahead);
+}
@@ -0,0 +1,179 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/CombTable.h>
+#include <klex/regular/CxxGenerator.h>
+#include <klex/regular/DenseTable.h>
+#include <klex/regular/Symbols.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <ostream>
+#include <set>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+namespace
+{
+    string charLiteral(Symbol ch)
+    {
+        switch (ch)
+        {
+            case Symbols::EndOfFile:
+            case Symbols::Error: return fmt::format("{}", (int) ch);
+            case ' ': return string { "' '" };
+            case '\t': return string { "'\\t'" };
+            case '\n': return string { "'\\n'" };
+            case '\'': return string { "'\\''" };
+            case '\\': return string { "'\\\\'" };
+            default:
+                if (ch >= 0 && ch <= 255 && isprint(ch))
+                    return fmt::format("'{}'", (char) ch);
+                else
+                    return fmt::format("{}", (int) ch);
+        }
+    }
+
+    void generateTransitionRangesCxx(ostream& os, const TransitionMap::Container& transitions)
+    {
+        os << "  klex::regular::TransitionMap::Container {\n";
+        for (const pair<const StateId, TransitionRanges>& T: transitions)
+        {
+            os << "    { " << fmt::format("{:>3}", T.first) << ", {";
+            int c = 0;
+            for (const TransitionRanges::Range& r: T.second)
+            {
+                if (c)
+                    os << ", ";
+                os << "{" << charLiteral(r.first) << ", " << charLiteral(r.last) << ", " << r.target << "}";
+                c++;
+            }
+            os << "}},\n";
+        }
+        os << "  },\n";
+    }
+
+    void generateIndexArrayCxx(ostream& os, string_view name, const vector<uint32_t>& values)
+    {
+        os << "    // " << name << "\n";
+        os << "    {";
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (i % 16 == 0)
+                os << "\n     ";
+            os << " " << values[i] << ",";
+        }
+        os << "\n    },\n";
+    }
+
+    void generateTransitionsCxx(ostream& os, const TransitionMap& transitions)
+    {
+        const bool split = transitions.hotStates() != TransitionMap::AllStates;
+        if (split)
+            os << "  klex::regular::TransitionMap {\n";
+
+        if (const CombTable* comb = transitions.comb(); comb != nullptr)
+        {
+            os << "  // state transition table (comb-vector compressed)\n";
+            os << "  klex::regular::CombTable {\n";
+            os << "    " << comb->firstSymbol() << ", // first symbol\n";
+            os << "    " << comb->symbolCount() << ", // symbol count\n";
+            generateIndexArrayCxx(os, "base", comb->base());
+            generateIndexArrayCxx(os, "next", comb->next());
+            generateIndexArrayCxx(os, "check", comb->check());
+            generateIndexArrayCxx(os, "default", comb->defaults());
+            os << "  },\n";
+        }
+        else if (const DenseTable* dense = transitions.dense(); dense != nullptr)
+        {
+            os << "  // state transition table (" << (dense->hasClasses() ? "symbol classes" : "dense")
+               << ")\n";
+            os << "  klex::regular::DenseTable {\n";
+            os << "    " << dense->firstSymbol() << ", // first symbol\n";
+            os << "    " << dense->symbolCount() << ", // symbol count\n";
+            generateIndexArrayCxx(os, "classes", dense->classes());
+            os << "    " << dense->classCount() << ", // class count\n";
+            generateIndexArrayCxx(os, "next", dense->next());
+            os << "  },\n";
+        }
+        else
+        {
+            os << "  // state transition table \n";
+            generateTransitionRangesCxx(os, transitions.ranges());
+        }
+
+        if (split)
+        {
+            os << "  // number of hot states\n";
+            os << "  " << transitions.hotStates() << ",\n";
+            os << "  // state transition table of cold states\n";
+            generateTransitionRangesCxx(os, transitions.ranges());
+            os << "  },\n";
+        }
+    }
+} // namespace
+
+void generateLexerDefCxx(ostream& os, const LexerDef& lexerDef, const RuleList& rules)
+{
+    os << "{\n";
+    os << "  // initial states\n";
+    os << "  std::map<std::string, klex::regular::StateId> {\n";
+    for (const pair<const string, StateId>& s0: lexerDef.initialStates)
+        os << fmt::format("    {{ \"{}\", {} }},\n", s0.first, s0.second);
+    os << "  },\n";
+    os << "  // containsBeginOfLineStates\n";
+    os << "  " << (lexerDef.containsBeginOfLineStates ? "true" : "false") << ",\n";
+    generateTransitionsCxx(os, lexerDef.transitions);
+    os << "  // accept state to action label mappings\n";
+    os << "  klex::regular::AcceptStateMap {\n";
+    for (const pair<StateId, Tag>& accept: lexerDef.acceptStates)
+    {
+        os << fmt::format("    {{ {:>3}, {:>3} }}, //", accept.first, accept.second);
+        set<string> names;
+        for_each(rules.begin(), rules.end(), [&](const auto& rule) {
+            if (accept.second == rule.tag)
+                names.emplace(rule.name);
+        });
+        if (rules.empty() && lexerDef.isValidTag(accept.second))
+            names.emplace(lexerDef.tagName(accept.second));
+        for_each(names.begin(), names.end(), [&](const auto& name) { os << " " << name; });
+        os << "\n";
+    }
+    os << "  },\n";
+    os << "  // backtracking map\n";
+    os << "  klex::regular::BacktrackingMap {\n";
+    for (const pair<StateId, StateId>& backtrack: lexerDef.backtrackingStates)
+    {
+        os << fmt::format("    {{ {:>3}, {:>3} }},\n", backtrack.first, backtrack.second);
+    }
+    os << "  },\n";
+    os << "  // tag-to-name mappings\n";
+    os << "  std::map<klex::regular::Tag, std::string> {\n";
+    for (const pair<Tag, string>& tagName: lexerDef.tagNames)
+    {
+        if (tagName.first != IgnoreTag)
+            os << fmt::format("    {{ {}, \"{}\" }},\n", tagName.first, tagName.second);
+    }
+    os << "  }\n";
+    os << "}";
+}
+
+pair<string, string> splitNamespace(const string& fullyQualifiedName)
+{
+    size_t n = fullyQualifiedName.rfind("::");
+    if (n != string::npos)
+        return make_pair(fullyQualifiedName.substr(0, n), fullyQualifiedName.substr(n + 2));
+    else
+        return make_pair(string(), fullyQualifiedName);
+}
+
+} // namespace klex::regular
@@ -0,0 +1,30 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/LexerDef.h>
+#include <klex/regular/Rule.h>
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+namespace klex::regular {
+
+/**
+ * Writes the braced initializer of a klex::regular::LexerDef equal to @p lexerDef as C++ code,
+ * such as generated by mklex and mklax.
+ *
+ * Accept states are commented with the names of the @p rules of their tag, or with the tag's name
+ * from the LexerDef if no rules are given.
+ */
+void generateLexerDefCxx(std::ostream& os, const LexerDef& lexerDef, const RuleList& rules = {});
+
+//! Splits a C++ symbol name such as "a::b::c" into its namespace ("a::b") and name ("c").
+std::pair<std::string, std::string> splitNamespace(const std::string& fullyQualifiedName);
+
+}  // namespace klex::regular
@@ -37,8 +37,9 @@ Alphabet DFA::alphabet() const
 {
     Alphabet alphabet;
     for (const State& state: states_)
-        for (const pair<Symbol, StateId>& t: state.transitions)
-            alphabet.insert(t.first);
+        for (const TransitionRanges::Range& r: state.transitions)
+            for (Symbol c = r.first; c <= r.last; ++c)
+                alphabet.insert(c);
 
     return alphabet;
 }
@@ -73,25 +74,31 @@ void DFA::setTransition(StateId from, Symbol symbol, StateId to)
     // 		   i->second, to);
 
     // XXX assert(s.transitions.find(symbol) == s.transitions.end());
-    states_[from].transitions[symbol] = to;
+    states_[from].transitions.define(symbol, to);
+}
+
+void DFA::setTransition(StateId from, Symbol first, Symbol last, StateId to)
+{
+    states_[from].transitions.define(first, last, to);
 }
 
 void DFA::removeTransition(StateId from, Symbol symbol)
 {
-    State& s = states_[from];
-    if (auto i = s.transitions.find(symbol); i != s.transitions.end())
-        s.transitions.erase(i);
+    states_[from].transitions.remove(symbol);
 }
 
 StateId DFA::append(DFA&& other, StateId q0)
 {
     assert(other.initialState() == 0);
+    assert(!other.beginOfLineState_.has_value() || *other.beginOfLineState_ == 1);
 
+    const size_t entries = other.beginOfLineState_.has_value() ? 2 : 1;
     other.prepareStateIds(states_.size(), q0);
 
-    states_.reserve(size() + other.size() - 1);
-    states_[q0] = other.states_[0];
-    states_.insert(states_.end(), next(other.states_.begin()), other.states_.end());
+    states_.reserve(size() + other.size() - entries);
+    for (size_t i = 0; i < entries; ++i)
+        states_[q0 + i] = other.states_[i];
+    states_.insert(states_.end(), next(other.states_.begin(), entries), other.states_.end());
     backtrackStates_.insert(other.backtrackStates_.begin(), other.backtrackStates_.end());
     acceptTags_.insert(other.acceptTags_.begin(), other.acceptTags_.end());
 
@@ -105,15 +112,17 @@ void DFA::prepareStateIds(StateId baseId, StateId q0)
     //    traverse through each transition in the transition set
     //        traverse through each element and add BASE_ID
 
-    auto transformId = [baseId, q0, this](StateId s) -> StateId {
-        // we subtract 1, because we already have a slot for q0 elsewhere (pre-allocated)
-        return s != initialState_ ? baseId + s - 1 : q0;
+    // the initial state (and the begin-of-line initial state following it) have their slots
+    // pre-allocated elsewhere already
+    const StateId entries = beginOfLineState_.has_value() ? 2 : 1;
+    auto transformId = [baseId, q0, entries](StateId s) -> StateId {
+        return s >= entries ? baseId + s - entries : q0 + s;
     };
 
     // for each state's transitions
     for (State& state: states_)
-        for (pair<const Symbol, StateId>& t: state.transitions)
-            t.second = transformId(t.second);
+        for (TransitionRanges::Range& r: state.transitions)
+            r.target = transformId(r.target);
 
     AcceptMap remapped;
     for (auto& a: acceptTags_)
@@ -126,6 +135,8 @@ void DFA::prepareStateIds(StateId baseId, StateId q0)
     backtrackStates_ = move(backtracking);
 
     initialState_ = q0;
+    if (beginOfLineState_.has_value())
+        beginOfLineState_ = q0 + 1;
 }
 
 void DFA::visit(DotVisitor& v) const
@@ -149,8 +160,12 @@ void DFA::visit(DotVisitor& v) const
     for (StateId s = 0, sE = size(); s != sE; ++s)
     {
         const TransitionMap& T = states_[s].transitions;
-        for_each(T.begin(), T.end(), [&](const auto& t) { v.visitEdge(s, t.second, t.first); });
-        for_each(T.begin(), T.end(), [&](const auto& t) { v.endVisitEdge(s, t.second); });
+        for (const TransitionRanges::Range& r: T)
+            for (Symbol c = r.first; c <= r.last; ++c)
+                v.visitEdge(s, r.target, c);
+        for (const TransitionRanges::Range& r: T)
+            for (Symbol c = r.first; c <= r.last; ++c)
+                v.endVisitEdge(s, r.target);
     }
     v.end();
 }
@@ -8,6 +8,7 @@
 
 #include <klex/regular/Alphabet.h>
 #include <klex/regular/State.h>
+#include <klex/regular/TransitionRanges.h>
 #include <algorithm>
 #include <cmath>
 #include <map>
@@ -24,7 +25,7 @@ class DotVisitor;
  */
 class DFA {
   public:
-	using TransitionMap = std::map<Symbol, StateId>;
+	using TransitionMap = TransitionRanges;
 	struct State {
 		// std::vector<StateId> states;
 		TransitionMap transitions;
@@ -41,7 +42,7 @@ class DFA {
 	DFA& operator=(DFA&&) = default;
 	~DFA() = default;
 
-	DFA() : states_{}, initialState_{0}, backtrackStates_{}, acceptTags_{} {}
+	DFA() : states_{}, initialState_{0}, beginOfLineState_{}, backtrackStates_{}, acceptTags_{} {}
 
 	[[nodiscard]] bool empty() const noexcept { return states_.empty(); }
 	[[nodiscard]] size_t size() const noexcept { return states_.size(); }
@@ -58,6 +59,9 @@ class DFA {
 	//! Retrieves the initial state.
 	StateId initialState() const { return initialState_; }
 
+	//! Retrieves the initial state to start from at the beginning of a line, if any.
+	std::optional<StateId> beginOfLineState() const { return beginOfLineState_; }
+
 	//! Retrieves the list of available states.
 	const StateVec& states() const { return states_; }
 	StateVec& states() { return states_; }
@@ -84,6 +88,7 @@ class DFA {
 	void createStates(size_t count);
 
 	void setInitialState(StateId state);
+	void setBeginOfLineState(StateId state) { beginOfLineState_ = state; }
 
 	const TransitionMap& stateTransitions(StateId id) const
 	{
@@ -119,14 +124,14 @@ class DFA {
 
 	std::optional<StateId> delta(StateId state, Symbol symbol) const
 	{
-		const auto& T = states_[state].transitions;
-		if (auto i = T.find(symbol); i != T.end())
-			return i->second;
-
-		return std::nullopt;
+		return states_[state].transitions.find(symbol);
 	}
 
 	void setTransition(StateId from, Symbol symbol, StateId to);
+
+	//! Defines the transition from @p from to @p to on all symbols in [@p first, @p last].
+	void setTransition(StateId from, Symbol first, Symbol last, StateId to);
+
 	void removeTransition(StateId from, Symbol symbol);
 
 	StateIdVec nonAcceptStates() const
@@ -151,6 +156,12 @@ class DFA {
 		return false;
 	}
 
+	/**
+	 * Appends all states of @p other to this DFA, with @p other's initial state mapped to @p q0.
+	 *
+	 * If @p other has a begin-of-line initial state, it is mapped to @p q0 + 1,
+	 * which must be allocated by the caller as well.
+	 */
 	StateId append(DFA&& other, StateId q0);
 
   private:
@@ -159,6 +170,7 @@ class DFA {
   private:
 	StateVec states_;
 	StateId initialState_;
+	std::optional<StateId> beginOfLineState_;
 	BacktrackingMap backtrackStates_;
 	AcceptMap acceptTags_;
 };
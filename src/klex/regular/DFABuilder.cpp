@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <deque>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stack>
 #include <vector>
@@ -37,14 +38,9 @@ namespace klex::regular
 
 struct DFABuilder::TransitionTable
 { // {{{
-    void insert(StateId q, Symbol c, StateId t);
-    unordered_map<StateId, unordered_map<Symbol, StateId>> transitions;
+    //! outgoing transitions of each configuration q_i, in symbol ranges
+    vector<TransitionRanges> transitions;
 };
-
-inline void DFABuilder::TransitionTable::insert(StateId q, Symbol c, StateId t)
-{
-    transitions[q][c] = t;
-}
 // }}}
 
 /* DFA construction visualization
@@ -83,39 +79,72 @@ DFA DFABuilder::construct(OvershadowMap* overshadows)
 {
     const StateIdVec q_0 = nfa_.epsilonClosure({ nfa_.initialStateId() });
     vector<StateIdVec> Q = { q_0 }; // resulting states
+    map<StateIdVec, StateId> configurations = { { q_0, 0 } };
     deque<StateIdVec> workList = { q_0 };
     TransitionTable T;
 
-    const Alphabet alphabet = nfa_.alphabet();
+    // The begin-of-line initial configuration (if any) becomes d_1. Any configuration reachable from
+    // both initial configurations is constructed only once.
+    if (optional<StateId> bol = nfa_.beginOfLineStateId(); bol.has_value())
+    {
+        Q.emplace_back(nfa_.epsilonClosure({ *bol }));
+        configurations.emplace(Q.back(), 1);
+        workList.emplace_back(Q.back());
+    }
 
+    vector<pair<Symbol, StateId>> moves;
     StateIdVec eclosure;
     StateIdVec delta;
+    StateIdVec lastDelta;
     while (!workList.empty())
     {
         const StateIdVec q =
             move(workList.front()); // each set q represents a valid configuration from the NFA
         workList.pop_front();
-        const StateId q_i = *configurationNumber(Q, q);
-
-        for (Symbol c: alphabet)
+        const StateId q_i = configurations.at(q);
+        T.transitions.resize(Q.size());
+
+        // all non-epsilon moves out of q, by symbol, each symbol's targets in the order of q
+        moves.clear();
+        for (StateId s: q)
+            for (const pair<const Symbol, StateIdVec>& transition: nfa_.stateTransitions(s))
+                if (transition.first != Symbols::Epsilon)
+                    for (StateId t: transition.second)
+                        moves.emplace_back(transition.first, t);
+        stable_sort(moves.begin(),
+                    moves.end(),
+                    [](const pair<Symbol, StateId>& a, const pair<Symbol, StateId>& b) {
+                        return a.first < b.first;
+                    });
+
+        // Symbols moving to the same NFA states share their configuration. Ranges of those (such as
+        // character classes) thus cost a single epsilon closure and coalesce as they are defined.
+        lastDelta.clear();
+        StateId t_i = 0;
+        for (auto i = moves.begin(); i != moves.end();)
         {
-            nfa_.epsilonClosure(*nfa_.delta(q, c, &delta), &eclosure);
-            if (!eclosure.empty())
+            const Symbol c = i->first;
+            for (delta.clear(); i != moves.end() && i->first == c; ++i)
+                delta.push_back(i->second);
+
+            if (delta != lastDelta)
             {
-                if (optional<StateId> t_i = configurationNumber(Q, eclosure); t_i.has_value())
-                    T.insert(q_i, c, *t_i); // T[q][c] = eclosure;
+                nfa_.epsilonClosure(delta, &eclosure);
+                if (auto k = configurations.find(eclosure); k != configurations.end())
+                    t_i = k->second;
                 else
                 {
+                    t_i = StateId { Q.size() };
                     Q.emplace_back(eclosure);
-                    t_i = StateId { Q.size() - 1 }; // equal to configurationNumber(Q, eclosure);
-                    T.insert(q_i, c, *t_i);         // T[q][c] = eclosure;
+                    configurations.emplace(eclosure, t_i);
                     workList.emplace_back(move(eclosure));
                 }
-                eclosure.clear();
+                swap(lastDelta, delta);
             }
-            delta.clear();
+            T.transitions[q_i].define(c, t_i); // T[q][c] = eclosure;
         }
     }
+    T.transitions.resize(Q.size());
 
     // Q now contains all the valid configurations and T all transitions between them
     return constructDFA(Q, T, overshadows);
@@ -165,12 +194,14 @@ DFA DFABuilder::constructDFA(const vector<StateIdVec>& Q,
     }
 
     // observe mapping from q_i to d_i
-    for (auto const& [q_i, branch]: T.transitions)
-        for (auto const [c, t_i]: branch)
-            dfa.setTransition(q_i, c, t_i);
+    for (StateId q_i = 0; q_i < T.transitions.size(); ++q_i)
+        for (const TransitionRanges::Range& r: T.transitions[q_i])
+            dfa.setTransition(q_i, r.first, r.last, r.target);
 
     // q_0 becomes d_0 (initial state)
     dfa.setInitialState(0);
+    if (nfa_.beginOfLineStateId().has_value())
+        dfa.setBeginOfLineState(1);
 
     if (overshadows)
     {
@@ -187,14 +218,6 @@ DFA DFABuilder::constructDFA(const vector<StateIdVec>& Q,
     return dfa;
 }
 
-optional<StateId> DFABuilder::configurationNumber(const vector<StateIdVec>& Q, const StateIdVec& t)
-{
-    if (auto i = find(begin(Q), end(Q), t); i != end(Q))
-        return distance(begin(Q), i);
-    else
-        return nullopt;
-}
-
 optional<Tag> DFABuilder::determineTag(const StateIdVec& qn, map<Tag, Tag>* overshadows) const
 {
     deque<Tag> tags;
@@ -37,11 +37,6 @@ class DFABuilder {
 	DFA constructDFA(const std::vector<StateIdVec>& Q, const TransitionTable& T,
 					 OvershadowMap* overshadows) const;
 
-	/**
-	 * Finds @p t in @p Q and returns its offset (aka configuration number) or -1 if not found.
-	 */
-	static std::optional<StateId> configurationNumber(const std::vector<StateIdVec>& Q, const StateIdVec& t);
-
 	/**
 	 * Determines the tag to use for the deterministic state representing @p q from non-deterministic FA @p
 	 * fa.
@@ -36,8 +36,12 @@ namespace klex::regular
 
 DFAMinimizer::DFAMinimizer(const DFA& dfa):
     dfa_ { dfa },
-    initialStates_ { { "INITIAL", dfa.initialState() } },
-    alphabet_ { dfa_.alphabet() },
+    initialStates_ { [&]() {
+        MultiDFA::InitialStateMap initialStates { { "INITIAL", dfa.initialState() } };
+        if (optional<StateId> bol = dfa.beginOfLineState(); bol.has_value())
+            initialStates["INITIAL_0"] = *bol;
+        return initialStates;
+    }() },
     targetStateIdMap_ {}
 {
 }
@@ -45,19 +49,10 @@ DFAMinimizer::DFAMinimizer(const DFA& dfa):
 DFAMinimizer::DFAMinimizer(const MultiDFA& multiDFA):
     dfa_ { multiDFA.dfa },
     initialStates_ { multiDFA.initialStates },
-    alphabet_ { dfa_.alphabet() },
     targetStateIdMap_ {}
 {
 }
 
-/**
- * Tests whether or not StateId @p s is an initial state in any of the DFAs of the MultiDFA.
- */
-bool DFAMinimizer::isMultiInitialState(StateId s) const
-{
-    return any_of(initialStates_.begin(), initialStates_.end(), [s](const auto& p) { return p.second == s; });
-}
-
 /**
  * Tests whether any s in S is the initial state in the DFA that is to be minimized.
  */
@@ -73,64 +68,58 @@ DFAMinimizer::PartitionVec::iterator DFAMinimizer::findGroup(StateId s)
     });
 }
 
-int DFAMinimizer::partitionId(StateId s) const
+void DFAMinimizer::updatePartitionIds()
 {
-    auto i =
-        find_if(P.begin(), P.end(), [s](const auto& p) { return find(p.begin(), p.end(), s) != p.end(); });
-    assert(i != P.end() && "State ID must be present in any of the partition sets.");
-    return static_cast<int>(distance(P.begin(), i));
+    partitionIds_.assign(dfa_.size(), -1);
+    int p_i = 0;
+    for (const StateIdVec& p: P)
+    {
+        for (StateId s: p)
+            partitionIds_[s] = p_i;
+        p_i++;
+    }
 }
 
 DFAMinimizer::PartitionVec DFAMinimizer::split(const StateIdVec& S) const
 {
-    for (Symbol c: alphabet_)
-    {
-        // if c splits S into s_1 and s_2
-        //      that is, phi(s_1, c) and phi(s_2, c) reside in two different p_i's (partitions)
-        // then return {s_1, s_2}
+    // Splits S by all input symbols at once, that is, two states s_1 and s_2 remain in the same
+    // partition iff phi(s_1, c) and phi(s_2, c) reside in the same p_i (partition) for every c.
+    //
+    // The signature of a state is the list of its transitions, with each target state replaced by the
+    // partition it currently resides in. States with equal signatures are indistinguishable so far.
+    // Adjacent symbol ranges leading into the same partition are merged, keeping signatures canonical.
 
-        map<int /*target partition set*/, StateIdVec /*source states*/> t_i;
-        for (StateId s: S)
+    using Signature = vector<tuple<Symbol, Symbol, int /*target partition set*/>>;
+
+    map<Signature, StateIdVec /*source states*/> t_i;
+    for (StateId s: S)
+    {
+        Signature signature;
+        signature.reserve(dfa_.stateTransitions(s).size());
+        for (const TransitionRanges::Range& r: dfa_.stateTransitions(s))
         {
-            if (const optional<StateId> t = dfa_.delta(s, c); t.has_value())
-                t_i[partitionId(*t)].push_back(s);
+            const int p = partitionId(r.target);
+            if (!signature.empty() && get<2>(signature.back()) == p && get<1>(signature.back()) + 1 == r.first)
+                get<1>(signature.back()) = r.last;
             else
-                t_i[-1].push_back(s);
+                signature.emplace_back(r.first, r.last, p);
         }
-        if (t_i.size() > 1)
-        {
-            DEBUG("split: {} on character '{}' into {} sets", to_string(S), (char) c, t_i.size());
-            PartitionVec result;
-            for (const pair<int, StateIdVec>& t: t_i)
-            {
-                result.emplace_back(move(t.second));
-                DEBUG(" partition {}: {}", t.first, t.second);
-            }
-            return result;
-        }
-
-        assert(t_i.size() == 1);
 
-        // t_i's only element thus is a reconstruction of S.
-        assert(t_i.begin()->second == S);
-
-        for (StateId s: S)
-        {
-            PartitionVec result;
-            StateIdVec main;
-
-            if (isMultiInitialState(s))
-                result.emplace_back(StateIdVec { s });
-            else
-                main.emplace_back(s);
+        t_i[move(signature)].push_back(s);
+    }
 
-            if (!main.empty())
-                result.emplace_back(move(main));
-        }
+    if (t_i.size() == 1)
+    {
+        DEBUG("split: no split needed for {}", to_string(S));
+        return { S };
     }
 
-    DEBUG("split: no split needed for {}", to_string(S));
-    return { S };
+    DEBUG("split: {} into {} sets", to_string(S), t_i.size());
+    PartitionVec result;
+    for (pair<const Signature, StateIdVec>& t: t_i)
+        result.emplace_back(move(t.second));
+
+    return result;
 }
 
 void DFAMinimizer::dumpGroups(const PartitionVec& T)
@@ -156,7 +145,12 @@ void DFAMinimizer::dumpGroups(const PartitionVec& T)
 DFA DFAMinimizer::constructDFA()
 {
     constructPartitions();
-    return constructFromPartitions(P);
+    DFA dfamin = constructFromPartitions(P);
+
+    if (optional<StateId> bol = dfa_.beginOfLineState(); bol.has_value())
+        dfamin.setBeginOfLineState(targetStateId(*bol));
+
+    return dfamin;
 }
 
 MultiDFA DFAMinimizer::constructMultiDFA()
@@ -200,11 +194,14 @@ void DFAMinimizer::constructPartitions()
     {
         swap(P, T);
         T.clear();
+        updatePartitionIds();
 
         for (StateIdVec& p: P)
             T.splice(T.end(), split(p));
     }
 
+    pinInitialStates();
+
     // build up cache to quickly get target state ID from input DFA's state ID
     targetStateIdMap_ = [&]() {
         unordered_map<StateId, StateId> remaps;
@@ -220,6 +217,45 @@ void DFAMinimizer::constructPartitions()
     }();
 }
 
+void DFAMinimizer::pinInitialStates()
+{
+    // Initial states get a partition of their own each, up front and in their original order, as the
+    // runtime relies on their relative numbering (e.g. a BOL initial state following its condition's).
+    // Any other state equivalent to an initial state stays in the partition of the first such one.
+    StateIdVec initialStates { dfa_.initialState() };
+    for (const pair<const string, StateId>& p: initialStates_)
+        initialStates.push_back(p.second);
+    sort(initialStates.begin(), initialStates.end());
+    initialStates.erase(unique(initialStates.begin(), initialStates.end()), initialStates.end());
+
+    vector<StateIdVec> pinned(initialStates.size());
+    vector<bool> taken(P.size(), false);
+    for (size_t i = 0; i < initialStates.size(); ++i)
+    {
+        const int p_i = partitionId(initialStates[i]);
+        pinned[i].push_back(initialStates[i]);
+        if (taken[p_i])
+            continue;
+
+        taken[p_i] = true;
+        for (StateId s: *next(P.begin(), p_i))
+            if (!binary_search(initialStates.begin(), initialStates.end(), s))
+                pinned[i].push_back(s);
+    }
+
+    PartitionVec result;
+    for (StateIdVec& p: pinned)
+        result.emplace_back(move(p));
+
+    int p_i = 0;
+    for (StateIdVec& p: P)
+        if (!taken[p_i++])
+            result.emplace_back(move(p));
+
+    P = move(result);
+    updatePartitionIds();
+}
+
 DFA DFAMinimizer::constructFromPartitions(const PartitionVec& P) const
 {
     DEBUG("minimization terminated with {} unique partition sets", P.size());
@@ -253,11 +289,11 @@ DFA DFAMinimizer::constructFromPartitions(const PartitionVec& P) const
     for (const StateIdVec& p: P)
     {
         const StateId s = *p.begin();
-        for (const pair<Symbol, StateId>& transition: dfa_.stateTransitions(s))
+        for (const TransitionRanges::Range& r: dfa_.stateTransitions(s))
         {
-            const int t_i = partitionId(transition.second);
-            DEBUG("map p{} --({})--> p{}", p_i, prettySymbol(transition.first), t_i);
-            dfamin.setTransition(p_i, transition.first, t_i);
+            const int t_i = partitionId(r.target);
+            DEBUG("map p{} --({}-{})--> p{}", p_i, prettySymbol(r.first), prettySymbol(r.last), t_i);
+            dfamin.setTransition(p_i, r.first, r.last, t_i);
         }
         p_i++;
     }
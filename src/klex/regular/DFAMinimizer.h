@@ -33,11 +33,12 @@ class DFAMinimizer {
 	using PartitionVec = std::list<StateIdVec>;
 
 	void constructPartitions();
+	void pinInitialStates();
 	StateIdVec nonAcceptStates() const;
 	bool containsInitialState(const StateIdVec& S) const;
-	bool isMultiInitialState(StateId s) const;
 	PartitionVec::iterator findGroup(StateId s);
-	int partitionId(StateId s) const;
+	int partitionId(StateId s) const { return partitionIds_[s]; }
+	void updatePartitionIds();
 	PartitionVec split(const StateIdVec& S) const;
 	DFA constructFromPartitions(const PartitionVec& P) const;
 	std::optional<StateId> containsBacktrackState(const StateIdVec& Q) const;
@@ -54,9 +55,9 @@ class DFAMinimizer {
   private:
 	const DFA& dfa_;
 	const MultiDFA::InitialStateMap initialStates_;
-	const Alphabet alphabet_;
 	PartitionVec T;
 	PartitionVec P;
+	std::vector<int> partitionIds_;  // maps each state to the index of its partition in P
 	std::unordered_map<StateId, StateId> targetStateIdMap_;
 };
 
@@ -0,0 +1,55 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/DFA.h>
+#include <klex/regular/DFAMinimizer.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+TEST(regular_DFAMinimizer, merge_equivalent_states)
+{
+    // both branches end up in equivalent states, after "a" or "c" as well as after "b"
+    Compiler cc;
+    cc.parse("Word ::= ab|cb");
+    const DFA dfa = cc.compileDFA();
+    ASSERT_EQ(5, dfa.size());
+
+    const DFA minimal = DFAMinimizer { dfa }.constructDFA();
+    EXPECT_EQ(3, minimal.size());
+    EXPECT_EQ(0, minimal.initialState());
+}
+
+TEST(regular_DFAMinimizer, initial_states_kept_apart)
+{
+    // A and B recognize the very same, yet each keeps an initial state of its own, in their original order
+    Compiler cc;
+    cc.parse(R"(|Eof              ::= <<EOF>>
+                |<A,B>Foo         ::= foo
+                |<A,B>Ws(ignore)  ::= [ ]+
+                |)"_multiline);
+    const MultiDFA multiDFA = cc.compileMultiDFA();
+    const MultiDFA minimal = DFAMinimizer { multiDFA }.constructMultiDFA();
+
+    EXPECT_TRUE(minimal.dfa.size() < multiDFA.dfa.size());
+    EXPECT_TRUE(minimal.initialStates.at("A") < minimal.initialStates.at("B"));
+    EXPECT_TRUE(minimal.initialStates.at("B") < minimal.initialStates.at("INITIAL"));
+}
+
+TEST(regular_DFAMinimizer, merge_into_initial_state)
+{
+    // a leading "b" leaves the DFA in a state equivalent to the initial one
+    Compiler cc;
+    cc.parse("Word ::= (a|b)*abb");
+    const DFA minimal = DFAMinimizer { cc.compileDFA() }.constructDFA();
+    EXPECT_EQ(4, minimal.size());
+    EXPECT_EQ(0, minimal.initialState());
+}
@@ -0,0 +1,94 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/DenseTable.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+DenseTable DenseTable::build(const std::map<StateId, TransitionRanges>& transitions, bool useClasses)
+{
+    if (transitions.empty())
+        return DenseTable {};
+
+    Symbol lo = numeric_limits<Symbol>::max();
+    Symbol hi = numeric_limits<Symbol>::min();
+    for (const pair<const StateId, TransitionRanges>& T: transitions)
+        for (const TransitionRanges::Range& r: T.second)
+        {
+            lo = min(lo, r.first);
+            hi = max(hi, r.last);
+        }
+
+    const size_t stateCount = transitions.rbegin()->first + 1;
+    const size_t symbolCount = static_cast<size_t>(hi - lo + 1);
+
+    // column-major first, such that equal columns can be told apart easily
+    vector<vector<Index>> columns(symbolCount, vector<Index>(stateCount, static_cast<Index>(ErrorState)));
+    for (const pair<const StateId, TransitionRanges>& T: transitions)
+        for (const TransitionRanges::Range& r: T.second)
+            for (Symbol c = r.first; c <= r.last; ++c)
+                columns[c - lo][T.first] = static_cast<Index>(r.target);
+
+    vector<Index> classes;
+    vector<size_t> representatives; // one column index per class
+    if (useClasses)
+    {
+        std::map<vector<Index>, Index> classOf;
+        classes.reserve(symbolCount);
+        for (size_t i = 0; i < symbolCount; ++i)
+        {
+            auto [k, inserted] = classOf.emplace(columns[i], static_cast<Index>(representatives.size()));
+            if (inserted)
+                representatives.push_back(i);
+            classes.push_back(k->second);
+        }
+    }
+    else
+    {
+        representatives.resize(symbolCount);
+        for (size_t i = 0; i < symbolCount; ++i)
+            representatives[i] = i;
+    }
+
+    const size_t classCount = representatives.size();
+    vector<Index> next(stateCount * classCount);
+    for (size_t s = 0; s < stateCount; ++s)
+        for (size_t k = 0; k < classCount; ++k)
+            next[s * classCount + k] = columns[representatives[k]][s];
+
+    return DenseTable { lo,
+                        static_cast<Index>(symbolCount),
+                        move(classes),
+                        static_cast<Index>(classCount),
+                        move(next) };
+}
+
+std::map<Symbol, StateId> DenseTable::map(StateId s) const
+{
+    std::map<Symbol, StateId> m;
+    for (Index i = 0; i < symbolCount_; ++i)
+        if (StateId t = apply(s, firstSymbol_ + static_cast<Symbol>(i)); t != ErrorState)
+            m[firstSymbol_ + static_cast<Symbol>(i)] = t;
+    return m;
+}
+
+vector<StateId> DenseTable::states() const
+{
+    vector<StateId> v;
+    for (StateId s = 0, e = stateCount(); s < e; ++s)
+        if (!map(s).empty())
+            v.push_back(s);
+    return v;
+}
+
+} // namespace klex::regular
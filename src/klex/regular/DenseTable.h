@@ -0,0 +1,95 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/State.h>
+#include <klex/regular/Symbols.h>
+#include <klex/regular/TransitionRanges.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Uncompressed (states x symbols) transition table, optionally with the symbols folded into
+ * equivalence classes first.
+ *
+ * Two symbols belong to the same class iff every state has the same transition on both of them,
+ * which e.g. folds all letters of an identifier rule that are not part of any keyword:
+ *
+ * @code
+ *   phi(s, c) = next[s * classCount + classes[c - firstSymbol]]
+ * @endcode
+ *
+ * Without classes, each symbol is its own class.
+ */
+class DenseTable {
+  public:
+	using Index = uint32_t;
+
+	DenseTable() : firstSymbol_{0}, symbolCount_{0}, classes_{}, classCount_{0}, next_{} {}
+
+	DenseTable(Symbol firstSymbol, Index symbolCount, std::vector<Index> classes, Index classCount,
+			   std::vector<Index> next)
+		: firstSymbol_{firstSymbol},
+		  symbolCount_{symbolCount},
+		  classes_{std::move(classes)},
+		  classCount_{classCount},
+		  next_{std::move(next)}
+	{
+	}
+
+	/**
+	 * Constructs the table from the given per-state transition ranges.
+	 *
+	 * @param transitions the transitions to lay out
+	 * @param useClasses whether or not to fold symbols into equivalence classes
+	 */
+	static DenseTable build(const std::map<StateId, TransitionRanges>& transitions, bool useClasses);
+
+	//! Retrieves the next state for the input (s, c) or ErrorState if not defined.
+	StateId apply(StateId s, Symbol c) const
+	{
+		const long i = static_cast<long>(c) - firstSymbol_;
+		if (i < 0 || i >= static_cast<long>(symbolCount_))
+			return ErrorState;
+
+		const size_t k = s * classCount_ + (classes_.empty() ? static_cast<Index>(i) : classes_[i]);
+		return k < next_.size() ? next_[k] : ErrorState;
+	}
+
+	//! Retrieves all transitions from state @p s.
+	std::map<Symbol, StateId> map(StateId s) const;
+
+	//! Retrieves the list of all states having at least one transition.
+	std::vector<StateId> states() const;
+
+	bool hasClasses() const noexcept { return !classes_.empty(); }
+
+	Symbol firstSymbol() const noexcept { return firstSymbol_; }
+	Index symbolCount() const noexcept { return symbolCount_; }
+	const std::vector<Index>& classes() const noexcept { return classes_; }
+	Index classCount() const noexcept { return classCount_; }
+	const std::vector<Index>& next() const noexcept { return next_; }
+
+	//! Number of states covered by this table.
+	size_t stateCount() const noexcept { return classCount_ ? next_.size() / classCount_ : 0; }
+
+	//! Number of bytes occupied by the table's arrays.
+	size_t footprint() const noexcept { return sizeof(Index) * (classes_.size() + next_.size()); }
+
+  private:
+	Symbol firstSymbol_;
+	Index symbolCount_;
+	std::vector<Index> classes_;
+	Index classCount_;
+	std::vector<Index> next_;
+};
+
+}  // namespace klex::regular
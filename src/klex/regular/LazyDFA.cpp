@@ -0,0 +1,159 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/LazyDFA.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+namespace
+{
+    // rough per-entry costs, including the container's own bookkeeping
+    constexpr size_t StateCost = sizeof(void*) * 16;
+    constexpr size_t TransitionCost = sizeof(void*) * 4;
+} // namespace
+
+LazyDFA::LazyDFA(map<string, NFA> automata, size_t memoryBudget, unsigned flushLimit):
+    automata_ {},
+    machines_ {},
+    memoryBudget_ { memoryBudget },
+    flushLimit_ { flushLimit },
+    states_ {},
+    configurations_ {},
+    initialStates_ {},
+    memoryUsage_ { 0 },
+    flushCount_ { 0 },
+    simulating_ { false }
+{
+    for (pair<const string, NFA>& fa: automata)
+    {
+        machines_[fa.first] = automata_.size();
+        automata_.emplace_back(move(fa.second));
+    }
+    initialStates_.resize(2 * automata_.size());
+}
+
+void LazyDFA::flush()
+{
+    states_.clear();
+    configurations_.clear();
+    fill(initialStates_.begin(), initialStates_.end(), nullopt);
+    memoryUsage_ = 0;
+}
+
+optional<LazyDFA::Match> LazyDFA::recognize(string_view input, bool isBeginOfLine, const string& machine)
+{
+    if (simulating_)
+        flush(); // configurations are only kept for the duration of a single token
+    else if (memoryUsage_ > memoryBudget_)
+    {
+        flush();
+        if (++flushCount_ >= flushLimit_)
+            simulating_ = true;
+    }
+
+    auto m = machines_.find(machine);
+    assert(m != machines_.end() && "No such machine.");
+
+    // path[i] is the state after having consumed i symbols, with the end of input being an
+    // <<EOF>> symbol of its own
+    vector<StateId> path { initialState(m->second, isBeginOfLine) };
+    while (path.size() <= input.size() + 1)
+    {
+        const size_t i = path.size() - 1;
+        const Symbol c = i < input.size() ? static_cast<unsigned char>(input[i]) : Symbols::EndOfFile;
+        const StateId t = delta(path.back(), c);
+        if (t == DeadState)
+            break;
+        path.push_back(t);
+    }
+
+    // backtrack to the last (right-most) accept state
+    size_t k = path.size();
+    do
+        --k;
+    while (k > 0 && !states_[path[k]].tag.has_value());
+
+    if (!states_[path[k]].tag.has_value())
+        return nullopt;
+
+    const Tag tag = *states_[path[k]].tag;
+    size_t length = k;
+
+    // backtrack to the right-most non-lookahead position
+    if (const optional<StateId> bt = states_[path[k]].backtrack; bt.has_value())
+        while (length > 0 && !contains(path[--length], *bt))
+            ;
+
+    return Match { tag, min(length, input.size()) };
+}
+
+StateId LazyDFA::initialState(size_t machine, bool beginOfLine)
+{
+    const NFA& nfa = automata_[machine];
+    const optional<StateId> bol = beginOfLine ? nfa.beginOfLineStateId() : nullopt;
+
+    optional<StateId>& s = initialStates_[2 * machine + (bol.has_value() ? 1 : 0)];
+    if (!s.has_value())
+        s = stateFor(machine, nfa.epsilonClosure({ bol.value_or(nfa.initialStateId()) }));
+
+    return *s;
+}
+
+StateId LazyDFA::delta(StateId s, Symbol c)
+{
+    if (auto i = states_[s].transitions.find(c); i != states_[s].transitions.end())
+        return i->second;
+
+    const NFA& nfa = automata_[states_[s].machine];
+    StateIdVec moves;
+    nfa.delta(states_[s].configuration, c, &moves);
+    sort(moves.begin(), moves.end());
+    moves.erase(unique(moves.begin(), moves.end()), moves.end());
+
+    StateIdVec eclosure;
+    if (!moves.empty())
+        nfa.epsilonClosure(moves, &eclosure);
+
+    const StateId t = eclosure.empty() ? DeadState : stateFor(states_[s].machine, move(eclosure));
+    states_[s].transitions.emplace(c, t);
+    memoryUsage_ += TransitionCost;
+    return t;
+}
+
+StateId LazyDFA::stateFor(size_t machine, StateIdVec&& configuration)
+{
+    if (auto i = configurations_.find({ machine, configuration }); i != configurations_.end())
+        return i->second;
+
+    const NFA& nfa = automata_[machine];
+    State state { machine, configuration, nullopt, nfa.containsBacktrackState(configuration), {} };
+
+    // if multiple rules accept, the one declared first (lowest tag) wins
+    for (StateId q: configuration)
+        if (optional<Tag> tag = nfa.acceptTag(q); tag.has_value() && (!state.tag || *tag < *state.tag))
+            state.tag = tag;
+
+    const StateId s = states_.size();
+    memoryUsage_ += StateCost + 2 * configuration.size() * sizeof(StateId);
+    configurations_.emplace(make_pair(machine, move(configuration)), s);
+    states_.emplace_back(move(state));
+    return s;
+}
+
+bool LazyDFA::contains(StateId s, StateId nfaState) const
+{
+    const StateIdVec& configuration = states_[s].configuration;
+    return binary_search(configuration.begin(), configuration.end(), nfaState);
+}
+
+} // namespace klex::regular
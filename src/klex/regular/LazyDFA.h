@@ -0,0 +1,118 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/NFA.h>
+#include <klex/regular/State.h>
+
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * A DFA that is constructed lazily, while scanning.
+ *
+ * Subset construction (as in DFABuilder) is run on demand, only for those states and transitions
+ * the scanned input actually visits. This makes it suitable for rule sets only known at runtime
+ * whose full DFA would be too big (or too slow) to construct up front.
+ *
+ * Discovered states are cached. Whenever the cache exceeds its memory budget, it is flushed
+ * (in between two tokens) and rebuilt from scratch. If it had to be flushed too often,
+ * the engine gives up on caching and falls back to plain NFA simulation, that is, configurations
+ * are then only kept for the duration of a single token.
+ *
+ * Accept tags (lowest tag wins), lookahead backtracking and begin-of-line rules behave
+ * like the tables generated by the Compiler.
+ */
+class LazyDFA {
+  public:
+	//! Default upper bound (in bytes) the state cache may occupy before it is flushed.
+	static constexpr size_t DefaultMemoryBudget = 4 * 1024 * 1024;
+
+	//! Default number of cache flushes after which the engine falls back to NFA simulation.
+	static constexpr unsigned DefaultFlushLimit = 8;
+
+	struct Match {
+		Tag tag;
+		size_t length;  //!< number of input bytes matched (matching <<EOF>> does not count)
+	};
+
+	/**
+	 * Constructs a lazy DFA for the given NFAs.
+	 *
+	 * @param automata     one NFA per machine (condition), such as Compiler::automata()
+	 * @param memoryBudget upper bound (in bytes) of the state cache
+	 * @param flushLimit   number of flushes after which to fall back to NFA simulation
+	 */
+	explicit LazyDFA(std::map<std::string, NFA> automata, size_t memoryBudget = DefaultMemoryBudget,
+					 unsigned flushLimit = DefaultFlushLimit);
+
+	/**
+	 * Recognizes the longest match of any rule at the beginning of @p input.
+	 *
+	 * @param input         the remaining input, whose end denotes the end of file
+	 * @param isBeginOfLine whether or not @p input starts at the beginning of a line
+	 * @param machine       the machine (condition) to run
+	 *
+	 * @returns the match or std::nullopt if no rule matches.
+	 */
+	std::optional<Match> recognize(std::string_view input, bool isBeginOfLine = false,
+								   const std::string& machine = "INITIAL");
+
+	//! Retrieves the number of DFA states currently cached.
+	size_t size() const noexcept { return states_.size(); }
+
+	//! Retrieves the (approximate) number of bytes currently occupied by the state cache.
+	size_t memoryUsage() const noexcept { return memoryUsage_; }
+
+	//! Retrieves how often the state cache has been flushed so far.
+	unsigned flushCount() const noexcept { return flushCount_; }
+
+	//! Tests whether the engine has fallen back to NFA simulation.
+	bool isSimulating() const noexcept { return simulating_; }
+
+	//! Flushes the state cache.
+	void flush();
+
+  private:
+	static constexpr StateId DeadState = std::numeric_limits<StateId>::max();
+
+	struct State {
+		size_t machine;
+		StateIdVec configuration;  // the set of NFA states this DFA state represents
+		std::optional<Tag> tag;
+		std::optional<StateId> backtrack;  // NFA state to backtrack to, if any
+		std::unordered_map<Symbol, StateId> transitions;
+	};
+
+	StateId initialState(size_t machine, bool beginOfLine);
+	StateId delta(StateId s, Symbol c);
+	StateId stateFor(size_t machine, StateIdVec&& configuration);
+	bool contains(StateId s, StateId nfaState) const;
+
+  private:
+	std::vector<NFA> automata_;
+	std::map<std::string, size_t> machines_;
+	size_t memoryBudget_;
+	unsigned flushLimit_;
+
+	std::vector<State> states_;
+	std::map<std::pair<size_t, StateIdVec>, StateId> configurations_;
+	std::vector<std::optional<StateId>> initialStates_;  // per machine, and per begin-of-line or not
+	size_t memoryUsage_;
+	unsigned flushCount_;
+	bool simulating_;
+};
+
+}  // namespace klex::regular
@@ -0,0 +1,75 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/LazyDFA.h>
+#include <klex/regular/test_util.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+TEST(regular_LazyDFA, lexing_equivalence)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    LazyDFA lazy = cc.compileLazyDFA();
+
+    Compiler reference;
+    reference.parse(sampleRules);
+    expectSameTokens(reference.compileMulti(), lazy, sampleInput);
+    EXPECT_EQ(0, lazy.flushCount());
+}
+
+TEST(regular_LazyDFA, no_match)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    LazyDFA lazy = cc.compileLazyDFA();
+
+    EXPECT_FALSE(lazy.recognize("#").has_value());
+    EXPECT_FALSE(lazy.recognize("9").has_value()); // Number needs 2 digits at least
+}
+
+TEST(regular_LazyDFA, flush_and_simulate)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    LazyDFA lazy = cc.compileLazyDFA(0); // no budget, every token flushes the cache
+
+    Compiler reference;
+    reference.parse(sampleRules);
+    expectSameTokens(reference.compileMulti(), lazy, sampleInput);
+
+    EXPECT_TRUE(lazy.isSimulating());
+    EXPECT_EQ(LazyDFA::DefaultFlushLimit, lazy.flushCount());
+}
+
+TEST(regular_LazyDFA, exponential_blowup)
+{
+    // The full DFA needs 2^13 states to remember the last 13 symbols, whereas scanning
+    // a short input only ever visits a handful of them.
+    Compiler cc;
+    cc.parse(R"(|Eof   ::= <<EOF>>
+                |Word  ::= (a|b)*a(a|b){12}
+                |)"_multiline);
+    LazyDFA lazy = cc.compileLazyDFA();
+
+    optional<LazyDFA::Match> match = lazy.recognize("abaabbbaaabab");
+    ASSERT_TRUE(match.has_value());
+    EXPECT_EQ(2, match->tag);
+    EXPECT_EQ(13, match->length);
+    EXPECT_TRUE(lazy.size() < 32);
+
+    EXPECT_FALSE(lazy.recognize("bbbbbbbbbbbbb").has_value());
+}
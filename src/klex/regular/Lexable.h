@@ -8,6 +8,7 @@
 
 #include <klex/regular/Lexer.h>  // TokenInfo: TODO: remove that header/API (inline TokenInfo here then)
 #include <klex/regular/LexerDef.h>
+#include <klex/regular/LexerStats.h>
 
 #include <fmt/format.h>
 
@@ -37,7 +38,7 @@ struct LexerError : public std::runtime_error {
 };
 
 template <typename Token = Tag, typename Machine = StateId, const bool RequiresBeginOfLine = true,
-		  const bool Trace = false>
+		  const bool Trace = false, const bool Stats = false>
 class LexerIterator {
   public:
 	using TokenInfo = klex::regular::TokenInfo<Token>;
@@ -80,6 +81,9 @@ class LexerIterator {
 	auto token() const noexcept { return currentToken_.token; }
 	auto name() const noexcept { return name(token()); }
 
+	//! @returns the runtime counters collected so far (a NoLexerStats placeholder unless @c Stats is set).
+	const LexerStatsType<Stats>& stats() const noexcept { return stats_; }
+
 	bool operator==(const LexerIterator& rhs) const noexcept;
 	bool operator!=(const LexerIterator& rhs) const noexcept;
 
@@ -140,22 +144,26 @@ class LexerIterator {
 	bool isBeginOfLine_ = true;
 	int currentChar_ = -1;
 	std::vector<int> buffered_;
+	LexerStatsType<Stats> stats_;
 };
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline Token token(const LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>& it)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline Token token(const LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>& it)
 {
 	return it.token();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline size_t offset(const LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>& it)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline size_t offset(const LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>& it)
 {
 	return it.offset();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline const std::string& literal(const LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>& it)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline const std::string& literal(const LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>& it)
 {
 	return it.literal();
 }
@@ -164,11 +172,11 @@ inline const std::string& literal(const LexerIterator<Token, Machine, RequiresBe
  * @brief Holds a lexically analyzable stream of characters with a Lexer definition.
  */
 template <typename Token = Tag, typename Machine = StateId, const bool RequiresBeginOfLine = true,
-		  const bool Trace = false>
+		  const bool Trace = false, const bool Stats = false>
 class Lexable {
   public:
 	using TraceFn = std::function<void(const std::string&)>;
-	using iterator = LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>;
+	using iterator = LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>;
 	using value_type = TokenInfo<Token>;
 
 	Lexable(const LexerDef& ld, std::istream& src, TraceFn trace = TraceFn{})
@@ -209,63 +217,72 @@ class Lexable {
 	TraceFn trace_;
 };
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline auto begin(const Lexable<Token, Machine, RequiresBeginOfLine, Trace>& ls)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline auto begin(const Lexable<Token, Machine, RequiresBeginOfLine, Trace, Stats>& ls)
 {
 	return ls.begin();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline auto end(const Lexable<Token, Machine, RequiresBeginOfLine, Trace>& ls)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline auto end(const Lexable<Token, Machine, RequiresBeginOfLine, Trace, Stats>& ls)
 {
 	return ls.end();
 }
 
 // {{{ LexerIterator: impl
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::LexerIterator(Eof) : eof_{2}
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::LexerIterator(Eof) : eof_{2}
 {
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::LexerIterator(const LexerDef& ld,
-																		 std::istream& source, TraceFn trace)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::LexerIterator(
+	const LexerDef& ld, std::istream& source, TraceFn trace)
 	: def_{&ld}, trace_{trace}, source_{&source}
 {
 	recognize();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-Machine LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::defaultMachine() const noexcept
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+Machine LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::defaultMachine() const noexcept
 {
 	auto i = def_->initialStates.find("INITIAL");
 	assert(i != def_->initialStates.end());
 	return static_cast<Machine>(i->second);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-Machine LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::setMachine(Machine machine)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+Machine LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::setMachine(Machine machine)
 {
 	return initialStateId_ = static_cast<StateId>(machine);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-bool LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::operator==(const LexerIterator& rhs) const
-	noexcept
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+bool LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::operator==(
+	const LexerIterator& rhs) const noexcept
 {
 	return offset_ == rhs.offset_ || (eof_ == 2 && rhs.eof_ == 2);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-bool LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::operator!=(const LexerIterator& rhs) const
-	noexcept
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+bool LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::operator!=(
+	const LexerIterator& rhs) const noexcept
 {
 	return !(*this == rhs);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>&
-LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::operator++()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>&
+LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::operator++()
 {
 	if (eof())
 		eof_++;
@@ -274,9 +291,10 @@ LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::operator++()
 	return *this;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>&
-LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::operator++(int)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>&
+LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::operator++(int)
 {
 	if (eof())
 		eof_++;
@@ -285,16 +303,18 @@ LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::operator++(int)
 	return *this;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::recognize()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::recognize()
 {
 	for (;;)
 		if (Token tag = recognizeOne(); static_cast<Tag>(tag) != IgnoreTag)
 			return;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline Token LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::recognizeOne()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline Token LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::recognizeOne()
 {
 	// init
 	currentToken_.offset = offset_;
@@ -320,6 +340,7 @@ inline Token LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::recogniz
 		stack.push_back(state);
 		state = delta(state, ch);
 	}
+	[[maybe_unused]] const size_t scanned = currentToken_.literal.size();
 
 	// backtrack to last (right-most) accept state
 	while (state != BadState && !isAcceptState(state))
@@ -373,11 +394,20 @@ inline Token LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::recogniz
 	assert(i != def_->acceptStates.end() && "Accept state hit, but no tag assigned.");
 	isBeginOfLine_ = currentToken_.literal.back() == '\n';
 
+	if constexpr (Stats)
+	{
+		// the symbol the scanner stopped at is the regular lookahead of a longest match
+		stats_.recordLookahead(scanned - currentToken_.literal.size() - 1);
+		stats_.recordToken(i->second);
+	}
+
 	return currentToken_.token = static_cast<Token>(i->second);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline StateId LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::getInitialState() const noexcept
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline StateId LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::getInitialState() const
+	noexcept
 {
 	if constexpr (RequiresBeginOfLine)
 		if (isBeginOfLine_ && def_->containsBeginOfLineStates)
@@ -386,15 +416,17 @@ inline StateId LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::getIni
 	return static_cast<StateId>(initialStateId_);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline bool LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::isAcceptState(StateId id) const
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline bool LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::isAcceptState(StateId id) const
 {
 	return def_->acceptStates.find(id) != def_->acceptStates.end();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-StateId LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::delta(StateId currentState,
-																		 Symbol inputSymbol) const
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+StateId LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::delta(StateId currentState,
+																				Symbol inputSymbol) const
 {
 	const StateId nextState = def_->transitions.apply(currentState, inputSymbol);
 	if constexpr (Trace)
@@ -410,8 +442,9 @@ StateId LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::delta(StateId
 	return nextState;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline Symbol LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::nextChar()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline Symbol LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::nextChar()
 {
 	if (!buffered_.empty())
 	{
@@ -420,6 +453,11 @@ inline Symbol LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::nextCha
 		buffered_.resize(buffered_.size() - 1);
 		if constexpr (Trace)
 			tracef("Lexer:{}: advance '{}'", offset_, prettySymbol(ch));
+		if constexpr (Stats)
+		{
+			++stats_.rereads;
+			++stats_.bytesScanned;
+		}
 		offset_++;
 		return ch;
 	}
@@ -444,12 +482,15 @@ inline Symbol LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::nextCha
 	currentChar_ = ch;
 	if constexpr (Trace)
 		tracef("Lexer:{}: advance '{}'", offset_, prettySymbol(ch));
+	if constexpr (Stats)
+		++stats_.bytesScanned;
 	offset_++;
 	return ch;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::rollback()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::rollback()
 {
 	currentChar_ = currentToken_.literal.back();
 	if (currentToken_.literal.back() != -1)
@@ -461,26 +502,30 @@ inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::rollback(
 
 // =================================================================================
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
 template <typename... Args>
-inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::tracef(const char* msg,
-																			  Args&&... args) const
+inline void LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::tracef(const char* msg,
+																					 Args&&... args) const
 {
 	if constexpr (Trace)
 		if (trace_)
 			trace_(fmt::format(msg, std::forward<Args>(args)...));
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-inline const std::string& LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::name(Token t) const
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+inline const std::string& LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::name(
+	Token t) const
 {
 	auto i = def_->tagNames.find(static_cast<Tag>(t));
 	assert(i != def_->tagNames.end());
 	return i->second;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline std::string LexerIterator<Token, Machine, RequiresBeginOfLine, Debug>::toString(
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline std::string LexerIterator<Token, Machine, RequiresBeginOfLine, Debug, Stats>::toString(
 	const std::deque<StateId>& stack)
 {
 	std::stringstream sstr;
@@ -498,16 +543,18 @@ inline std::string LexerIterator<Token, Machine, RequiresBeginOfLine, Debug>::to
 	return sstr.str();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-Token LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>::token(StateId s) const
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+Token LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>::token(StateId s) const
 {
 	auto i = def_->acceptStates.find(s);
 	assert(i != def_->acceptStates.end());
 	return static_cast<Token>(i->second);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline std::string LexerIterator<Token, Machine, RequiresBeginOfLine, Debug>::stateName(StateId s)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline std::string LexerIterator<Token, Machine, RequiresBeginOfLine, Debug, Stats>::stateName(StateId s)
 {
 	switch (s)
 	{
@@ -524,9 +571,10 @@ inline std::string LexerIterator<Token, Machine, RequiresBeginOfLine, Debug>::st
 }  // namespace klex::regular
 
 namespace std {
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-struct iterator_traits<klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>> {
-	using iterator = klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>;
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+struct iterator_traits<klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>> {
+	using iterator = klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>;
 
 	using difference_type = typename iterator::difference_type;
 	using value_type = typename iterator::value_type;
@@ -537,10 +585,11 @@ struct iterator_traits<klex::regular::LexerIterator<Token, Machine, RequiresBegi
 }  // namespace std
 
 namespace fmt {
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace>
-struct formatter<klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>> {
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Trace,
+		  const bool Stats>
+struct formatter<klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>> {
 	using TokenInfo = klex::regular::TokenInfo<Token>;
-	using LexerIterator = klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace>;
+	using LexerIterator = klex::regular::LexerIterator<Token, Machine, RequiresBeginOfLine, Trace, Stats>;
 
 	template <typename ParseContext>
 	constexpr auto parse(ParseContext& ctx)
@@ -33,8 +33,10 @@ static inline std::string quotedString(const std::string& s)
 	return sstr.str();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline Lexer<Token, Machine, RequiresBeginOfLine, Debug>::Lexer(const LexerDef& info, DebugLogger logger)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::Lexer(const LexerDef& info,
+																	   DebugLogger logger)
 	: def_{info},
 	  debug_{logger},
 	  initialStateId_{defaultMachine()},
@@ -54,34 +56,41 @@ inline Lexer<Token, Machine, RequiresBeginOfLine, Debug>::Lexer(const LexerDef&
 				"begin-of-line support disabled."};
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline Lexer<Token, Machine, RequiresBeginOfLine, Debug>::Lexer(const LexerDef& info,
-																std::unique_ptr<std::istream> stream,
-																DebugLogger logger)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::Lexer(const LexerDef& info,
+																	   std::unique_ptr<std::istream> stream,
+																	   DebugLogger logger)
 	: Lexer{info, std::move(logger)}
 {
 	reset(std::move(stream));
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline Lexer<Token, Machine, RequiresBeginOfLine, Debug>::Lexer(const LexerDef& info, std::istream& stream,
-																DebugLogger logger)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::Lexer(const LexerDef& info,
+																	   std::istream& stream,
+																	   DebugLogger logger)
 	: Lexer{info, std::move(logger)}
 {
 	stream_ = &stream;
 	fileSize_ = getFileSize();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline Lexer<Token, Machine, RequiresBeginOfLine, Debug>::Lexer(const LexerDef& info, std::string input,
-																DebugLogger logger)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::Lexer(const LexerDef& info,
+																	   std::string input,
+																	   DebugLogger logger)
 	: Lexer{info, std::move(logger)}
 {
 	reset(std::make_unique<std::stringstream>(std::move(input)));
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug>::reset(std::unique_ptr<std::istream> stream)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::reset(
+	std::unique_ptr<std::istream> stream)
 {
 	ownedStream_ = std::move(stream);
 	stream_ = ownedStream_.get();
@@ -91,14 +100,16 @@ inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug>::reset(std::unique
 	fileSize_ = getFileSize();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug>::reset(const std::string& text)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::reset(const std::string& text)
 {
 	reset(std::make_unique<std::stringstream>(text));
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline size_t Lexer<Token, Machine, RequiresBeginOfLine, Debug>::getFileSize()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline size_t Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::getFileSize()
 {
 	std::streamoff oldpos = stream_->tellg();
 	stream_->seekg(0, stream_->end);
@@ -109,9 +120,10 @@ inline size_t Lexer<Token, Machine, RequiresBeginOfLine, Debug>::getFileSize()
 	return static_cast<size_t>(theSize);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline std::string Lexer<Token, Machine, RequiresBeginOfLine, Debug>::stateName(StateId s,
-																				const std::string_view& n)
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline std::string Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::stateName(
+	StateId s, const std::string_view& n)
 {
 	switch (s)
 	{
@@ -124,8 +136,9 @@ inline std::string Lexer<Token, Machine, RequiresBeginOfLine, Debug>::stateName(
 	}
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline std::string Lexer<Token, Machine, RequiresBeginOfLine, Debug>::toString(
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline std::string Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::toString(
 	const std::deque<StateId>& stack)
 {
 	std::stringstream sstr;
@@ -143,16 +156,18 @@ inline std::string Lexer<Token, Machine, RequiresBeginOfLine, Debug>::toString(
 	return sstr.str();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline auto Lexer<Token, Machine, RequiresBeginOfLine, Debug>::recognize() -> TokenInfo
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline auto Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::recognize() -> TokenInfo
 {
 	for (;;)
 		if (Token tag = recognizeOne(); static_cast<Tag>(tag) != IgnoreTag)
 			return TokenInfo{tag, word_, oldOffset_};
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline StateId Lexer<Token, Machine, RequiresBeginOfLine, Debug>::getInitialState() const noexcept
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline StateId Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::getInitialState() const noexcept
 {
 	if constexpr (RequiresBeginOfLine)
 	{
@@ -165,8 +180,9 @@ inline StateId Lexer<Token, Machine, RequiresBeginOfLine, Debug>::getInitialStat
 	return static_cast<StateId>(initialStateId_);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline Token Lexer<Token, Machine, RequiresBeginOfLine, Debug>::recognizeOne()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline Token Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::recognizeOne()
 {
 	// init
 	oldOffset_ = offset_;
@@ -190,6 +206,7 @@ inline Token Lexer<Token, Machine, RequiresBeginOfLine, Debug>::recognizeOne()
 		stack.push_back(state);
 		state = delta(state, ch);
 	}
+	[[maybe_unused]] const size_t scanned = word_.size();
 
 	// backtrack to last (right-most) accept state
 	while (state != BadState && !isAcceptState(state))
@@ -242,12 +259,21 @@ inline Token Lexer<Token, Machine, RequiresBeginOfLine, Debug>::recognizeOne()
 	auto i = def_.acceptStates.find(state);
 	assert(i != def_.acceptStates.end() && "Accept state hit, but no tag assigned.");
 	isBeginOfLine_ = word_.back() == '\n';
+
+	if constexpr (Stats)
+	{
+		// the symbol the scanner stopped at is the regular lookahead of a longest match
+		stats_.recordLookahead(scanned - word_.size() - 1);
+		stats_.recordToken(i->second);
+	}
+
 	return token_ = static_cast<Token>(i->second);
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline StateId Lexer<Token, Machine, RequiresBeginOfLine, Debug>::delta(StateId currentState,
-																		Symbol inputSymbol) const
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline StateId Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::delta(StateId currentState,
+																			   Symbol inputSymbol) const
 {
 	const StateId nextState = def_.transitions.apply(currentState, inputSymbol);
 	if constexpr (Debug)
@@ -267,14 +293,16 @@ inline StateId Lexer<Token, Machine, RequiresBeginOfLine, Debug>::delta(StateId
 	return nextState;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline bool Lexer<Token, Machine, RequiresBeginOfLine, Debug>::isAcceptState(StateId id) const
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline bool Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::isAcceptState(StateId id) const
 {
 	return def_.acceptStates.find(id) != def_.acceptStates.end();
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline Symbol Lexer<Token, Machine, RequiresBeginOfLine, Debug>::nextChar()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline Symbol Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::nextChar()
 {
 	if (!buffered_.empty())
 	{
@@ -283,6 +311,11 @@ inline Symbol Lexer<Token, Machine, RequiresBeginOfLine, Debug>::nextChar()
 		buffered_.resize(buffered_.size() - 1);
 		if constexpr (Debug)
 			debugf("Lexer:{}: advance '{}'", offset_, prettySymbol(ch));
+		if constexpr (Stats)
+		{
+			++stats_.rereads;
+			++stats_.bytesScanned;
+		}
 		offset_++;
 		return ch;
 	}
@@ -307,12 +340,15 @@ inline Symbol Lexer<Token, Machine, RequiresBeginOfLine, Debug>::nextChar()
 	currentChar_ = ch;
 	if constexpr (Debug)
 		debugf("Lexer:{}: advance '{}'", offset_, prettySymbol(ch));
+	if constexpr (Stats)
+		++stats_.bytesScanned;
 	offset_++;
 	return ch;
 }
 
-template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug>
-inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug>::rollback()
+template <typename Token, typename Machine, const bool RequiresBeginOfLine, const bool Debug,
+		  const bool Stats>
+inline void Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::rollback()
 {
 	currentChar_ = word_.back();
 	if (word_.back() != -1)
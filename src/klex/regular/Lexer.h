@@ -7,6 +7,7 @@
 #pragma once
 
 #include <klex/regular/LexerDef.h>
+#include <klex/regular/LexerStats.h>
 #include <fmt/format.h>
 
 #include <cassert>
@@ -63,7 +64,7 @@ inline const std::string& to_string(const TokenInfo<Token>& info) noexcept
  * Lexer API for recognizing words.
  */
 template <typename Token = Tag, typename Machine = StateId, const bool RequiresBeginOfLine = true,
-		  const bool Debug = false>
+		  const bool Debug = false, const bool Stats = false>
 class Lexer {
   public:
 	using value_type = Token;
@@ -196,6 +197,9 @@ class Lexer {
 
 	size_t fileSize() const noexcept { return fileSize_; }
 
+	//! @returns the runtime counters collected so far (a NoLexerStats placeholder unless @c Stats is set).
+	const LexerStatsType<Stats>& stats() const noexcept { return stats_; }
+
   private:
 	template <typename... Args>
 	inline void debugf(const char* msg, Args... args) const
@@ -239,12 +243,13 @@ class Lexer {
 	bool isBeginOfLine_;
 	int currentChar_;
 	Token token_;
+	LexerStatsType<Stats> stats_;
 };
 
 template <typename Token = Tag, typename Machine = StateId, const bool RequiresBeginOfLine = true,
-		  const bool Debug = false>
+		  const bool Debug = false, const bool Stats = false>
 inline const std::string& to_string(
-	const typename Lexer<Token, Machine, RequiresBeginOfLine, Debug>::iterator& it) noexcept
+	const typename Lexer<Token, Machine, RequiresBeginOfLine, Debug, Stats>::iterator& it) noexcept
 {
 	return it.info.literal;
 }
@@ -0,0 +1,105 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/State.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Runtime counters of a Lexer or LexerIterator, collected when instantiated with @c Stats = true.
+ *
+ * A high ratio of @c rereads to @c bytesScanned or a growing @c longestLookahead indicate
+ * rules that make the lexer scan far beyond the tokens it eventually recognizes.
+ */
+struct LexerStats {
+	//! number of input symbols fed into the transition table, including re-read ones
+	size_t bytesScanned = 0;
+
+	//! number of recognized tokens, indexed by their tag (ignored tokens excluded)
+	std::vector<size_t> tokens;
+
+	//! number of recognized tokens that are to be ignored
+	size_t ignoredTokens = 0;
+
+	//! number of tokens for which the scanner overshot by more than the one symbol of lookahead
+	//! any longest match requires, and had to roll back the input
+	size_t rollbacks = 0;
+
+	//! number of symbols scanned again after they have been rolled back (including the regular lookahead)
+	size_t rereads = 0;
+
+	//! the maximum number of symbols scanned beyond the end of a token and its regular lookahead
+	size_t longestLookahead = 0;
+
+	//! @returns the number of recognized tokens of given tag @p t.
+	size_t tokenCount(Tag t) const noexcept
+	{
+		return t >= 0 && static_cast<size_t>(t) < tokens.size() ? tokens[static_cast<size_t>(t)] : 0;
+	}
+
+	//! @returns the number of recognized tokens, excluding ignored ones.
+	size_t tokenCount() const noexcept { return std::accumulate(tokens.begin(), tokens.end(), size_t{0}); }
+
+	void recordToken(Tag t)
+	{
+		if (t < 0)
+			++ignoredTokens;
+		else
+		{
+			if (static_cast<size_t>(t) >= tokens.size())
+				tokens.resize(static_cast<size_t>(t) + 1);
+			++tokens[static_cast<size_t>(t)];
+		}
+	}
+
+	void recordLookahead(size_t distance)
+	{
+		if (distance != 0)
+		{
+			++rollbacks;
+			longestLookahead = std::max(longestLookahead, distance);
+		}
+	}
+};
+
+//! Placeholder for LexerStats when Stats are disabled.
+struct NoLexerStats {};
+
+template <const bool Stats>
+using LexerStatsType = std::conditional_t<Stats, LexerStats, NoLexerStats>;
+
+}  // namespace klex::regular
+
+namespace fmt {
+template <>
+struct formatter<klex::regular::LexerStats> {
+	template <typename ParseContext>
+	constexpr auto parse(ParseContext& ctx)
+	{
+		return ctx.begin();
+	}
+
+	template <typename FormatContext>
+	constexpr auto format(const klex::regular::LexerStats& v, FormatContext& ctx)
+	{
+		return format_to(ctx.out(),
+						 "bytesScanned={} tokens={} ignoredTokens={} rollbacks={} rereads={} "
+						 "longestLookahead={}",
+						 v.bytesScanned, v.tokenCount(), v.ignoredTokens, v.rollbacks, v.rereads,
+						 v.longestLookahead);
+	}
+};
+}  // namespace fmt
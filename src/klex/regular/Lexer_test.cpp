@@ -271,6 +271,26 @@ TEST(regular_Lexer, bol_and_other_conditions)
     ASSERT_EQ(3, *++lexer); // <<EOF>>
 }
 
+TEST(regular_Lexer, bol_shared_automaton)
+{
+    Compiler cc;
+    cc.parse(R"(|Spacing(ignore)  ::= [\s\t\n]+
+			    |Eof              ::= <<EOF>>
+			    |<A>Pragma        ::= ^pragma
+			    |<A>Ident         ::= [a-z]+
+			    |<AB>Jump         ::= jmp)"_multiline);
+
+    // one automaton per condition, with begin-of-line being an extra initial state
+    EXPECT_EQ(3, cc.automata().size());
+    EXPECT_TRUE(cc.automata().at("A").beginOfLineStateId().has_value());
+
+    // each begin-of-line initial state directly follows its condition's one
+    LexerDef ld = cc.compileMulti();
+    EXPECT_EQ(ld.initialStates.at("A") + 1, ld.initialStates.at("A_0"));
+    EXPECT_EQ(ld.initialStates.at("AB") + 1, ld.initialStates.at("AB_0"));
+    EXPECT_EQ(ld.initialStates.at("INITIAL") + 1, ld.initialStates.at("INITIAL_0"));
+}
+
 TEST(regular_Lexer, bol_rules_on_non_bol_lexer)
 {
     Compiler cc;
@@ -597,3 +617,109 @@ TEST(regular_Lexer, internal)
     ASSERT_EQ("IPv6", fmt::format("{}", RealWorld::IPv6));
     ASSERT_EQ("<724>", fmt::format("{}", static_cast<RealWorld>(724)));
 }
+
+TEST(regular_Lexer, counted_repetition)
+{
+    Compiler cc;
+    cc.parse(R"(|Spacing(ignore)  ::= [\s\t\n]+
+                |Eof              ::= <<EOF>>
+                |A2to4            ::= a{2,4}
+                |B3               ::= b{3}
+                |Digits           ::= [0-9]{1,64}
+                |)"_multiline);
+
+    LexerDef ld = cc.compileMulti();
+    Lexable<Tag, StateId, false, false> ls { ld, "aa aaa aaaaaa bbb 0123456789" };
+    auto lexer = begin(ls);
+
+    ASSERT_EQ(2, *lexer);
+    ASSERT_EQ("aa", literal(lexer));
+
+    ASSERT_EQ(2, *++lexer);
+    ASSERT_EQ("aaa", literal(lexer));
+
+    ASSERT_EQ(2, *++lexer);
+    ASSERT_EQ("aaaa", literal(lexer));
+
+    ASSERT_EQ(2, *++lexer);
+    ASSERT_EQ("aa", literal(lexer));
+
+    ASSERT_EQ(3, *++lexer);
+    ASSERT_EQ("bbb", literal(lexer));
+
+    ASSERT_EQ(4, *++lexer);
+    ASSERT_EQ("0123456789", literal(lexer));
+
+    ASSERT_EQ(1, *++lexer);
+}
+
+TEST(regular_Lexer, literal_rules)
+{
+    Compiler cc;
+    cc.parse(R"(|Spacing(ignore)  ::= [\s\t\n]+
+                |Eof              ::= <<EOF>>
+                |Less             ::= "<"
+                |LessEqual        ::= "<="
+                |ShiftLeft        ::= "<<"
+                |If               ::= if
+                |Ident            ::= [a-z]+
+                |IfAgain          ::= "if"
+                |)"_multiline);
+
+    // literal rules are united into one trie, yet "IfAgain" is still reported as overshadowed
+    Compiler::OvershadowMap overshadows;
+    LexerDef ld = cc.compileMulti(&overshadows);
+    ASSERT_EQ(1, overshadows.size());
+    EXPECT_EQ(7, overshadows[0].first);
+    EXPECT_EQ(5, overshadows[0].second);
+
+    Lexable<Tag, StateId, false, false> ls { ld, "< <= << <<<= if iff" };
+    auto lexer = begin(ls);
+
+    ASSERT_EQ(2, *lexer);
+    ASSERT_EQ(3, *++lexer);
+    ASSERT_EQ(4, *++lexer);
+    ASSERT_EQ(4, *++lexer);
+    ASSERT_EQ(3, *++lexer);
+    ASSERT_EQ("<=", literal(lexer));
+    ASSERT_EQ(5, *++lexer);
+    ASSERT_EQ(6, *++lexer);
+    ASSERT_EQ("iff", literal(lexer));
+    ASSERT_EQ(1, *++lexer);
+}
+
+TEST(regular_Lexer, stats)
+{
+    Compiler cc;
+    cc.parse(RULES);
+
+    const LexerDef ld = cc.compile();
+    Lexable<LookaheadToken, StateId, false, false, true> ls { ld, "abba abcdef" };
+    auto lexer = begin(ls);
+    ASSERT_EQ(LookaheadToken::ABBA, *lexer);
+    ASSERT_EQ(LookaheadToken::AB_CD, *++lexer);
+    ASSERT_EQ(LookaheadToken::CDEF, *++lexer);
+    ASSERT_EQ(LookaheadToken::Eof, *++lexer);
+
+    // "ab/cd" scans up to "abcde" before rolling back to "ab"
+    const LexerStats& stats = lexer.stats();
+    EXPECT_EQ(4, stats.tokenCount());
+    EXPECT_EQ(1, stats.tokenCount(static_cast<Tag>(LookaheadToken::AB_CD)));
+    EXPECT_EQ(1, stats.ignoredTokens);
+    EXPECT_EQ(1, stats.rollbacks);
+    EXPECT_EQ(2, stats.longestLookahead);
+    // the lookahead symbols of each token are re-read, the end of file included
+    EXPECT_EQ(6, stats.rereads);
+    EXPECT_EQ(17, stats.bytesScanned);
+
+    Lexer<LookaheadToken, StateId, false, false, true> lexer2 { ld, "abba abcdef" };
+    while (lexer2.recognize() != LookaheadToken::Eof)
+        ;
+    EXPECT_EQ(stats.tokens, lexer2.stats().tokens);
+    EXPECT_EQ(stats.rereads, lexer2.stats().rereads);
+    EXPECT_EQ(stats.bytesScanned, lexer2.stats().bytesScanned);
+    EXPECT_EQ(fmt::format("{}", stats), fmt::format("{}", lexer2.stats()));
+
+    // disabled counters take no room beyond a placeholder
+    static_assert(is_same_v<const NoLexerStats&, decltype(begin(Lexable<Tag> { ld, "" }).stats())>);
+}
@@ -14,17 +14,30 @@ namespace klex::regular
 
 MultiDFA constructMultiDFA(map<string, DFA> many)
 {
+    // one slot for each initial state, with a begin-of-line initial state right after its condition's
+    size_t entries = 0;
+    for (const pair<const string, DFA>& p: many)
+        entries += p.second.beginOfLineState().has_value() ? 2 : 1;
+
     MultiDFA multiDFA {};
-    multiDFA.dfa.createStates(1 + many.size());
+    multiDFA.dfa.createStates(1 + entries);
     multiDFA.dfa.setInitialState(0);
 
     StateId q0 = 1;
     for (pair<const string, DFA>& p: many)
     {
+        const bool beginOfLine = p.second.beginOfLineState().has_value();
         multiDFA.dfa.append(move(p.second), q0);
         multiDFA.initialStates[p.first] = q0;
         multiDFA.dfa.setTransition(0, static_cast<Symbol>(q0), q0);
         q0++;
+
+        if (beginOfLine)
+        {
+            multiDFA.initialStates[p.first + "_0"] = q0;
+            multiDFA.dfa.setTransition(0, static_cast<Symbol>(q0), q0);
+            q0++;
+        }
     }
 
     return multiDFA;
@@ -12,7 +12,9 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
+#include <iterator>
 #include <stack>
 #include <vector>
 
@@ -166,6 +168,8 @@ void NFA::prepareStateIds(StateId baseId)
 
     initialState_ += baseId;
     acceptState_ += baseId;
+    if (beginOfLineState_.has_value())
+        *beginOfLineState_ += baseId;
 
     AcceptMap remapped;
     for (auto& a: acceptTags_)
@@ -252,6 +256,118 @@ NFA& NFA::alternate(NFA&& rhs)
     return *this;
 }
 
+NFA NFA::unite(vector<NFA>&& alternatives)
+{
+    assert(!alternatives.empty());
+
+    if (alternatives.size() == 1)
+        return move(alternatives.front());
+
+    size_t totalSize = 2;
+    for (const NFA& alternative: alternatives)
+        totalSize += alternative.size();
+
+    NFA result;
+    result.states_.reserve(totalSize);
+    result.initialState_ = result.createState();
+
+    for (NFA& alternative: alternatives)
+    {
+        assert(!alternative.beginOfLineState_.has_value());
+        result.embed(alternative);
+        result.addTransition(result.initialState_, Symbols::Epsilon, alternative.initialState_);
+    }
+
+    result.acceptState_ = result.createState();
+    for (const NFA& alternative: alternatives)
+        result.addTransition(alternative.acceptState_, Symbols::Epsilon, result.acceptState_);
+
+    return result;
+}
+
+NFA NFA::unite(vector<NFA>&& alternatives, vector<NFA>&& anchored)
+{
+    size_t totalSize = 3;
+    for (const NFA& alternative: alternatives)
+        totalSize += alternative.size();
+    for (const NFA& alternative: anchored)
+        totalSize += alternative.size();
+
+    NFA result;
+    result.states_.reserve(totalSize);
+    result.initialState_ = result.createState();
+    result.beginOfLineState_ = result.createState();
+    result.addTransition(*result.beginOfLineState_, Symbols::Epsilon, result.initialState_);
+
+    for (NFA& alternative: alternatives)
+    {
+        result.embed(alternative);
+        result.addTransition(result.initialState_, Symbols::Epsilon, alternative.initialState_);
+        if (alternative.beginOfLineState_.has_value())
+            result.addTransition(*result.beginOfLineState_, Symbols::Epsilon, *alternative.beginOfLineState_);
+    }
+
+    for (NFA& alternative: anchored)
+    {
+        assert(!alternative.beginOfLineState_.has_value());
+        result.embed(alternative);
+        result.addTransition(*result.beginOfLineState_, Symbols::Epsilon, alternative.initialState_);
+    }
+
+    result.acceptState_ = result.createState();
+    for (const NFA& alternative: alternatives)
+        result.addTransition(alternative.acceptState_, Symbols::Epsilon, result.acceptState_);
+    for (const NFA& alternative: anchored)
+        result.addTransition(alternative.acceptState_, Symbols::Epsilon, result.acceptState_);
+
+    return result;
+}
+
+void NFA::embed(NFA& other)
+{
+    other.prepareStateIds(size());
+    states_.insert(states_.end(),
+                   make_move_iterator(other.states_.begin()),
+                   make_move_iterator(other.states_.end()));
+    acceptTags_.insert(other.acceptTags_.begin(), other.acceptTags_.end());
+    backtrackStates_.insert(other.backtrackStates_.begin(), other.backtrackStates_.end());
+}
+
+NFA NFA::trie(const vector<pair<vector<Symbol>, Tag>>& literals)
+{
+    NFA trie;
+    trie.initialState_ = trie.createState();
+
+    vector<StateId> terminals;
+    terminals.reserve(literals.size());
+
+    for (const pair<vector<Symbol>, Tag>& literal: literals)
+    {
+        assert(!literal.first.empty());
+        StateId s = trie.initialState_;
+        for (Symbol c: literal.first)
+        {
+            if (auto i = trie.states_[s].find(c); i != trie.states_[s].end())
+                s = i->second.front();
+            else
+            {
+                const StateId t = trie.createState();
+                trie.addTransition(s, c, t);
+                s = t;
+            }
+        }
+        assert(!trie.isAccepting(s) && "Literals must be unique.");
+        trie.setAccept(s, literal.second);
+        terminals.push_back(s);
+    }
+
+    trie.acceptState_ = trie.createState();
+    for (StateId s: terminals)
+        trie.addTransition(s, Symbols::Epsilon, trie.acceptState_);
+
+    return trie;
+}
+
 NFA& NFA::concatenate(NFA&& rhs)
 {
     rhs.prepareStateIds(states_.size());
@@ -320,18 +436,33 @@ NFA& NFA::times(unsigned factor)
 
 NFA& NFA::repeat(unsigned minimum, unsigned maximum)
 {
-    assert(minimum <= maximum);
-
-    NFA factor = clone();
+    assert(minimum <= maximum && maximum != 0);
 
-    if (minimum != 0)
-        times(minimum);
+    // X{m,n} is constructed as a linear chain of n copies of X, where the first m copies are
+    // mandatory and each of the remaining accept states may leave the chain early:
+    //
+    //   X --> X --> ... X(m) --> X --> ... --> X(n)
+    //                     |       |              |
+    //                     `-------`--------------`----> newEnd
 
-    for (unsigned n = minimum + 1; n <= maximum; n++)
-        alternate(move(factor.clone().times(n)));
+    const NFA factor = clone();
 
+    StateIdVec exits;
     if (minimum == 0)
-        optional();
+        exits.push_back(initialState_);
+
+    for (unsigned n = 1; n < maximum; ++n)
+    {
+        if (n >= minimum)
+            exits.push_back(acceptState_);
+        concatenate(factor.clone());
+    }
+    exits.push_back(acceptState_);
+
+    const StateId newEnd = createState();
+    for (StateId exit: exits)
+        addTransition(exit, Symbols::Epsilon, newEnd);
+    acceptState_ = newEnd;
 
     return *this;
 }
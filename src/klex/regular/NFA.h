@@ -53,7 +53,10 @@ class NFA {
 	NFA& operator=(NFA&&) = default;
 
 	//! Constructs an empty NFA.
-	NFA() : states_{}, initialState_{0}, acceptState_{0}, backtrackStates_{}, acceptTags_{} {}
+	NFA()
+		: states_{}, initialState_{0}, beginOfLineState_{}, acceptState_{0}, backtrackStates_{}, acceptTags_{}
+	{
+	}
 
 	/**
 	 * Constructs an NFA for a single character transition.
@@ -79,6 +82,35 @@ class NFA {
 
 	static NFA join(const std::map<std::string, NFA>& mappings);
 
+	/**
+	 * Constructs the union of all given @p alternatives at once, in linear time.
+	 *
+	 * A single new initial state fans out to all alternatives' initial states via epsilon transitions
+	 * and all alternatives' accept states lead to a single new accept state. This is equivalent to,
+	 * but much flatter than, successively calling alternate() on each of them.
+	 */
+	static NFA unite(std::vector<NFA>&& alternatives);
+
+	/**
+	 * Constructs the union of all given @p alternatives, with an additional begin-of-line initial state.
+	 *
+	 * The begin-of-line initial state leads to the initial state as well as to all begin-of-line
+	 * @p anchored NFAs via epsilon transitions. That is, both initial states share all states
+	 * but those only reachable via anchored rules.
+	 * Alternatives that have a begin-of-line initial state of their own keep it reachable from the
+	 * new one.
+	 */
+	static NFA unite(std::vector<NFA>&& alternatives, std::vector<NFA>&& anchored);
+
+	/**
+	 * Constructs a trie that accepts each literal of @p literals with its associated tag.
+	 *
+	 * Literals sharing a common prefix share the states for that prefix, so that the trie is already
+	 * deterministic (apart from the epsilon transitions into its one and only accept state).
+	 * Each literal must be non-empty and unique.
+	 */
+	static NFA trie(const std::vector<std::pair<std::vector<Symbol>, Tag>>& literals);
+
 	/**
 	 * Traverses all states and edges in this NFA and calls @p visitor for each state & edge.
 	 *
@@ -95,6 +127,9 @@ class NFA {
 	//! Retrieves the one and only initial state. This value is nullptr iff the NFA is empty.
 	StateId initialStateId() const noexcept { return initialState_; }
 
+	//! Retrieves the initial state to start from at the beginning of a line, if any.
+	std::optional<StateId> beginOfLineStateId() const noexcept { return beginOfLineState_; }
+
 	//! Retrieves the one and only accept state. This value is nullptr iff the NFA is empty.
 	StateId acceptStateId() const noexcept { return acceptState_; }
 
@@ -206,12 +241,16 @@ class NFA {
 	void visit(DotVisitor& v, StateId s, std::unordered_map<StateId, size_t>& registry) const;
 	void prepareStateIds(StateId baseId);
 
+	//! Moves all states of @p other into this NFA, with @p other's state IDs adjusted accordingly.
+	void embed(NFA& other);
+
 	//! Retrieves all epsilon-transitions directly connected to State @p s.
 	StateIdVec epsilonTransitions(StateId s) const;
 
   private:
 	StateVec states_;
 	StateId initialState_;
+	std::optional<StateId> beginOfLineState_;
 	StateId acceptState_;
 	BacktrackingMap backtrackStates_;
 	AcceptMap acceptTags_;
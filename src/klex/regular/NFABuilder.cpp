@@ -43,17 +43,18 @@ void NFABuilder::operator()(const LookAheadExpr& lookaheadExpr)
 
 void NFABuilder::operator()(const AlternationExpr& alternationExpr)
 {
-    NFA lhs = construct(*alternationExpr.left);
-    NFA rhs = construct(*alternationExpr.right);
-    lhs.alternate(move(rhs));
-    fa_ = move(lhs);
+    vector<NFA> alternatives;
+    alternatives.reserve(alternationExpr.subExprs.size());
+    for (const RegExpr* subExpr: alternationExpr.subExprs)
+        alternatives.emplace_back(construct(*subExpr));
+    fa_ = NFA::unite(move(alternatives));
 }
 
 void NFABuilder::operator()(const ConcatenationExpr& concatenationExpr)
 {
-    NFA lhs = construct(*concatenationExpr.left);
-    NFA rhs = construct(*concatenationExpr.right);
-    lhs.concatenate(move(rhs));
+    NFA lhs = construct(*concatenationExpr.subExprs.front());
+    for (size_t i = 1; i < concatenationExpr.subExprs.size(); ++i)
+        lhs.concatenate(construct(*concatenationExpr.subExprs[i]));
     fa_ = move(lhs);
 }
 
@@ -79,10 +80,30 @@ void NFABuilder::operator()(const ClosureExpr& closureExpr)
         fa_ = move(construct(*closureExpr.subExpr).recurring());
     else if (xmin == 1 && xmax == Infinity)
         fa_ = move(construct(*closureExpr.subExpr).positive());
-    else if (xmin < xmax)
-        fa_ = move(construct(*closureExpr.subExpr).repeat(xmin, xmax));
-    else if (xmin == xmax)
-        fa_ = move(construct(*closureExpr.subExpr).times(xmin));
+    else if (xmin <= xmax)
+    {
+        // The sub-expression is constructed only once and then cloned into each of the copies.
+        NFA factor = construct(*closureExpr.subExpr);
+
+        const size_t copies = xmax != Infinity ? xmax : xmin + 1;
+        const size_t expected = factor.size() * copies + 2;
+        if (expected > expansionLimit_)
+        {
+            string expr = fmt::format("({}){{{},{}}}", to_string(*closureExpr.subExpr), xmin, xmax);
+            throw ExcessiveExpansion { move(expr), expected, expansionLimit_ };
+        }
+
+        if (xmax == Infinity) // X{m,} := X{m-1}X+
+        {
+            NFA head = factor.clone();
+            head.times(xmin - 1);
+            fa_ = move(head.concatenate(move(factor.positive())));
+        }
+        else if (xmin == xmax)
+            fa_ = move(factor.times(xmin));
+        else
+            fa_ = move(factor.repeat(xmin, xmax));
+    }
     else
         throw invalid_argument { "closureExpr" };
 }
@@ -15,6 +15,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <stdexcept>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -28,7 +29,15 @@ class DFA;
  */
 class NFABuilder {
   public:
-	explicit NFABuilder() : fa_{} {}
+	//! Default upper bound of NFA states a single counted repetition (X{m,n}) may expand to.
+	static constexpr size_t DefaultExpansionLimit = 100000;
+
+	class ExcessiveExpansion;
+
+	explicit NFABuilder(size_t expansionLimit = DefaultExpansionLimit)
+		: fa_{}, expansionLimit_{expansionLimit}
+	{
+	}
 
 	NFA construct(const RegExpr& re, Tag tag);
 	NFA construct(const RegExpr& re);
@@ -47,6 +56,32 @@ class NFABuilder {
   private:
 	NFA fa_;
 	std::optional<StateId> acceptState_;
+	size_t expansionLimit_;
+};
+
+/**
+ * Thrown when a counted repetition would expand into more NFA states than permitted.
+ */
+class NFABuilder::ExcessiveExpansion : public std::runtime_error {
+  public:
+	ExcessiveExpansion(std::string expr, size_t expectedStates, size_t limit)
+		: std::runtime_error{fmt::format(
+			  "Counted repetition {} would expand to {} NFA states, exceeding the limit of {}.", expr,
+			  expectedStates, limit)},
+		  expr_{std::move(expr)},
+		  expectedStates_{expectedStates},
+		  limit_{limit}
+	{
+	}
+
+	const std::string& expr() const noexcept { return expr_; }
+	size_t expectedStates() const noexcept { return expectedStates_; }
+	size_t limit() const noexcept { return limit_; }
+
+  private:
+	std::string expr_;
+	size_t expectedStates_;
+	size_t limit_;
 };
 
 }  // namespace klex::regular
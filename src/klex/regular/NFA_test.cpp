@@ -7,9 +7,13 @@
 
 #include <klex/regular/Alphabet.h>
 #include <klex/regular/NFA.h>
+#include <klex/regular/NFABuilder.h>
+#include <klex/regular/RegExprParser.h>
 #include <klex/regular/State.h>
 #include <klex/util/testing.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace klex::regular;
 
@@ -81,3 +85,105 @@ TEST(regular_NFA, alphabet)
     ASSERT_EQ("{ab}", NFA { 'a' }.concatenate(NFA { 'b' }).alphabet().to_string());
     ASSERT_EQ("{abc}", NFA { 'a' }.concatenate(NFA { 'b' }).alternate(NFA { 'c' }).alphabet().to_string());
 }
+
+TEST(regular_NFA, repeat)
+{
+    // linear chain of 4 copies (2 states each) plus one shared exit state
+    const NFA a24 = move(NFA { 'a' }.repeat(2, 4));
+    ASSERT_EQ(9, a24.size());
+    EXPECT_EQ(8, a24.acceptStateId());
+    EXPECT_EQ((StateIdVec { 1, 2 }), a24.epsilonClosure(StateIdVec { 1 })); // 1st copy is mandatory
+    EXPECT_EQ((StateIdVec { 3, 4, 8 }), a24.epsilonClosure(StateIdVec { 3 })); // 2nd copy may exit
+
+    const NFA a1000 = move(NFA { 'a' }.repeat(1, 1000));
+    ASSERT_EQ(2001, a1000.size());
+
+    const NFA a03 = move(NFA { 'a' }.repeat(0, 3));
+    const StateIdVec q0 = a03.epsilonClosure(StateIdVec { a03.initialStateId() });
+    EXPECT_TRUE(find(q0.begin(), q0.end(), a03.acceptStateId()) != q0.end());
+}
+
+TEST(regular_NFABuilder, excessiveExpansion)
+{
+    EXPECT_EQ(2001, NFABuilder {}.construct(*RegExprParser {}.parse("x{1,1000}")).size());
+    EXPECT_THROW(NFABuilder { 1000 }.construct(*RegExprParser {}.parse("x{1,1000}")),
+                 NFABuilder::ExcessiveExpansion);
+    EXPECT_THROW(NFABuilder {}.construct(*RegExprParser {}.parse("(x{1,1000}){1,1000}")),
+                 NFABuilder::ExcessiveExpansion);
+}
+
+TEST(regular_NFA, unite)
+{
+    vector<NFA> alternatives;
+    for (Symbol ch: { 'a', 'b', 'c' })
+    {
+        NFA nfa { ch };
+        nfa.setAccept(static_cast<Tag>(ch));
+        alternatives.emplace_back(move(nfa));
+    }
+
+    const NFA nfa = NFA::unite(move(alternatives));
+    ASSERT_EQ(8, nfa.size());
+    EXPECT_EQ(0, nfa.initialStateId());
+    EXPECT_EQ(7, nfa.acceptStateId());
+
+    // one single fan-out state right into each alternative
+    const StateIdVec q0 = nfa.epsilonClosure(StateIdVec { nfa.initialStateId() });
+    EXPECT_EQ(4, q0.size());
+    EXPECT_EQ((StateIdVec { 4 }), nfa.delta(q0, 'b'));
+    EXPECT_EQ('b', nfa.acceptTag(4).value_or(0));
+}
+
+TEST(regular_NFA, unite_with_begin_of_line)
+{
+    vector<NFA> alternatives;
+    alternatives.emplace_back(NFA { 'a' });
+    alternatives.emplace_back(NFA { 'b' });
+    vector<NFA> anchored;
+    anchored.emplace_back(NFA { 'c' });
+
+    const NFA nfa = NFA::unite(move(alternatives), move(anchored));
+    ASSERT_EQ(9, nfa.size());
+    ASSERT_TRUE(nfa.beginOfLineStateId().has_value());
+
+    // the begin-of-line initial state shares everything but the anchored alternative
+    const StateIdVec q0 = nfa.epsilonClosure(StateIdVec { nfa.initialStateId() });
+    const StateIdVec q0bol = nfa.epsilonClosure(StateIdVec { *nfa.beginOfLineStateId() });
+    EXPECT_EQ(nfa.delta(q0, 'a'), nfa.delta(q0bol, 'a'));
+    EXPECT_EQ(nfa.delta(q0, 'b'), nfa.delta(q0bol, 'b'));
+    EXPECT_EQ(0, nfa.delta(q0, 'c').size());
+    EXPECT_EQ(1, nfa.delta(q0bol, 'c').size());
+}
+
+TEST(regular_NFA, trie)
+{
+    const NFA trie = NFA::trie({ { { 'i', 'f' }, 1 }, { { 'i', 'n' }, 2 }, { { 'i', 'n', 't' }, 3 } });
+
+    // initial, i, if, in, int, and the one accept state
+    ASSERT_EQ(6, trie.size());
+    EXPECT_EQ(0, trie.initialStateId());
+    EXPECT_EQ(5, trie.acceptStateId());
+
+    const StateIdVec i = trie.delta(StateIdVec { trie.initialStateId() }, 'i');
+    ASSERT_EQ(1, i.size());
+    EXPECT_EQ(1, trie.acceptTag(trie.delta(i, 'f').front()).value_or(0));
+    EXPECT_EQ(2, trie.acceptTag(trie.delta(i, 'n').front()).value_or(0));
+    EXPECT_EQ(3, trie.acceptTag(trie.delta(trie.delta(i, 'n'), 't').front()).value_or(0));
+}
+
+// ############################################################################
+
+class regular_NFA_closure : public klex::util::testing::Benchmark {
+  public:
+    regular_NFA_closure() : nfa_ { NFABuilder {}.construct(*RegExprParser {}.parse("(a|b*|c?d){1,32}")) } {}
+
+  protected:
+    const NFA nfa_;
+    StateIdVec closure_;
+};
+
+BENCHMARK_F(regular_NFA_closure, epsilonClosure)
+{
+    nfa_.epsilonClosure(StateIdVec { nfa_.initialStateId() }, &closure_);
+    klex::util::testing::doNotOptimize(closure_);
+}
@@ -0,0 +1,323 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/DFA.h>
+#include <klex/regular/PositionDFABuilder.h>
+#include <klex/util/overloaded.h>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <limits>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+/* Direct DFA construction visualization
+  REGEX:      a(b|c)*
+
+  AUGMENTED:  a(b|c)*#       (# is the accept marker for the rule's tag)
+
+  POSITIONS:  1=a  2=b  3=c  4=#
+
+  FOLLOWPOS:  1: {2,3,4}
+              2: {2,3,4}
+              3: {2,3,4}
+              4: {}
+
+  DFA:        d0 = {1}        --(a)--> d1
+              d1 = {2,3,4}    --(b)--> d1, --(c)--> d1   (accepting, contains #)
+*/
+
+namespace
+{
+    using PositionSet = vector<size_t>;
+
+    void merge(PositionSet& target, const PositionSet& source)
+    {
+        PositionSet result;
+        result.reserve(target.size() + source.size());
+        set_union(target.begin(), target.end(), source.begin(), source.end(), back_inserter(result));
+        target = move(result);
+    }
+} // namespace
+
+PositionDFABuilder::PositionDFABuilder(bool beginOfLine):
+    symbols_ {},
+    followpos_ {},
+    initial_ {},
+    beginOfLine_ { beginOfLine ? std::optional<PositionSet> { PositionSet {} } : nullopt },
+    acceptPositions_ {},
+    backtrackPositions_ {}
+{
+}
+
+void PositionDFABuilder::declare(const RegExpr& re, Tag tag)
+{
+    Node accept = createMarker();
+    acceptPositions_[accept.firstpos.front()] = tag;
+
+    const Node rule = concatenate(build(re), move(accept));
+    if (!beginOfLine_.has_value() || !containsBeginOfLine(re))
+        merge(initial_, rule.firstpos);
+    if (beginOfLine_.has_value())
+        merge(*beginOfLine_, rule.firstpos);
+}
+
+PositionDFABuilder::Node PositionDFABuilder::build(const RegExpr& re)
+{
+    return visit(overloaded {
+                     [&](const LookAheadExpr& e) {
+                         // r/s := r <marker> s <marker>, with backtracking from the latter to the former.
+                         Node lhs = build(*e.left);
+                         Node begin = createMarker();
+                         const Position beginPos = begin.firstpos.front();
+                         Node rhs = build(*e.right);
+                         Node end = createMarker();
+                         backtrackPositions_[end.firstpos.front()] = beginPos;
+                         return concatenate(concatenate(concatenate(move(lhs), move(begin)), move(rhs)),
+                                            move(end));
+                     },
+                     [&](const AlternationExpr& e) {
+                         Node result = build(*e.subExprs.front());
+                         for (size_t i = 1; i < e.subExprs.size(); ++i)
+                             result = alternate(move(result), build(*e.subExprs[i]));
+                         return result;
+                     },
+                     [&](const ConcatenationExpr& e) {
+                         Node result = build(*e.subExprs.front());
+                         for (size_t i = 1; i < e.subExprs.size(); ++i)
+                             result = concatenate(move(result), build(*e.subExprs[i]));
+                         return result;
+                     },
+                     [&](const ClosureExpr& e) { return buildClosure(e); },
+                     [&](const CharacterExpr& e) { return createPosition({ e.value }); },
+                     [&](const CharacterClassExpr& e) {
+                         vector<Symbol> symbols;
+                         symbols.reserve(e.symbols.size());
+                         for (Symbol s: e.symbols)
+                             symbols.push_back(s);
+                         return createPosition(move(symbols));
+                     },
+                     [&](const DotExpr&) {
+                         // any character except LF (see NFABuilder)
+                         vector<Symbol> symbols { '\t' };
+                         for (Symbol ch = 32; ch < 127; ++ch)
+                             symbols.push_back(ch);
+                         return createPosition(move(symbols));
+                     },
+                     [&](const EndOfLineExpr&) {
+                         // $ := <marker> \n <marker>, i.e. an empty lookahead on LF.
+                         Node begin = createMarker();
+                         const Position beginPos = begin.firstpos.front();
+                         Node lf = createPosition({ '\n' });
+                         Node end = createMarker();
+                         backtrackPositions_[end.firstpos.front()] = beginPos;
+                         return concatenate(concatenate(move(begin), move(lf)), move(end));
+                     },
+                     [&](const EndOfFileExpr&) { return createPosition({ Symbols::EndOfFile }); },
+                     // begin-of-line is dealt with by the begin-of-line initial state, hence epsilon here
+                     [](const BeginOfLineExpr&) { return Node { true, {}, {} }; },
+                     [](const EmptyExpr&) { return Node { true, {}, {} }; },
+                 },
+                 re);
+}
+
+PositionDFABuilder::Node PositionDFABuilder::buildClosure(const ClosureExpr& e)
+{
+    constexpr unsigned Infinity = numeric_limits<unsigned>::max();
+
+    if (e.minimumOccurrences > e.maximumOccurrences)
+        throw invalid_argument { "closureExpr" };
+
+    Node result { true, {}, {} };
+    for (unsigned n = 0; n < e.minimumOccurrences; ++n)
+        result = concatenate(move(result), build(*e.subExpr));
+
+    if (e.maximumOccurrences == Infinity)
+        return concatenate(move(result), recurring(build(*e.subExpr)));
+
+    // X{0,k} := (X(X(...)?)?)?, keeping followpos linear in k.
+    Node tail { true, {}, {} };
+    for (unsigned n = e.minimumOccurrences; n < e.maximumOccurrences; ++n)
+    {
+        Node head = build(*e.subExpr);
+        tail = optional(concatenate(move(head), move(tail)));
+    }
+
+    return concatenate(move(result), move(tail));
+}
+
+PositionDFABuilder::Node PositionDFABuilder::createPosition(vector<Symbol> symbols)
+{
+    const Position p = symbols_.size();
+    symbols_.emplace_back(move(symbols));
+    followpos_.emplace_back();
+    return Node { false, { p }, { p } };
+}
+
+PositionDFABuilder::Node PositionDFABuilder::createMarker()
+{
+    Node marker = createPosition({});
+    marker.nullable = true;
+    return marker;
+}
+
+PositionDFABuilder::Node PositionDFABuilder::concatenate(Node lhs, Node rhs)
+{
+    for (Position p: lhs.lastpos)
+        merge(followpos_[p], rhs.firstpos);
+
+    if (lhs.nullable)
+        merge(lhs.firstpos, rhs.firstpos);
+
+    if (rhs.nullable)
+        merge(rhs.lastpos, lhs.lastpos);
+
+    return Node { lhs.nullable && rhs.nullable, move(lhs.firstpos), move(rhs.lastpos) };
+}
+
+PositionDFABuilder::Node PositionDFABuilder::alternate(Node lhs, Node rhs)
+{
+    merge(lhs.firstpos, rhs.firstpos);
+    merge(lhs.lastpos, rhs.lastpos);
+    return Node { lhs.nullable || rhs.nullable, move(lhs.firstpos), move(lhs.lastpos) };
+}
+
+PositionDFABuilder::Node PositionDFABuilder::recurring(Node node)
+{
+    for (Position p: node.lastpos)
+        merge(followpos_[p], node.firstpos);
+
+    node.nullable = true;
+    return node;
+}
+
+PositionDFABuilder::Node PositionDFABuilder::optional(Node node)
+{
+    node.nullable = true;
+    return node;
+}
+
+DFA PositionDFABuilder::construct(OvershadowMap* overshadows)
+{
+    vector<PositionSet> Q = { initial_ }; // resulting states
+    map<PositionSet, StateId> configurations = { { initial_, 0 } };
+    deque<StateId> workList = { 0 };
+    vector<map<Symbol, StateId>> T(1);
+
+    // The begin-of-line initial state (if any) becomes d_1, even if no anchored expression has been
+    // declared, as the lexer addresses it relative to d_0.
+    if (beginOfLine_.has_value())
+    {
+        Q.emplace_back(*beginOfLine_);
+        configurations.emplace(*beginOfLine_, 1);
+        workList.push_back(1);
+        T.emplace_back();
+    }
+
+    while (!workList.empty())
+    {
+        const StateId q_i = workList.front();
+        workList.pop_front();
+
+        // union of followpos(p) for all p in q that consume c
+        map<Symbol, PositionSet> delta;
+        for (Position p: Q[q_i])
+            for (Symbol c: symbols_[p])
+                merge(delta[c], followpos_[p]);
+
+        for (pair<const Symbol, PositionSet>& t: delta)
+        {
+            if (auto i = configurations.find(t.second); i != configurations.end())
+                T[q_i][t.first] = i->second;
+            else
+            {
+                const StateId t_i = Q.size();
+                configurations.emplace(t.second, t_i);
+                Q.emplace_back(move(t.second));
+                T.emplace_back();
+                T[q_i][t.first] = t_i;
+                workList.push_back(t_i);
+            }
+        }
+    }
+
+    DFA dfa;
+    dfa.createStates(Q.size());
+
+    // marker position to (last) DFA state containing it, used as backtracking target
+    map<Position, StateId> remaps;
+    for (StateId q_i = 0, qE = Q.size(); q_i != qE; ++q_i)
+        for (Position p: Q[q_i])
+            if (symbols_[p].empty())
+                remaps[p] = q_i;
+
+    map<Tag, Tag> overshadowing;
+    for (StateId q_i = 0, qE = Q.size(); q_i != qE; ++q_i)
+    {
+        if (std::optional<Tag> tag = determineTag(Q[q_i], &overshadowing); tag.has_value())
+            dfa.setAccept(q_i, *tag);
+
+        for (Position p: Q[q_i])
+        {
+            if (auto bt = backtrackPositions_.find(p); bt != backtrackPositions_.end())
+            {
+                assert(dfa.isAccepting(q_i));
+                dfa.setBacktrack(q_i, remaps[bt->second]);
+                break;
+            }
+        }
+
+        for (const pair<const Symbol, StateId>& t: T[q_i])
+            dfa.setTransition(q_i, t.first, t.second);
+    }
+
+    dfa.setInitialState(0);
+    if (beginOfLine_.has_value())
+        dfa.setBeginOfLineState(1);
+
+    if (overshadows)
+    {
+        // check if tag is an acceptor in any rule but not in DFA, hence, it was overshadowed by another rule
+        for (const pair<const Position, Tag>& a: acceptPositions_)
+        {
+            const Tag tag = a.second;
+            if (!dfa.isAcceptor(tag))
+                if (auto i = overshadowing.find(tag); i != overshadowing.end())
+                    overshadows->emplace_back(tag, i->second);
+        }
+    }
+
+    return dfa;
+}
+
+optional<Tag> PositionDFABuilder::determineTag(const PositionSet& q, map<Tag, Tag>* overshadows) const
+{
+    std::optional<Tag> lowestTag;
+    vector<Tag> tags;
+
+    for (Position p: q)
+    {
+        if (auto i = acceptPositions_.find(p); i != acceptPositions_.end())
+        {
+            tags.push_back(i->second);
+            if (!lowestTag.has_value() || i->second < *lowestTag)
+                lowestTag = i->second;
+        }
+    }
+
+    for (Tag tag: tags)
+        if (tag != *lowestTag)
+            (*overshadows)[tag] = *lowestTag; // {tag} is overshadowed by {lowestTag}
+
+    return lowestTag;
+}
+
+} // namespace klex::regular
@@ -0,0 +1,103 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/DFABuilder.h>
+#include <klex/regular/RegExpr.h>
+#include <klex/regular/State.h>
+
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace klex::regular {
+
+class DFA;
+
+/**
+ * Constructs a DFA directly from a set of regular expressions (position automaton).
+ *
+ * Each leaf of the RegExpr tree that consumes input becomes a position. The DFA states are sets
+ * of positions, connected via the followpos relation (Glushkov construction, Dragon book, 3.9).
+ * No intermediate NFA is built and therefore no epsilon-closures are ever computed.
+ *
+ * Accepting, lookahead and end-of-line boundaries are represented as non-consuming marker
+ * positions, so that the resulting DFA carries the same accept tags and backtracking information
+ * as one built via NFABuilder and DFABuilder. Begin-of-line is represented, just like there, by a
+ * second initial state that additionally leads to the expressions anchored at the beginning of a line.
+ */
+class PositionDFABuilder {
+  public:
+	using OvershadowMap = DFABuilder::OvershadowMap;
+
+	/**
+	 * @param beginOfLine whether the DFA gets a begin-of-line initial state (d_1), next to its
+	 *                    initial state (d_0) that does not lead to the anchored expressions.
+	 */
+	explicit PositionDFABuilder(bool beginOfLine = false);
+
+	/**
+	 * Declares the regular expression @p re to be recognized and accepted as @p tag.
+	 */
+	void declare(const RegExpr& re, Tag tag);
+
+	/**
+	 * Constructs a DFA out of all declared regular expressions.
+	 *
+	 * @param overshadows if not nullptr, it will be used to store semantic information about
+	 *                    which rule tags have been overshadowed by which.
+	 */
+	DFA construct(OvershadowMap* overshadows = nullptr);
+
+	//! Retrieves the number of positions (including markers) created so far.
+	size_t size() const noexcept { return symbols_.size(); }
+
+  private:
+	using Position = size_t;
+	using PositionSet = std::vector<Position>;
+
+	//! Attributes of a (sub-)expression as used by the followpos construction.
+	struct Node {
+		bool nullable;
+		PositionSet firstpos;
+		PositionSet lastpos;
+	};
+
+	Node build(const RegExpr& re);
+	Node buildClosure(const ClosureExpr& closure);
+
+	Node createPosition(std::vector<Symbol> symbols);
+	Node createMarker();
+
+	Node concatenate(Node lhs, Node rhs);
+	static Node alternate(Node lhs, Node rhs);
+	Node recurring(Node node);
+	static Node optional(Node node);
+
+	std::optional<Tag> determineTag(const PositionSet& q, std::map<Tag, Tag>* overshadows) const;
+
+  private:
+	//! input symbols each position consumes, empty for marker positions
+	std::vector<std::vector<Symbol>> symbols_;
+
+	//! followpos(p) for each position p
+	std::vector<PositionSet> followpos_;
+
+	//! union of firstpos of all declared expressions (except the anchored ones, if beginOfLine_ is set)
+	PositionSet initial_;
+
+	//! union of firstpos of all declared expressions, if a begin-of-line initial state is to be built
+	std::optional<PositionSet> beginOfLine_;
+
+	//! marker positions that denote the end of a rule
+	std::map<Position, Tag> acceptPositions_;
+
+	//! maps the marker at the end of a lookahead to the marker at its beginning
+	std::map<Position, Position> backtrackPositions_;
+};
+
+}  // namespace klex::regular
@@ -0,0 +1,127 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/DFA.h>
+#include <klex/regular/DFAMinimizer.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/regular/PositionDFABuilder.h>
+#include <klex/regular/RegExprParser.h>
+#include <klex/regular/test_util.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+using Construction = Compiler::DFAConstruction;
+
+namespace
+{
+    LexerDef compileWith(Construction construction, const string& rules)
+    {
+        Compiler cc { construction };
+        cc.parse(rules);
+        return cc.compileMulti();
+    }
+} // namespace
+
+TEST(regular_PositionDFABuilder, simple)
+{
+    PositionDFABuilder builder;
+    builder.declare(*RegExprParser {}.parse("a(b|c)*"), 1);
+    DFA dfa = builder.construct();
+
+    // {1} --a--> {2,3,#} --b,c--> {2,3,#}
+    ASSERT_EQ(2, dfa.size());
+    EXPECT_FALSE(dfa.isAccepting(0));
+    EXPECT_TRUE(dfa.isAccepting(1));
+    EXPECT_EQ(1, dfa.delta(0, 'a').value_or(ErrorState));
+    EXPECT_EQ(1, dfa.delta(1, 'b').value_or(ErrorState));
+    EXPECT_EQ(1, dfa.delta(1, 'c').value_or(ErrorState));
+}
+
+TEST(regular_PositionDFABuilder, shadowing)
+{
+    Compiler cc { Construction::PositionAutomaton };
+    cc.parse(make_unique<stringstream>(R"(
+    Identifier  ::= [a-z][a-z0-9]*
+    TrueLiteral ::= "true"
+  )"));
+    // rule 2 is overshadowed by rule 1
+    Compiler::OvershadowMap overshadows;
+    DFA dfa = cc.compileDFA(&overshadows);
+    ASSERT_EQ(1, overshadows.size());
+    EXPECT_EQ(2, overshadows[0].first);  // overshadowee
+    EXPECT_EQ(1, overshadows[0].second); // overshadower
+}
+
+TEST(regular_PositionDFABuilder, minimal_dfa_equivalence)
+{
+    const string rules = R"(|Spacing(ignore)  ::= [\s\t\n]+
+                            |Eof              ::= <<EOF>>
+                            |If               ::= if
+                            |Int              ::= int
+                            |Ident            ::= [a-z][a-z0-9]*
+                            |Number           ::= [0-9]{1,4}
+                            |String           ::= \"[^\"]*\"
+                            |)"_multiline;
+
+    Compiler subset { Construction::SubsetConstruction };
+    subset.parse(rules);
+    Compiler direct { Construction::PositionAutomaton };
+    direct.parse(rules);
+
+    EXPECT_EQ(subset.compileMinimalDFA().size(), direct.compileMinimalDFA().size());
+}
+
+TEST(regular_PositionDFABuilder, lexing_equivalence)
+{
+    expectSameTokens(compileWith(Construction::SubsetConstruction, sampleRules),
+                     compileWith(Construction::PositionAutomaton, sampleRules),
+                     sampleInput);
+
+    // any character but LF
+    const string rules = R"(|Spacing(ignore)  ::= [\s\t\n]+
+                            |Eof              ::= <<EOF>>
+                            |XAnyLine         ::= x.*
+                            |)"_multiline;
+    expectSameTokens(compileWith(Construction::SubsetConstruction, rules),
+                     compileWith(Construction::PositionAutomaton, rules),
+                     "xyz\n x 1\t2\n");
+}
+
+TEST(regular_PositionDFABuilder, begin_of_line_initial_states)
+{
+    const string rules = R"(|Spacing(ignore)  ::= [\s\t\n]+
+                            |Eof              ::= <<EOF>>
+                            |Pragma           ::= ^pragma
+                            |Ident            ::= [a-z]+
+                            |<A>Jump          ::= jmp
+                            |<AB>Call         ::= call
+                            |)"_multiline;
+
+    // same shape of initial states as via subset construction, a begin-of-line one right after each
+    const LexerDef expected = compileWith(Construction::SubsetConstruction, rules);
+    const LexerDef actual = compileWith(Construction::PositionAutomaton, rules);
+    EXPECT_TRUE(expected.initialStates == actual.initialStates);
+    EXPECT_EQ(actual.initialStates.at("A") + 1, actual.initialStates.at("A_0"));
+    EXPECT_EQ(actual.initialStates.at("AB") + 1, actual.initialStates.at("AB_0"));
+    EXPECT_EQ(actual.initialStates.at("INITIAL") + 1, actual.initialStates.at("INITIAL_0"));
+
+    // only the begin-of-line initial state leads to the anchored rule
+    const StateId q0 = actual.initialStates.at("INITIAL");
+    EXPECT_TRUE(actual.transitions.apply(q0 + 1, 'p') != actual.transitions.apply(q0, 'p'));
+
+    const string input = "pragma x\npragma";
+    expectSameTokens(expected, actual, input);
+}
@@ -10,6 +10,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <sstream>
@@ -57,8 +58,18 @@ std::string to_string(const RegExpr& re)
                     sstr << '{' << e.minimumOccurrences << ',' << e.maximumOccurrences << '}';
                 return sstr.str();
             },
-            [&](const AlternationExpr& e) { return embrace(re, *e.left) + "|" + embrace(re, *e.right); },
-            [&](const ConcatenationExpr& e) { return embrace(re, *e.left) + embrace(re, *e.right); },
+            [&](const AlternationExpr& e) {
+                string s = embrace(re, *e.subExprs.front());
+                for (size_t i = 1; i < e.subExprs.size(); ++i)
+                    s += "|" + embrace(re, *e.subExprs[i]);
+                return s;
+            },
+            [&](const ConcatenationExpr& e) {
+                string s;
+                for (const RegExpr* subExpr: e.subExprs)
+                    s += embrace(re, *subExpr);
+                return s;
+            },
             [&](const LookAheadExpr& e) { return embrace(re, *e.left) + "/" + embrace(re, *e.right); },
             [](const CharacterExpr& e) { return string(1, e.value); },
             [](const EndOfFileExpr& e) { return string { "<<EOF>>" }; },
@@ -93,14 +104,16 @@ bool containsBeginOfLine(const RegExpr& regex)
 {
     return visit(overloaded {
                      [](const AlternationExpr& e) {
-                         return containsBeginOfLine(*e.left) || containsBeginOfLine(*e.right);
+                         return any_of(e.subExprs.begin(), e.subExprs.end(),
+                                       [](const RegExpr* x) { return containsBeginOfLine(*x); });
                      },
                      [](const BeginOfLineExpr& e) { return true; },
                      [](const CharacterClassExpr& e) { return false; },
                      [](const CharacterExpr& e) { return false; },
                      [](const ClosureExpr& e) { return containsBeginOfLine(*e.subExpr); },
                      [](const ConcatenationExpr& e) {
-                         return containsBeginOfLine(*e.left) || containsBeginOfLine(*e.right);
+                         return any_of(e.subExprs.begin(), e.subExprs.end(),
+                                       [](const RegExpr* x) { return containsBeginOfLine(*x); });
                      },
                      [](const DotExpr& e) { return false; },
                      [](const EmptyExpr& e) { return false; },
@@ -113,4 +126,24 @@ bool containsBeginOfLine(const RegExpr& regex)
                  regex);
 }
 
+optional<vector<Symbol>> literalOf(const RegExpr& regex)
+{
+    if (const CharacterExpr* e = get_if<CharacterExpr>(&regex); e != nullptr)
+        return vector<Symbol> { e->value };
+
+    const ConcatenationExpr* e = get_if<ConcatenationExpr>(&regex);
+    if (e == nullptr)
+        return nullopt;
+
+    vector<Symbol> literal;
+    for (const RegExpr* subExpr: e->subExprs)
+    {
+        optional<vector<Symbol>> s = literalOf(*subExpr);
+        if (!s.has_value())
+            return nullopt;
+        literal.insert(literal.end(), s->begin(), s->end());
+    }
+    return literal;
+}
+
 } // namespace klex::regular
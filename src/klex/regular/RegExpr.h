@@ -8,12 +8,16 @@
 
 #include <klex/regular/Symbols.h>
 
+#include <deque>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -33,23 +37,28 @@ struct LookAheadExpr;
 
 using RegExpr = std::variant<AlternationExpr, BeginOfLineExpr, CharacterClassExpr, CharacterExpr, ClosureExpr, ConcatenationExpr, DotExpr, EmptyExpr, EndOfFileExpr, EndOfLineExpr, LookAheadExpr>;
 
+//! Shared, immutable handle to a RegExpr tree's root node, keeping its RegExprArena alive.
+using RegExprPtr = std::shared_ptr<const RegExpr>;
+
+// Child nodes are referenced by plain pointers, they are owned by the RegExprArena they were created in.
+
 struct LookAheadExpr {
-	std::unique_ptr<RegExpr> left;
-	std::unique_ptr<RegExpr> right;
+	const RegExpr* left;
+	const RegExpr* right;
 };
 
+//! n-ary alternation (a|b|c...), with at least two alternatives.
 struct AlternationExpr {
-	std::unique_ptr<RegExpr> left;
-	std::unique_ptr<RegExpr> right;
+	std::vector<const RegExpr*> subExprs;
 };
 
+//! n-ary concatenation (abc...), with at least two factors.
 struct ConcatenationExpr {
-	std::unique_ptr<RegExpr> left;
-	std::unique_ptr<RegExpr> right;
+	std::vector<const RegExpr*> subExprs;
 };
 
 struct ClosureExpr {
-	std::unique_ptr<RegExpr> subExpr;
+	const RegExpr* subExpr;
 	unsigned minimumOccurrences {0};
 	unsigned maximumOccurrences {std::numeric_limits<unsigned>::max()};
 };
@@ -68,8 +77,33 @@ struct EndOfLineExpr {};
 struct EndOfFileExpr {};
 struct EmptyExpr {};
 
+/**
+ * Owns all nodes of one or more RegExpr trees.
+ *
+ * Nodes are never moved nor modified once created, so they can be referenced by plain pointers
+ * and the whole tree can be shared by any number of owners (see RegExprPtr) without deep copies.
+ * Destruction is flat, too, regardless of how deeply the tree is nested.
+ */
+class RegExprArena {
+  public:
+	template <typename Expr>
+	const RegExpr* create(Expr&& expr)
+	{
+		return &nodes_.emplace_back(std::forward<Expr>(expr));
+	}
+
+	//! Retrieves the number of nodes allocated in this arena.
+	size_t size() const noexcept { return nodes_.size(); }
+
+  private:
+	std::deque<RegExpr> nodes_;
+};
+
 std::string to_string(const RegExpr& regex);
 int precedence(const RegExpr& regex);
 bool containsBeginOfLine(const RegExpr& regex);
 
+//! Retrieves the sequence of characters @p regex matches if it is a plain literal, std::nullopt otherwise.
+std::optional<std::vector<Symbol>> literalOf(const RegExpr& regex);
+
 }  // namespace klex::regular
@@ -54,7 +54,7 @@ using namespace std;
 namespace klex::regular
 {
 
-RegExprParser::RegExprParser(): input_ {}, currentChar_ { input_.end() }, line_ { 1 }, column_ { 0 }
+RegExprParser::RegExprParser(): arena_ {}, input_ {}, currentChar_ { input_.end() }, line_ { 1 }, column_ { 0 }
 {
 }
 
@@ -105,73 +105,77 @@ void RegExprParser::consume(int expected)
     }
 }
 
-RegExpr RegExprParser::parse(string_view expr, int line, int column)
+RegExprPtr RegExprParser::parse(string_view expr, int line, int column)
 {
+    arena_ = make_shared<RegExprArena>();
     input_ = move(expr);
     currentChar_ = input_.begin();
     line_ = line;
     column_ = column;
 
-    return parseExpr();
+    const RegExpr* root = parseExpr();
+    return RegExprPtr(move(arena_), root);
 }
 
-RegExpr RegExprParser::parseExpr()
+const RegExpr* RegExprParser::parseExpr()
 {
     return parseLookAheadExpr();
 }
 
-RegExpr RegExprParser::parseLookAheadExpr()
+const RegExpr* RegExprParser::parseLookAheadExpr()
 {
-    RegExpr lhs = parseAlternation();
+    const RegExpr* lhs = parseAlternation();
 
     if (currentChar() == '/')
     {
         consume();
-        RegExpr rhs = parseAlternation();
-        lhs = LookAheadExpr { make_unique<RegExpr>(move(lhs)), make_unique<RegExpr>(move(rhs)) };
+        const RegExpr* rhs = parseAlternation();
+        lhs = arena_->create(LookAheadExpr { lhs, rhs });
     }
 
     return lhs;
 }
 
-RegExpr RegExprParser::parseAlternation()
+const RegExpr* RegExprParser::parseAlternation()
 {
-    RegExpr lhs = parseConcatenation();
+    const RegExpr* first = parseConcatenation();
+    if (currentChar() != '|')
+        return first;
 
+    AlternationExpr alternation { { first } };
     while (currentChar() == '|')
     {
         consume();
-        RegExpr rhs = parseConcatenation();
-        lhs = AlternationExpr { make_unique<RegExpr>(move(lhs)), make_unique<RegExpr>(move(rhs)) };
+        alternation.subExprs.push_back(parseConcatenation());
     }
 
-    return lhs;
+    return arena_->create(move(alternation));
 }
 
-RegExpr RegExprParser::parseConcatenation()
+const RegExpr* RegExprParser::parseConcatenation()
 {
     // FOLLOW-set, the set of terminal tokens that can occur right after a concatenation
     static const string_view follow = "/|)";
-    RegExpr lhs = parseClosure();
+    const RegExpr* first = parseClosure();
+    if (eof() || follow.find(currentChar()) != follow.npos)
+        return first;
 
+    ConcatenationExpr concatenation { { first } };
     while (!eof() && follow.find(currentChar()) == follow.npos)
-    {
-        RegExpr rhs = parseClosure();
-        lhs = ConcatenationExpr { make_unique<RegExpr>(move(lhs)), make_unique<RegExpr>(move(rhs)) };
-    }
+        concatenation.subExprs.push_back(parseClosure());
 
-    return lhs;
+    return arena_->create(move(concatenation));
 }
 
-RegExpr RegExprParser::parseClosure()
+const RegExpr* RegExprParser::parseClosure()
 {
-    RegExpr subExpr = parseAtom();
+    const RegExpr* subExpr = parseAtom();
 
     switch (currentChar())
     {
-        case '?': consume(); return ClosureExpr { make_unique<RegExpr>(move(subExpr)), 0, 1 };
-        case '*': consume(); return ClosureExpr { make_unique<RegExpr>(move(subExpr)), 0 };
-        case '+': consume(); return ClosureExpr { make_unique<RegExpr>(move(subExpr)), 1 };
+        case '?': consume(); return arena_->create(ClosureExpr { subExpr, 0, 1 });
+        case '*': consume(); return arena_->create(ClosureExpr { subExpr, 0 });
+        case '+': consume(); return arena_->create(ClosureExpr { subExpr, 1 });
         case '{': {
             consume();
             unsigned int m = parseInt();
@@ -180,12 +184,12 @@ RegExpr RegExprParser::parseClosure()
                 consume();
                 unsigned int n = parseInt();
                 consume('}');
-                return ClosureExpr { make_unique<RegExpr>(move(subExpr)), m, n };
+                return arena_->create(ClosureExpr { subExpr, m, n });
             }
             else
             {
                 consume('}');
-                return ClosureExpr { make_unique<RegExpr>(move(subExpr)), m, m };
+                return arena_->create(ClosureExpr { subExpr, m, m });
             }
         }
         default: return subExpr;
@@ -204,7 +208,7 @@ unsigned RegExprParser::parseInt()
     return n;
 }
 
-RegExpr RegExprParser::parseAtom()
+const RegExpr* RegExprParser::parseAtom()
 {
     // skip any whitespace (except newlines)
     while (!eof() && isspace(currentChar()) && currentChar() != '\n')
@@ -213,7 +217,7 @@ RegExpr RegExprParser::parseAtom()
     switch (currentChar())
     {
         case -1: // EOF
-        case ')': return EmptyExpr {};
+        case ')': return arena_->create(EmptyExpr {});
         case '<':
             consume();
             consume('<');
@@ -222,33 +226,32 @@ RegExpr RegExprParser::parseAtom()
             consume('F');
             consume('>');
             consume('>');
-            return EndOfFileExpr {};
+            return arena_->create(EndOfFileExpr {});
         case '(': {
             consume();
-            RegExpr subExpr = parseExpr();
+            const RegExpr* subExpr = parseExpr();
             consume(')');
             return subExpr;
         }
         case '"': {
             consume();
-            RegExpr lhs = CharacterExpr { consume() };
+            ConcatenationExpr literal { { arena_->create(CharacterExpr { consume() }) } };
             while (!eof() && currentChar() != '"')
-            {
-                RegExpr rhs = CharacterExpr { consume() };
-                lhs = ConcatenationExpr { make_unique<RegExpr>(move(lhs)), make_unique<RegExpr>(move(rhs)) };
-            }
+                literal.subExprs.push_back(arena_->create(CharacterExpr { consume() }));
             consume('"');
-            return lhs;
+            if (literal.subExprs.size() == 1)
+                return literal.subExprs.front();
+            return arena_->create(move(literal));
         }
         case '[': return parseCharacterClass();
-        case '.': consume(); return DotExpr {};
-        case '^': consume(); return BeginOfLineExpr {};
-        case '$': consume(); return EndOfLineExpr {};
-        default: return CharacterExpr { parseSingleCharacter() };
+        case '.': consume(); return arena_->create(DotExpr {});
+        case '^': consume(); return arena_->create(BeginOfLineExpr {});
+        case '$': consume(); return arena_->create(EndOfLineExpr {});
+        default: return arena_->create(CharacterExpr { parseSingleCharacter() });
     }
 }
 
-RegExpr RegExprParser::parseCharacterClass()
+const RegExpr* RegExprParser::parseCharacterClass()
 {
     consume();                              // '['
     const bool complement = consumeIf('^'); // TODO
@@ -262,7 +265,7 @@ RegExpr RegExprParser::parseCharacterClass()
         ss.complement();
 
     consume(']');
-    return CharacterClassExpr { move(ss) };
+    return arena_->create(CharacterClassExpr { move(ss) });
 }
 
 void RegExprParser::parseNamedCharacterClass(SymbolSet& ss)
@@ -20,9 +20,14 @@ class RegExprParser {
   public:
 	RegExprParser();
 
-	RegExpr parse(std::string_view expr, int line, int column);
+	/**
+	 * Parses @p expr into a freshly allocated RegExprArena.
+	 *
+	 * @returns the root node, sharing ownership of the arena all its sub-expressions live in.
+	 */
+	RegExprPtr parse(std::string_view expr, int line, int column);
 
-	RegExpr parse(std::string_view expr) { return parse(std::move(expr), 1, 1); }
+	RegExprPtr parse(std::string_view expr) { return parse(std::move(expr), 1, 1); }
 
 	class UnexpectedToken : public std::runtime_error {
 	  public:
@@ -63,19 +68,19 @@ class RegExprParser {
 	int consume();
 	unsigned parseInt();
 
-	RegExpr parse();                 // expr
-	RegExpr parseExpr();             // lookahead
-	RegExpr parseLookAheadExpr();    // alternation ('/' alternation)?
-	RegExpr parseAlternation();      // concatenation ('|' concatenation)*
-	RegExpr parseConcatenation();    // closure (closure)*
-	RegExpr parseClosure();          // atom ['*' | '?' | '{' NUM [',' NUM] '}']
-	RegExpr parseAtom();             // character | characterClass | '(' expr ')'
-	RegExpr parseCharacterClass();   // '[' characterClassFragment+ ']'
+	const RegExpr* parseExpr();             // lookahead
+	const RegExpr* parseLookAheadExpr();    // alternation ('/' alternation)?
+	const RegExpr* parseAlternation();      // concatenation ('|' concatenation)*
+	const RegExpr* parseConcatenation();    // closure (closure)*
+	const RegExpr* parseClosure();          // atom ['*' | '?' | '{' NUM [',' NUM] '}']
+	const RegExpr* parseAtom();             // character | characterClass | '(' expr ')'
+	const RegExpr* parseCharacterClass();   // '[' characterClassFragment+ ']'
 	void parseCharacterClassFragment(SymbolSet& ss);  // namedClass | character | character '-' character
 	void parseNamedCharacterClass(SymbolSet& ss);     // '[' ':' NAME ':' ']'
 	Symbol parseSingleCharacter();
 
   private:
+	std::shared_ptr<RegExprArena> arena_;
 	std::string_view input_;
 	std::string_view::iterator currentChar_;
 	unsigned int line_;
@@ -10,85 +10,86 @@
 #include <klex/util/testing.h>
 
 #include <memory>
+#include <string>
 
 using namespace std;
 using namespace klex::regular;
 
 TEST(regular_RegExprParser, namedCharacterClass_graph)
 {
-    RegExpr re = RegExprParser {}.parse("[[:graph:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("!-~", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:graph:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("!-~", to_string(*re));
 }
 
 TEST(regular_RegExprParser, whitespaces_concatination)
 {
-    RegExpr re = RegExprParser {}.parse("a b");
-    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(re));
-    EXPECT_EQ("ab", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("a b");
+    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(*re));
+    EXPECT_EQ("ab", to_string(*re));
 }
 
 TEST(regular_RegExprParser, whitespaces_alternation)
 {
-    RegExpr re = RegExprParser {}.parse("a | b");
-    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(re));
-    EXPECT_EQ("a|b", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("a | b");
+    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(*re));
+    EXPECT_EQ("a|b", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_digit)
 {
-    RegExpr re = RegExprParser {}.parse("[[:digit:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("0-9", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:digit:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("0-9", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_alnum)
 {
-    RegExpr re = RegExprParser {}.parse("[[:alnum:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("0-9A-Za-z", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:alnum:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("0-9A-Za-z", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_alpha)
 {
-    RegExpr re = RegExprParser {}.parse("[[:alpha:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("A-Za-z", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:alpha:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("A-Za-z", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_blank)
 {
-    RegExpr re = RegExprParser {}.parse("[[:blank:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\t\\s", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:blank:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\t\\s", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_cntrl)
 {
-    RegExpr re = RegExprParser {}.parse("[[:cntrl:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\0-\\x1f\\x7f", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:cntrl:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\0-\\x1f\\x7f", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_print)
 {
-    RegExpr re = RegExprParser {}.parse("[[:print:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\s-~", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:print:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\s-~", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_punct)
 {
-    RegExpr re = RegExprParser {}.parse("[[:punct:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("!-/:-@[-`{-~", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:punct:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("!-/:-@[-`{-~", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_space)
 {
-    RegExpr re = RegExprParser {}.parse("[[:space:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\0\\t-\\r", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:space:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\0\\t-\\r", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_unknown)
@@ -98,24 +99,24 @@ TEST(regular_RegExprParser, namedCharacterClass_unknown)
 
 TEST(regular_RegExprParser, namedCharacterClass_upper)
 {
-    RegExpr re = RegExprParser {}.parse("[[:upper:]]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("A-Z", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:upper:]]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("A-Z", to_string(*re));
 }
 
 TEST(regular_RegExprParser, namedCharacterClass_mixed)
 {
-    RegExpr re = RegExprParser {}.parse("[[:lower:]0-9]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("0-9a-z", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("[[:lower:]0-9]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("0-9a-z", to_string(*re));
 }
 
 TEST(regular_RegExprParser, characterClass_complement)
 {
-    RegExpr re = RegExprParser {}.parse("[^\\n]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_TRUE(get<CharacterClassExpr>(re).symbols.isDot());
-    EXPECT_EQ(".", get<CharacterClassExpr>(re).symbols.to_string());
+    RegExprPtr re = RegExprParser {}.parse("[^\\n]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_TRUE(get<CharacterClassExpr>(*re).symbols.isDot());
+    EXPECT_EQ(".", get<CharacterClassExpr>(*re).symbols.to_string());
 }
 
 TEST(regular_RegExprParser, escapeSequences_invalid)
@@ -125,28 +126,28 @@ TEST(regular_RegExprParser, escapeSequences_invalid)
 
 TEST(regular_RegExprParser, escapeSequences_abfnrstv)
 {
-    EXPECT_EQ("\\a", to_string(RegExprParser {}.parse("[\\a]")));
-    EXPECT_EQ("\\b", to_string(RegExprParser {}.parse("[\\b]")));
-    EXPECT_EQ("\\f", to_string(RegExprParser {}.parse("[\\f]")));
-    EXPECT_EQ("\\n", to_string(RegExprParser {}.parse("[\\n]")));
-    EXPECT_EQ("\\r", to_string(RegExprParser {}.parse("[\\r]")));
-    EXPECT_EQ("\\s", to_string(RegExprParser {}.parse("[\\s]")));
-    EXPECT_EQ("\\t", to_string(RegExprParser {}.parse("[\\t]")));
-    EXPECT_EQ("\\v", to_string(RegExprParser {}.parse("[\\v]")));
+    EXPECT_EQ("\\a", to_string(*RegExprParser {}.parse("[\\a]")));
+    EXPECT_EQ("\\b", to_string(*RegExprParser {}.parse("[\\b]")));
+    EXPECT_EQ("\\f", to_string(*RegExprParser {}.parse("[\\f]")));
+    EXPECT_EQ("\\n", to_string(*RegExprParser {}.parse("[\\n]")));
+    EXPECT_EQ("\\r", to_string(*RegExprParser {}.parse("[\\r]")));
+    EXPECT_EQ("\\s", to_string(*RegExprParser {}.parse("[\\s]")));
+    EXPECT_EQ("\\t", to_string(*RegExprParser {}.parse("[\\t]")));
+    EXPECT_EQ("\\v", to_string(*RegExprParser {}.parse("[\\v]")));
 }
 
 TEST(regular_RegExprParser, newline)
 {
-    RegExpr re = RegExprParser {}.parse("\n");
-    ASSERT_TRUE(holds_alternative<CharacterExpr>(re));
-    EXPECT_EQ('\n', get<CharacterExpr>(re).value);
+    RegExprPtr re = RegExprParser {}.parse("\n");
+    ASSERT_TRUE(holds_alternative<CharacterExpr>(*re));
+    EXPECT_EQ('\n', get<CharacterExpr>(*re).value);
 }
 
 TEST(regular_RegExprParser, escapeSequences_hex)
 {
-    RegExpr re = RegExprParser {}.parse("[\\x20]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\s", get<CharacterClassExpr>(re).symbols.to_string());
+    RegExprPtr re = RegExprParser {}.parse("[\\x20]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\s", get<CharacterClassExpr>(*re).symbols.to_string());
 
     EXPECT_THROW(RegExprParser {}.parse("[\\xZZ]"), RegExprParser::UnexpectedToken);
     EXPECT_THROW(RegExprParser {}.parse("[\\xAZ]"), RegExprParser::UnexpectedToken);
@@ -155,22 +156,22 @@ TEST(regular_RegExprParser, escapeSequences_hex)
 
 TEST(regular_RegExprParser, escapeSequences_nul)
 {
-    RegExpr re = RegExprParser {}.parse("[\\0]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\0", get<CharacterClassExpr>(re).symbols.to_string());
+    RegExprPtr re = RegExprParser {}.parse("[\\0]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\0", get<CharacterClassExpr>(*re).symbols.to_string());
 }
 
 TEST(regular_RegExprParser, escapeSequences_octal)
 {
     // with leading zero
-    RegExpr re = RegExprParser {}.parse("[\\040]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("\\s", get<CharacterClassExpr>(re).symbols.to_string());
+    RegExprPtr re = RegExprParser {}.parse("[\\040]");
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("\\s", get<CharacterClassExpr>(*re).symbols.to_string());
 
     // with leading non-zero
     re = RegExprParser {}.parse("[\\172]");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ("z", get<CharacterClassExpr>(re).symbols.to_string());
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ("z", get<CharacterClassExpr>(*re).symbols.to_string());
 
     // invalids
     EXPECT_THROW(RegExprParser {}.parse("[\\822]"), RegExprParser::UnexpectedToken);
@@ -183,108 +184,134 @@ TEST(regular_RegExprParser, escapeSequences_octal)
 TEST(regular_RegExprParser, doubleQuote)
 {
     // as concatenation character
-    RegExpr re = RegExprParser {}.parse(R"(\")");
-    ASSERT_TRUE(holds_alternative<CharacterExpr>(re));
-    EXPECT_EQ('"', get<CharacterExpr>(re).value);
+    RegExprPtr re = RegExprParser {}.parse(R"(\")");
+    ASSERT_TRUE(holds_alternative<CharacterExpr>(*re));
+    EXPECT_EQ('"', get<CharacterExpr>(*re).value);
 
     // as character class
     re = RegExprParser {}.parse(R"([\"])");
-    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(re));
-    EXPECT_EQ(R"(")", get<CharacterClassExpr>(re).symbols.to_string());
+    ASSERT_TRUE(holds_alternative<CharacterClassExpr>(*re));
+    EXPECT_EQ(R"(")", get<CharacterClassExpr>(*re).symbols.to_string());
 }
 
 TEST(regular_RegExprParser, dot)
 {
-    RegExpr re = RegExprParser {}.parse(".");
-    ASSERT_TRUE(holds_alternative<DotExpr>(re));
-    EXPECT_EQ(".", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse(".");
+    ASSERT_TRUE(holds_alternative<DotExpr>(*re));
+    EXPECT_EQ(".", to_string(*re));
 }
 
 TEST(regular_RegExprParser, optional)
 {
-    RegExpr re = RegExprParser {}.parse("a?");
-    ASSERT_TRUE(holds_alternative<ClosureExpr>(re));
-    EXPECT_EQ("a?", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("a?");
+    ASSERT_TRUE(holds_alternative<ClosureExpr>(*re));
+    EXPECT_EQ("a?", to_string(*re));
 }
 
 TEST(regular_RegExprParser, bol)
 {
-    RegExpr re = RegExprParser {}.parse("^a");
-    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(re));
-    const ConcatenationExpr& cat = get<ConcatenationExpr>(re);
+    RegExprPtr re = RegExprParser {}.parse("^a");
+    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(*re));
+    const ConcatenationExpr& cat = get<ConcatenationExpr>(*re);
 
-    ASSERT_TRUE(holds_alternative<BeginOfLineExpr>(*cat.left));
-    EXPECT_EQ("^", to_string(*cat.left));
-    EXPECT_EQ("a", to_string(*cat.right));
+    ASSERT_EQ(2, cat.subExprs.size());
+    ASSERT_TRUE(holds_alternative<BeginOfLineExpr>(*cat.subExprs[0]));
+    EXPECT_EQ("^", to_string(*cat.subExprs[0]));
+    EXPECT_EQ("a", to_string(*cat.subExprs[1]));
 }
 
 TEST(regular_RegExprParser, eol)
 {
-    RegExpr re = RegExprParser {}.parse("a$");
-    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(re));
-    const ConcatenationExpr& cat = get<ConcatenationExpr>(re);
+    RegExprPtr re = RegExprParser {}.parse("a$");
+    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(*re));
+    const ConcatenationExpr& cat = get<ConcatenationExpr>(*re);
 
-    ASSERT_TRUE(holds_alternative<EndOfLineExpr>(*cat.right));
-    EXPECT_EQ("a$", to_string(re));
+    ASSERT_TRUE(holds_alternative<EndOfLineExpr>(*cat.subExprs.back()));
+    EXPECT_EQ("a$", to_string(*re));
 }
 
 TEST(regular_RegExprParser, eof)
 {
-    RegExpr re = RegExprParser {}.parse("<<EOF>>");
-    ASSERT_TRUE(holds_alternative<EndOfFileExpr>(re));
-    EXPECT_EQ("<<EOF>>", to_string(re));
+    RegExprPtr re = RegExprParser {}.parse("<<EOF>>");
+    ASSERT_TRUE(holds_alternative<EndOfFileExpr>(*re));
+    EXPECT_EQ("<<EOF>>", to_string(*re));
 }
 
 TEST(regular_RegExprParser, alternation)
 {
-    EXPECT_EQ("a|b", to_string(RegExprParser {}.parse("a|b")));
-    EXPECT_EQ("(a|b)c", to_string(RegExprParser {}.parse("(a|b)c")));
-    EXPECT_EQ("a(b|c)", to_string(RegExprParser {}.parse("a(b|c)")));
+    EXPECT_EQ("a|b", to_string(*RegExprParser {}.parse("a|b")));
+    EXPECT_EQ("(a|b)c", to_string(*RegExprParser {}.parse("(a|b)c")));
+    EXPECT_EQ("a(b|c)", to_string(*RegExprParser {}.parse("a(b|c)")));
+}
+
+TEST(regular_RegExprParser, alternation_nary)
+{
+    string keywords = "k0";
+    for (int i = 1; i < 5000; ++i)
+        keywords += "|k" + std::to_string(i);
+
+    RegExprPtr re = RegExprParser {}.parse(keywords);
+    ASSERT_TRUE(holds_alternative<AlternationExpr>(*re));
+    const AlternationExpr& alt = get<AlternationExpr>(*re);
+    ASSERT_EQ(5000, alt.subExprs.size());
+    EXPECT_EQ("k4999", to_string(*alt.subExprs.back()));
+    EXPECT_EQ(keywords, to_string(*re));
+}
+
+TEST(regular_RegExprParser, concatenation_nary)
+{
+    RegExprPtr re = RegExprParser {}.parse(R"(ab"cde"f)");
+    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(*re));
+    const ConcatenationExpr& cat = get<ConcatenationExpr>(*re);
+    ASSERT_EQ(4, cat.subExprs.size());
+    ASSERT_TRUE(holds_alternative<ConcatenationExpr>(*cat.subExprs[2]));
+    EXPECT_EQ(3, get<ConcatenationExpr>(*cat.subExprs[2]).subExprs.size());
+    EXPECT_EQ("abcdef", to_string(*re));
 }
 
 TEST(regular_RegExprParser, lookahead)
 {
-    RegExpr re = RegExprParser {}.parse("ab/cd");
-    ASSERT_TRUE(holds_alternative<LookAheadExpr>(re));
-    EXPECT_EQ("ab/cd", to_string(re));
-    EXPECT_EQ("(a/b)|b", to_string(RegExprParser {}.parse("(a/b)|b")));
-    EXPECT_EQ("a|(b/c)", to_string(RegExprParser {}.parse("a|(b/c)")));
+    RegExprPtr re = RegExprParser {}.parse("ab/cd");
+    ASSERT_TRUE(holds_alternative<LookAheadExpr>(*re));
+    EXPECT_EQ("ab/cd", to_string(*re));
+    EXPECT_EQ("(a/b)|b", to_string(*RegExprParser {}.parse("(a/b)|b")));
+    EXPECT_EQ("a|(b/c)", to_string(*RegExprParser {}.parse("a|(b/c)")));
 }
 
 TEST(regular_RegExprParser, closure)
 {
-    RegExpr re = RegExprParser {}.parse("(abc)*");
-    ASSERT_TRUE(holds_alternative<ClosureExpr>(re));
-    const ClosureExpr& e = get<ClosureExpr>(re);
+    RegExprPtr re = RegExprParser {}.parse("(abc)*");
+    ASSERT_TRUE(holds_alternative<ClosureExpr>(*re));
+    const ClosureExpr& e = get<ClosureExpr>(*re);
     EXPECT_EQ(0, e.minimumOccurrences);
     EXPECT_EQ(numeric_limits<unsigned>::max(), e.maximumOccurrences);
-    EXPECT_EQ("(abc)*", to_string(re));
+    EXPECT_EQ("(abc)*", to_string(*re));
 }
 
 TEST(regular_RegExprParser, positive)
 {
-    auto re = RegExprParser {}.parse("(abc)+");
-    ASSERT_TRUE(holds_alternative<ClosureExpr>(re));
-    const ClosureExpr& e = get<ClosureExpr>(re);
+    RegExprPtr re = RegExprParser {}.parse("(abc)+");
+    ASSERT_TRUE(holds_alternative<ClosureExpr>(*re));
+    const ClosureExpr& e = get<ClosureExpr>(*re);
     EXPECT_EQ(1, e.minimumOccurrences);
     EXPECT_EQ(numeric_limits<unsigned>::max(), e.maximumOccurrences);
-    EXPECT_EQ("(abc)+", to_string(re));
+    EXPECT_EQ("(abc)+", to_string(*re));
 }
 
 TEST(regular_RegExprParser, closure_range)
 {
-    auto re = RegExprParser {}.parse("a{2,4}");
-    ASSERT_TRUE(holds_alternative<ClosureExpr>(re));
-    const ClosureExpr& e = get<ClosureExpr>(re);
+    RegExprPtr re = RegExprParser {}.parse("a{2,4}");
+    ASSERT_TRUE(holds_alternative<ClosureExpr>(*re));
+    const ClosureExpr& e = get<ClosureExpr>(*re);
     EXPECT_EQ(2, e.minimumOccurrences);
     EXPECT_EQ(4, e.maximumOccurrences);
-    EXPECT_EQ("a{2,4}", to_string(re));
+    EXPECT_EQ("a{2,4}", to_string(*re));
 }
 
 TEST(regular_RegExprParser, empty)
 {
-    auto re = RegExprParser {}.parse("(a|)");
-    EXPECT_EQ("a|", to_string(re)); // grouping '(' & ')' is not preserved as node in the parse tree.
+    RegExprPtr re = RegExprParser {}.parse("(a|)");
+    EXPECT_EQ("a|", to_string(*re)); // grouping '(' & ')' is not preserved as node in the parse tree.
 }
 
 TEST(regular_RegExprParser, UnexpectedToken_grouping)
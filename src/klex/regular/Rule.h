@@ -8,7 +8,6 @@
 
 #include <klex/regular/LexerDef.h>  // IgnoreTag
 #include <klex/regular/RegExpr.h>
-#include <klex/regular/RegExprParser.h>
 #include <klex/regular/State.h>  // Tag
 #include <memory>
 #include <optional>
@@ -24,26 +23,16 @@ struct Rule {
 	std::vector<std::string> conditions;
 	std::string name;
 	std::string pattern;
-	std::unique_ptr<RegExpr> regexpr = nullptr;
+	RegExprPtr regexpr = nullptr;  // immutable and shared among all copies of this rule
 
 	bool isIgnored() const noexcept { return tag == IgnoreTag; }
 
-	Rule clone() const
-	{
-		return regexpr ? Rule{line,
-							  column,
-							  tag,
-							  conditions,
-							  name,
-							  pattern,
-							  std::make_unique<RegExpr>(RegExprParser{}.parse(pattern, line, column))}
-					   : Rule{line, column, tag, conditions, name, pattern, nullptr};
-	}
+	Rule clone() const { return *this; }
 
 	Rule() = default;
 
 	Rule(unsigned _line, unsigned _column, Tag _tag, std::vector<std::string> _conditions, std::string _name,
-		 std::string _pattern, std::unique_ptr<RegExpr> _regexpr = nullptr)
+		 std::string _pattern, RegExprPtr _regexpr = nullptr)
 		: line{_line},
 		  column{_column},
 		  tag{_tag},
@@ -54,29 +43,6 @@ struct Rule {
 	{
 	}
 
-	Rule(const Rule& v)
-		: line{v.line},
-		  column{v.column},
-		  tag{v.tag},
-		  conditions{v.conditions},
-		  name{v.name},
-		  pattern{v.pattern},
-		  regexpr{v.regexpr ? std::make_unique<RegExpr>(RegExprParser{}.parse(pattern, line, column)) : nullptr}
-	{
-	}
-
-	Rule& operator=(const Rule& v)
-	{
-		line = v.line;
-		column = v.column;
-		tag = v.tag;
-		conditions = v.conditions;
-		name = v.name;
-		pattern = v.pattern;
-		regexpr = v.regexpr ? std::make_unique<RegExpr>(RegExprParser{}.parse(pattern, line, column)) : nullptr;
-		return *this;
-	}
-
 	bool operator<(const Rule& rhs) const noexcept { return tag < rhs.tag; }
 	bool operator<=(const Rule& rhs) const noexcept { return tag <= rhs.tag; }
 	bool operator==(const Rule& rhs) const noexcept { return tag == rhs.tag; }
@@ -5,6 +5,7 @@
 // file except in compliance with the License. You may obtain a copy of
 // the License at: http://opensource.org/licenses/MIT
 
+#include <klex/regular/RegExprParser.h>
 #include <klex/regular/RuleParser.h>
 #include <klex/util/testing.h>
 
@@ -244,3 +245,16 @@ TEST(regular_RuleParser, UnexpectedToken)
     ASSERT_THROW(RuleParser { "<> A ::= a" }.parseRules(), RuleParser::UnexpectedToken);
     ASSERT_THROW(RuleParser { " ::= a" }.parseRules(), RuleParser::UnexpectedToken);
 }
+
+TEST(regular_RuleParser, copy_shares_regexpr)
+{
+    RuleList rules = RuleParser { "main ::= a|b|c\n" }.parseRules();
+    ASSERT_EQ(1, rules.size());
+    rules[0].regexpr = RegExprParser {}.parse(rules[0].pattern);
+
+    const Rule copy = rules[0];
+    const Rule clone = rules[0].clone();
+    EXPECT_TRUE(rules[0].regexpr == copy.regexpr);
+    EXPECT_TRUE(rules[0].regexpr == clone.regexpr);
+    EXPECT_EQ("a|b|c", to_string(*clone.regexpr));
+}
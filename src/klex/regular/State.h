@@ -23,6 +23,11 @@ using Tag = int;
 using StateId = size_t;
 using StateIdVec = std::vector<StateId>;
 
+/**
+ * Represents an error-state, such as invalid input character or unexpected EOF.
+ */
+constexpr StateId ErrorState{808080};  // static_cast<StateId>(-1);
+
 using AcceptMap = std::map<StateId, Tag>;
 
 /**
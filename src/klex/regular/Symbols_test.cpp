@@ -109,3 +109,11 @@ TEST(regular_SymbolSet, compare)
     ASSERT_TRUE(s1 == s2);
     ASSERT_TRUE(s1 != s3);
 }
+
+BENCHMARK(regular_SymbolSet, insert_range)
+{
+    SymbolSet s;
+    s.insert(make_pair('a', 'z'));
+    s.insert(make_pair('0', '9'));
+    klex::util::testing::doNotOptimize(s.hash());
+}
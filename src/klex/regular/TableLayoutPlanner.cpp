@@ -0,0 +1,83 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/CombTable.h>
+#include <klex/regular/DenseTable.h>
+#include <klex/regular/TableLayoutPlanner.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+TableLayoutPlan planTableLayout(const LexerDef& lexerDef, CacheBudget budget)
+{
+    const TransitionMap& transitions = lexerDef.transitions;
+    assert(transitions.layout() == TableLayout::Ranges);
+
+    const TransitionMap::Container& container = transitions.ranges();
+
+    const DenseTable classes = DenseTable::build(container, true);
+
+    TableLayoutPlan plan {};
+    TableStatistics& stats = plan.statistics;
+    stats.states = classes.stateCount();
+    stats.symbols = classes.symbolCount();
+    stats.classes = classes.classCount();
+    stats.transitions = static_cast<size_t>(count_if(classes.next().begin(),
+                                                     classes.next().end(),
+                                                     [](DenseTable::Index t) { return t != ErrorState; }));
+    stats.density =
+        classes.next().empty() ? 0.0 : static_cast<double>(stats.transitions) / classes.next().size();
+    stats.backtrackingStates = lexerDef.backtrackingStates.size();
+
+    plan.footprints[TableLayout::Ranges] = transitions.footprint();
+    plan.footprints[TableLayout::Comb] = CombTable::estimateFootprint(container);
+    plan.footprints[TableLayout::Dense] = stats.states * stats.symbols * sizeof(DenseTable::Index);
+    plan.footprints[TableLayout::Classes] = classes.footprint();
+
+    if (stats.backtrackingStates != 0)
+    {
+        budget.level1 *= 2;
+        budget.level2 *= 2;
+    }
+
+    auto fp = [&](TableLayout layout) { return plan.footprints[layout]; };
+
+    if (fp(TableLayout::Dense) <= budget.level1)
+        plan.layout = TableLayout::Dense;
+    else if (fp(TableLayout::Classes) <= budget.level1
+             || (fp(TableLayout::Classes) <= budget.level2 && stats.density >= 0.25))
+        plan.layout = TableLayout::Classes;
+    else
+    {
+        plan.layout = fp(TableLayout::Comb) < fp(TableLayout::Classes) ? TableLayout::Comb
+                                                                        : TableLayout::Classes;
+        if (2 * fp(TableLayout::Ranges) < fp(plan.layout))
+            plan.layout = TableLayout::Ranges;
+    }
+
+    return plan;
+}
+
+string to_string(TableLayout layout)
+{
+    switch (layout)
+    {
+        case TableLayout::Ranges: return "ranges";
+        case TableLayout::Comb: return "comb";
+        case TableLayout::Dense: return "dense";
+        case TableLayout::Classes: return "classes";
+        case TableLayout::Auto: return "auto";
+    }
+    return "unknown";
+}
+
+} // namespace klex::regular
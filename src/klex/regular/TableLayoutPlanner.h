@@ -0,0 +1,70 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/LexerDef.h>
+#include <klex/regular/TransitionMap.h>
+
+#include <map>
+#include <string>
+
+namespace klex::regular {
+
+//! Statistics on a lexer's transition table, as the layout planner sees them.
+struct TableStatistics {
+	size_t states;              //!< number of states (including those without transitions)
+	size_t symbols;             //!< width of the symbol range covered by any transition
+	size_t classes;             //!< number of symbol equivalence classes
+	size_t transitions;         //!< number of (state, class) pairs having a transition
+	double density;             //!< transitions / (states * classes)
+	size_t backtrackingStates;  //!< number of accept states that may need to backtrack
+};
+
+//! Outcome of planTableLayout().
+struct TableLayoutPlan {
+	TableStatistics statistics;
+
+	//! predicted footprint in bytes of each candidate layout
+	std::map<TableLayout, size_t> footprints;
+
+	//! the chosen layout
+	TableLayout layout;
+
+	size_t footprint() const { return footprints.at(layout); }
+};
+
+//! Cache sizes the layout planner tries to fit the transition table into.
+struct CacheBudget {
+	size_t level1 = 32 * 1024;
+	size_t level2 = 256 * 1024;
+};
+
+/**
+ * Chooses the fastest runtime layout for the transitions of @p lexerDef that keeps the table
+ * within the given cache @p budget, with the faster (but bigger) layouts preferred as follows:
+ *
+ * <ol>
+ *   <li>Dense, if it fits into the L1 cache (a single load per transition),</li>
+ *   <li>Classes, if it fits into the L1 cache, or into the L2 cache for tables of reasonable
+ *       density (one extra load into the small and always hot class map),</li>
+ *   <li>otherwise whichever is smaller out of Classes and Comb, the latter of which needs a
+ *       check and possibly follows default states,</li>
+ *   <li>and Ranges (binary search per transition) only if it is less than half the size of
+ *       either, which is the case for very big and sparse tables only.</li>
+ * </ol>
+ *
+ * Lexers that backtrack replay the transitions of the tokens they roll back, so for those,
+ * twice the budget is granted to the faster layouts.
+ *
+ * @p lexerDef's transitions must be in TableLayout::Ranges.
+ */
+TableLayoutPlan planTableLayout(const LexerDef& lexerDef, CacheBudget budget = CacheBudget{});
+
+//! Retrieves a human readable name of the given @p layout, as accepted by mklex.
+std::string to_string(TableLayout layout);
+
+}  // namespace klex::regular
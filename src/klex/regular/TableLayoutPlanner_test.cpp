@@ -0,0 +1,90 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/regular/TableLayoutPlanner.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+#include <string>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+namespace
+{
+    const string rules = R"(|Spacing(ignore)  ::= [\s\t\n]+
+                            |Eof              ::= <<EOF>>
+                            |If               ::= if
+                            |Else             ::= else
+                            |While            ::= while
+                            |AB_CD            ::= ab/cd
+                            |Number           ::= [0-9]+
+                            |Ident            ::= [a-z][a-z0-9]*
+                            |)"_multiline;
+
+    LexerDef generate(TableLayout layout)
+    {
+        Compiler cc;
+        cc.parse(rules);
+        const MultiDFA multiDFA = cc.compileMultiDFA();
+        return Compiler::generateTables(multiDFA, cc.containsBeginOfLine(), cc.names(), layout);
+    }
+} // namespace
+
+TEST(regular_TableLayoutPlanner, layouts_equivalence)
+{
+    const LexerDef reference = generate(TableLayout::Ranges);
+
+    for (TableLayout layout:
+         { TableLayout::Comb, TableLayout::Dense, TableLayout::Classes, TableLayout::Auto })
+    {
+        const LexerDef def = generate(layout);
+        EXPECT_TRUE(def.transitions.layout() != TableLayout::Ranges || layout == TableLayout::Auto);
+
+        for (StateId s = 0; s < 100; ++s)
+            for (Symbol c = Symbols::EndOfFile - 1; c <= 300; ++c)
+                EXPECT_EQ(reference.transitions.apply(s, c), def.transitions.apply(s, c));
+    }
+}
+
+TEST(regular_TableLayoutPlanner, symbol_classes)
+{
+    const LexerDef def = generate(TableLayout::Classes);
+    const DenseTable* table = def.transitions.dense();
+    ASSERT_TRUE(table != nullptr);
+
+    // e.g. all letters but the ones in keywords are indistinguishable
+    EXPECT_TRUE(table->classCount() < table->symbolCount() / 4);
+    EXPECT_EQ(table->classes()['x' - table->firstSymbol()], table->classes()['z' - table->firstSymbol()]);
+    EXPECT_TRUE(table->classes()['x' - table->firstSymbol()] != table->classes()['i' - table->firstSymbol()]);
+}
+
+TEST(regular_TableLayoutPlanner, plan)
+{
+    const TableLayoutPlan plan = planTableLayout(generate(TableLayout::Ranges));
+
+    EXPECT_TRUE(plan.statistics.states > 0);
+    EXPECT_TRUE(plan.statistics.classes < plan.statistics.symbols);
+    EXPECT_EQ(1, plan.statistics.backtrackingStates);
+    EXPECT_EQ(4, plan.footprints.size());
+
+    // the comb table is predicted as if packed without gaps
+    EXPECT_TRUE(plan.footprints.at(TableLayout::Comb) <= generate(TableLayout::Comb).transitions.footprint());
+
+    // small enough to go dense
+    EXPECT_TRUE(plan.layout == TableLayout::Dense);
+
+    // without any cache to spare, the smallest layout wins
+    const TableLayoutPlan tight = planTableLayout(generate(TableLayout::Ranges), CacheBudget { 0, 0 });
+    EXPECT_TRUE(tight.layout != TableLayout::Dense);
+    for (const pair<const TableLayout, size_t>& fp: tight.footprints)
+        if (fp.first != TableLayout::Ranges)
+            EXPECT_TRUE(tight.footprint() <= fp.second);
+}
@@ -0,0 +1,100 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/DFA.h>
+#include <klex/regular/DFABuilder.h>
+#include <klex/regular/DFAMinimizer.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/regular/TableLayoutPlanner.h>
+#include <klex/regular/TieredLexerDef.h>
+
+#include <cassert>
+#include <map>
+#include <string>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+TieredLexerDef::TieredLexerDef(const Compiler& compiler):
+    baseline_ { compiler.compileLazyDFA() },
+    def_ {},
+    tier_ { Tier::Baseline },
+    cancelled_ { false },
+    error_ {},
+    worker_ {}
+{
+    Compiler::AutomataMap automata;
+    for (const pair<const string, NFA>& fa: compiler.automata())
+        automata[fa.first] = fa.second.clone();
+
+    worker_ = thread { [this,
+                        automata = move(automata),
+                        containsBeginOfLine = compiler.containsBeginOfLine(),
+                        names = compiler.names()]() mutable {
+        try
+        {
+            map<string, DFA> dfaMap;
+            for (pair<const string, NFA>& fa: automata)
+            {
+                if (cancelled_)
+                    return;
+                dfaMap[fa.first] = DFABuilder { move(fa.second) }.construct();
+            }
+
+            if (cancelled_)
+                return;
+            const MultiDFA multiDFA = constructMultiDFA(move(dfaMap));
+
+            if (cancelled_)
+                return;
+            const MultiDFA minimal = DFAMinimizer { multiDFA }.constructMultiDFA();
+
+            if (cancelled_)
+                return;
+            LexerDef def = Compiler::generateTables(minimal, containsBeginOfLine, names);
+
+            // as planned, but never leaving the binary search per transition in the steady state
+            const TableLayoutPlan plan = planTableLayout(def);
+            TableLayout layout = plan.layout;
+            if (layout == TableLayout::Ranges)
+                layout = plan.footprints.at(TableLayout::Comb) < plan.footprints.at(TableLayout::Classes)
+                             ? TableLayout::Comb
+                             : TableLayout::Classes;
+            def.transitions.convert(layout);
+
+            if (cancelled_)
+                return;
+            atomic_store(&def_, make_shared<const LexerDef>(move(def)));
+            tier_ = Tier::Optimized;
+        }
+        catch (...)
+        {
+            error_ = current_exception();
+        }
+    } };
+}
+
+TieredLexerDef::~TieredLexerDef()
+{
+    cancel();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void TieredLexerDef::wait()
+{
+    if (worker_.joinable())
+        worker_.join();
+
+    if (error_)
+        rethrow_exception(error_);
+}
+
+} // namespace klex::regular
@@ -0,0 +1,96 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/LazyDFA.h>
+#include <klex/regular/LexerDef.h>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace klex::regular {
+
+class Compiler;
+
+/**
+ * Lexer tables that are compiled in two tiers.
+ *
+ * The baseline tier is a LazyDFA, which can start lexing right away, as it only constructs the
+ * states the scanned input actually visits. A background thread meanwhile runs the subset
+ * construction and minimization of the full DFA, lays out its tables as planned by
+ * planTableLayout() (though never as Ranges), and atomically swaps them in once done.
+ *
+ * Lexers of the optimized tier only ever see a snapshot: obtain it via get() and keep the returned
+ * pointer alive for as long as the Lexer is in use. The baseline tier is not thread-safe and is
+ * meant to be used by a single lexing thread until the optimized tables become available.
+ *
+ * @code
+ *   TieredLexerDef tiered { compiler };
+ *   if (std::shared_ptr<const LexerDef> def = tiered.get(); def != nullptr)
+ *       Lexer<Tag> lexer { *def, input };
+ *   else
+ *       std::optional<LazyDFA::Match> match = tiered.baseline().recognize(input);
+ * @endcode
+ */
+class TieredLexerDef {
+  public:
+	enum class Tier {
+		Baseline,   //!< lazily constructed DFA
+		Optimized,  //!< tables of the minimized DFA
+	};
+
+	/**
+	 * Creates the baseline tier out of the rules previousely parsed by @p compiler and starts
+	 * compiling the optimized tables in the background.
+	 *
+	 * Requires Compiler::DFAConstruction::SubsetConstruction.
+	 */
+	explicit TieredLexerDef(const Compiler& compiler);
+
+	//! Cancels the background compilation, waiting for its current stage only.
+	~TieredLexerDef();
+
+	TieredLexerDef(const TieredLexerDef&) = delete;
+	TieredLexerDef& operator=(const TieredLexerDef&) = delete;
+
+	//! Retrieves the lazily constructed DFA to lex with until the optimized tables are available.
+	LazyDFA& baseline() noexcept { return baseline_; }
+
+	//! Retrieves a snapshot of the optimized tables, or nullptr if they are not available yet.
+	std::shared_ptr<const LexerDef> get() const { return std::atomic_load(&def_); }
+
+	//! Retrieves the best tier available right now.
+	Tier tier() const noexcept { return tier_.load(); }
+
+	/**
+	 * Requests the background compilation to stop, in between two of its stages (the subset
+	 * construction of a condition, merging the conditions, minimization and table generation).
+	 *
+	 * The baseline tier then remains in use, unless the optimized tables were already in place.
+	 */
+	void cancel() noexcept { cancelled_ = true; }
+
+	/**
+	 * Blocks until the optimized tables are in place, or the background compilation got cancelled.
+	 *
+	 * Rethrows any exception the background compilation failed with, in which case
+	 * the baseline tier remains in use.
+	 */
+	void wait();
+
+  private:
+	LazyDFA baseline_;
+	std::shared_ptr<const LexerDef> def_;
+	std::atomic<Tier> tier_;
+	std::atomic<bool> cancelled_;
+	std::exception_ptr error_;
+	std::thread worker_;
+};
+
+}  // namespace klex::regular
@@ -0,0 +1,48 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/TieredLexerDef.h>
+#include <klex/regular/test_util.h>
+#include <klex/util/testing.h>
+
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace klex::regular;
+
+TEST(regular_TieredLexerDef, swap_in_optimized)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    TieredLexerDef tiered { cc };
+
+    // lex right away on the lazily constructed DFA
+    EXPECT_EQ(13, tokenize(tiered.baseline(), sampleInput).size());
+
+    tiered.wait();
+    EXPECT_TRUE(tiered.tier() == TieredLexerDef::Tier::Optimized);
+
+    shared_ptr<const LexerDef> optimized = tiered.get();
+    ASSERT_TRUE(optimized != nullptr);
+    EXPECT_TRUE(optimized->transitions.layout() != TableLayout::Ranges);
+    expectSameTokens(*optimized, tiered.baseline(), sampleInput);
+}
+
+TEST(regular_TieredLexerDef, cancel)
+{
+    Compiler cc;
+    cc.parse(sampleRules);
+    TieredLexerDef tiered { cc };
+    tiered.cancel();
+    tiered.wait();
+
+    // unless already done, the optimized tables are never swapped in
+    EXPECT_EQ(tiered.tier() == TieredLexerDef::Tier::Optimized, tiered.get() != nullptr);
+    EXPECT_EQ(13, tokenize(tiered.baseline(), sampleInput).size());
+}
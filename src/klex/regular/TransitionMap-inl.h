@@ -8,19 +8,70 @@
 #include <klex/regular/State.h>
 #include <klex/regular/TransitionMap.h>
 #include <algorithm>
+#include <cassert>
 
 namespace klex::regular {
 
+inline TableLayout TransitionMap::layout() const noexcept
+{
+	if (comb_)
+		return TableLayout::Comb;
+
+	if (dense_)
+		return dense_->hasClasses() ? TableLayout::Classes : TableLayout::Dense;
+
+	return TableLayout::Ranges;
+}
+
+inline void TransitionMap::convert(TableLayout layout, StateId hotStates)
+{
+	assert(this->layout() == TableLayout::Ranges);
+	assert(layout != TableLayout::Auto);
+
+	if (layout == TableLayout::Ranges)
+		return;
+
+	Container hot;
+	for (auto i = mapping_.begin(); i != mapping_.end() && i->first < hotStates;)
+	{
+		hot.emplace(i->first, std::move(i->second));
+		i = mapping_.erase(i);
+	}
+
+	if (layout == TableLayout::Comb)
+		comb_ = CombTable::compress(hot);
+	else
+		dense_ = DenseTable::build(hot, layout == TableLayout::Classes);
+
+	hotStates_ = hotStates;
+}
+
 inline void TransitionMap::define(StateId currentState, Symbol charCat, StateId nextState)
 {
-	mapping_[currentState][charCat] = nextState;
+	assert(layout() == TableLayout::Ranges);
+	mapping_[currentState].define(charCat, nextState);
+}
+
+inline void TransitionMap::define(StateId currentState, Symbol first, Symbol last, StateId nextState)
+{
+	assert(layout() == TableLayout::Ranges);
+	mapping_[currentState].define(first, last, nextState);
 }
 
 inline StateId TransitionMap::apply(StateId currentState, Symbol charCat) const
 {
+	if (currentState < hotStates_)
+	{
+		if (dense_)
+			return dense_->apply(currentState, charCat);
+
+		if (comb_)
+			return comb_->apply(currentState, charCat);
+	}
+
 	if (auto i = mapping_.find(currentState); i != mapping_.end())
-		if (auto k = i->second.find(charCat); k != i->second.end())
-			return k->second;
+		if (std::optional<StateId> k = i->second.find(charCat); k.has_value())
+			return *k;
 
 	return ErrorState;
 }
@@ -28,7 +79,12 @@ inline StateId TransitionMap::apply(StateId currentState, Symbol charCat) const
 inline std::vector<StateId> TransitionMap::states() const
 {
 	std::vector<StateId> v;
-	v.reserve(mapping_.size());
+	if (dense_)
+		v = dense_->states();
+	else if (comb_)
+		v = comb_->states();
+
+	v.reserve(v.size() + mapping_.size());
 	for (const auto& i : mapping_)
 		v.push_back(i.first);
 	std::sort(v.begin(), v.end());
@@ -37,11 +93,42 @@ inline std::vector<StateId> TransitionMap::states() const
 
 inline std::map<Symbol, StateId> TransitionMap::map(StateId s) const
 {
+	if (s < hotStates_)
+	{
+		if (dense_)
+			return dense_->map(s);
+
+		if (comb_)
+			return comb_->map(s);
+	}
+
 	std::map<Symbol, StateId> m;
 	if (auto mapping = mapping_.find(s); mapping != mapping_.end())
-		for (const auto& i : mapping->second)
-			m[i.first] = i.second;
+		for (const TransitionRanges::Range& r : mapping->second)
+			for (Symbol c = r.first; c <= r.last; ++c)
+				m[c] = r.target;
 	return m;
 }
 
+inline const TransitionRanges* TransitionMap::ranges(StateId s) const
+{
+	if (auto mapping = mapping_.find(s); mapping != mapping_.end())
+		return &mapping->second;
+
+	return nullptr;
+}
+
+inline size_t TransitionMap::footprint() const
+{
+	size_t n = 0;
+	if (dense_)
+		n += dense_->footprint();
+	else if (comb_)
+		n += comb_->footprint();
+
+	for (const auto& i : mapping_)
+		n += sizeof(i) + i.second.size() * sizeof(TransitionRanges::Range);
+	return n;
+}
+
 }  // namespace klex::regular
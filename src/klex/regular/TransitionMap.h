@@ -6,8 +6,13 @@
 // the License at: http://opensource.org/licenses/MIT
 #pragma once
 
+#include <klex/regular/CombTable.h>
+#include <klex/regular/DenseTable.h>
 #include <klex/regular/State.h>
+#include <klex/regular/TransitionRanges.h>
+#include <limits>
 #include <map>
+#include <optional>
 #include <vector>
 
 namespace klex::regular {
@@ -16,27 +21,81 @@ using CharCatId = int;
 
 constexpr CharCatId ErrorCharCat = static_cast<CharCatId>(-1);
 
-/**
- * Represents an error-state, such as invalid input character or unexpected EOF.
- */
-constexpr StateId ErrorState{808080};  // static_cast<StateId>(-1);
+//! Runtime representation of a TransitionMap.
+enum class TableLayout {
+	Ranges,  //!< per-state sorted symbol ranges (see TransitionRanges)
+	Comb,    //!< row-displacement compressed table (see CombTable)
+	Dense,   //!< uncompressed states x symbols table (see DenseTable)
+	Classes, //!< states x symbol classes table (see DenseTable)
+	Auto,    //!< chosen by planTableLayout() (see TableLayoutPlanner)
+};
 
 /**
  * Transition mapping API to map the input (currentState, charCat) to (newState).
+ *
+ * Each state's transitions are stored as sorted symbol ranges (see TransitionRanges), unless the
+ * map has been converted into a CombTable or DenseTable.
+ *
+ * The conversion may be limited to the hot states [0, hotStates), in which case the transitions
+ * of all cold states remain stored as ranges.
  */
 class TransitionMap {
   public:
-	using Container = std::map<StateId, std::map<Symbol, StateId>>;
+	using Container = std::map<StateId, TransitionRanges>;
+
+	//! Value of hotStates() if the transitions are not split into hot and cold states.
+	static constexpr StateId AllStates = std::numeric_limits<StateId>::max();
+
+	TransitionMap() : mapping_{}, comb_{}, dense_{}, hotStates_{AllStates} {}
+
+	TransitionMap(Container mapping)
+		: mapping_{std::move(mapping)}, comb_{}, dense_{}, hotStates_{AllStates}
+	{
+	}
+
+	TransitionMap(CombTable comb, StateId hotStates = AllStates, Container cold = {})
+		: mapping_{std::move(cold)}, comb_{std::move(comb)}, dense_{}, hotStates_{hotStates}
+	{
+	}
 
-	TransitionMap() : mapping_{} {}
+	TransitionMap(DenseTable dense, StateId hotStates = AllStates, Container cold = {})
+		: mapping_{std::move(cold)}, comb_{}, dense_{std::move(dense)}, hotStates_{hotStates}
+	{
+	}
 
-	TransitionMap(Container mapping) : mapping_{std::move(mapping)} {}
+	//! Retrieves the current layout (of the hot states), which is never TableLayout::Auto.
+	TableLayout layout() const noexcept;
+
+	/**
+	 * Converts all transitions defined so far into the given @p layout.
+	 *
+	 * Only the transitions of states below @p hotStates are converted, those of the remaining
+	 * (cold) states are kept as ranges.
+	 *
+	 * Requires the current layout to be TableLayout::Ranges. Unless converted to Ranges,
+	 * no further transitions may be defined afterwards.
+	 */
+	void convert(TableLayout layout, StateId hotStates = AllStates);
+
+	//! Retrieves the number of hot states, or AllStates if not split.
+	StateId hotStates() const noexcept { return hotStates_; }
+
+	//! Retrieves the comb-vector compressed table, or nullptr if not in that layout.
+	const CombTable* comb() const noexcept { return comb_ ? &*comb_ : nullptr; }
+
+	//! Retrieves the dense table, or nullptr if not in either TableLayout::Dense or TableLayout::Classes.
+	const DenseTable* dense() const noexcept { return dense_ ? &*dense_ : nullptr; }
 
 	/**
 	 * Defines a new mapping for (currentState, charCat) to (nextState).
 	 */
 	void define(StateId currentState, Symbol charCat, StateId nextState);
 
+	/**
+	 * Defines a new mapping for (currentState, c) to (nextState) for every c in [@p first, @p last].
+	 */
+	void define(StateId currentState, Symbol first, Symbol last, StateId nextState);
+
 	/**
 	 * Retrieves the next state for the input (currentState, charCat).
 	 *
@@ -54,8 +113,28 @@ class TransitionMap {
 	 */
 	std::map<Symbol, StateId> map(StateId inputState) const;
 
+	/**
+	 * Retrieves the transition ranges from given state @p inputState, or nullptr if it has none
+	 * or its transitions are not stored as ranges.
+	 */
+	const TransitionRanges* ranges(StateId inputState) const;
+
+	/**
+	 * Retrieves all transitions stored as ranges, that is, all of them in TableLayout::Ranges and
+	 * those of the cold states otherwise.
+	 */
+	const Container& ranges() const noexcept { return mapping_; }
+
+	/**
+	 * Retrieves the number of bytes the transitions occupy at runtime (excluding allocator overhead).
+	 */
+	size_t footprint() const;
+
   private:
 	Container mapping_;
+	std::optional<CombTable> comb_;
+	std::optional<DenseTable> dense_;
+	StateId hotStates_;
 };
 
 }  // namespace klex::regular
@@ -0,0 +1,256 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/TransitionProfile.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace klex::regular
+{
+
+namespace
+{
+    constexpr string_view Magic = "klex-profile 1";
+
+    class Fnv1a
+    {
+      public:
+        void add(uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i, value >>= 8)
+            {
+                hash_ ^= value & 0xFF;
+                hash_ *= 0x100000001b3ull;
+            }
+        }
+
+        uint64_t get() const noexcept { return hash_; }
+
+      private:
+        uint64_t hash_ = 0xcbf29ce484222325ull;
+    };
+} // namespace
+
+uint64_t TransitionProfile::fingerprint(const LexerDef& lexerDef)
+{
+    Fnv1a hash;
+    for (const pair<const string, StateId>& q0: lexerDef.initialStates)
+        hash.add(q0.second);
+    for (const pair<const StateId, TransitionRanges>& T: lexerDef.transitions.ranges())
+        for (const TransitionRanges::Range& r: T.second)
+        {
+            hash.add(T.first);
+            hash.add(static_cast<uint64_t>(r.first));
+            hash.add(static_cast<uint64_t>(r.last));
+            hash.add(r.target);
+        }
+    for (const pair<const StateId, Tag>& accept: lexerDef.acceptStates)
+    {
+        hash.add(accept.first);
+        hash.add(static_cast<uint64_t>(accept.second));
+    }
+    return hash.get();
+}
+
+void TransitionProfile::record(const LexerDef& lexerDef, string_view corpus, const string& machine)
+{
+    assert(lexerDef.transitions.layout() == TableLayout::Ranges);
+
+    if (const uint64_t fp = fingerprint(lexerDef); counts_.empty())
+        fingerprint_ = fp;
+    else if (fp != fingerprint_)
+        throw InvalidProfile { "Cannot record a profile across different lexer tables." };
+
+    auto q0 = lexerDef.initialStates.find(machine);
+    if (q0 == lexerDef.initialStates.end() && machine == "INITIAL")
+        q0 = lexerDef.initialStates.begin();
+    if (q0 == lexerDef.initialStates.end())
+        throw InvalidProfile { fmt::format("Unknown condition {}.", machine) };
+
+    auto isAccepting = [&](StateId s) {
+        return lexerDef.acceptStates.find(s) != lexerDef.acceptStates.end();
+    };
+
+    // mirrors Lexer::recognizeOne(): scan as far as possible, then roll back to the last accept state
+    vector<StateId> path; // path[i] is the state after consuming i symbols
+    size_t offset = 0;
+    bool beginOfLine = true;
+    while (offset <= corpus.size())
+    {
+        path.clear();
+        StateId state = beginOfLine && lexerDef.containsBeginOfLineStates ? q0->second + 1 : q0->second;
+        for (size_t i = offset; state != ErrorState && i <= corpus.size(); ++i)
+        {
+            const Symbol c = i < corpus.size() ? static_cast<Symbol>(static_cast<unsigned char>(corpus[i]))
+                                               : Symbols::EndOfFile;
+            ++counts_[make_pair(state, c)];
+            path.push_back(state);
+            state = lexerDef.transitions.apply(state, c);
+        }
+
+        size_t length = path.size() - 1;
+        while (length > 0 && !isAccepting(path[length]))
+            --length;
+
+        if (length == 0)
+        {
+            beginOfLine = offset < corpus.size() && corpus[offset] == '\n';
+            ++offset;
+            continue;
+        }
+
+        if (auto bt = lexerDef.backtrackingStates.find(path[length]); bt != lexerDef.backtrackingStates.end())
+        {
+            size_t k = length;
+            while (k > 0 && path[k] != bt->second)
+                --k;
+            if (k > 0)
+                length = k;
+        }
+
+        if (offset + length > corpus.size()) // EOF recognized
+            break;
+
+        beginOfLine = corpus[offset + length - 1] == '\n';
+        offset += length;
+    }
+}
+
+uint64_t TransitionProfile::count(StateId s, Symbol c) const
+{
+    if (auto i = counts_.find(make_pair(s, c)); i != counts_.end())
+        return i->second;
+
+    return 0;
+}
+
+uint64_t TransitionProfile::visits(StateId s) const
+{
+    uint64_t n = 0;
+    for (auto i = counts_.lower_bound(make_pair(s, numeric_limits<Symbol>::min()));
+         i != counts_.end() && i->first.first == s;
+         ++i)
+        n += i->second;
+    return n;
+}
+
+void TransitionProfile::save(ostream& os) const
+{
+    os << Magic << '\n';
+    os << "fingerprint " << fmt::format("{:016x}", fingerprint_) << '\n';
+    for (const pair<const pair<StateId, Symbol>, uint64_t>& count: counts_)
+        os << count.first.first << ' ' << count.first.second << ' ' << count.second << '\n';
+}
+
+TransitionProfile TransitionProfile::load(istream& is)
+{
+    TransitionProfile profile;
+
+    string line;
+    if (!getline(is, line) || line != Magic)
+        throw InvalidProfile { "Not a klex profile." };
+
+    string keyword;
+    if (!getline(is, line) || !(istringstream { line } >> keyword >> hex >> profile.fingerprint_)
+        || keyword != "fingerprint")
+        throw InvalidProfile { "Missing profile fingerprint." };
+
+    size_t lineNr = 2;
+    while (getline(is, line))
+    {
+        ++lineNr;
+        StateId s;
+        Symbol c;
+        uint64_t n;
+        if (!(istringstream { line } >> s >> c >> n))
+            throw InvalidProfile { fmt::format("Malformed profile entry in line {}.", lineNr) };
+        profile.counts_[make_pair(s, c)] += n;
+    }
+
+    return profile;
+}
+
+StateId renumberStates(LexerDef& lexerDef, const TransitionProfile& profile, double coverage)
+{
+    assert(lexerDef.transitions.layout() == TableLayout::Ranges);
+
+    if (profile.fingerprint() != TransitionProfile::fingerprint(lexerDef))
+        throw TransitionProfile::InvalidProfile { "Profile has been recorded with different lexer tables." };
+
+    // the initial states (including the begin-of-line ones) are addressed by the Machine enum,
+    // so they stay where they are
+    StateId fixed = 0;
+    for (const pair<const string, StateId>& q0: lexerDef.initialStates)
+        fixed = max(fixed, q0.second + 1);
+
+    StateId stateCount = fixed;
+    for (const pair<const StateId, TransitionRanges>& T: lexerDef.transitions.ranges())
+    {
+        stateCount = max(stateCount, T.first + 1);
+        for (const TransitionRanges::Range& r: T.second)
+            stateCount = max(stateCount, r.target + 1);
+    }
+    for (const pair<const StateId, Tag>& accept: lexerDef.acceptStates)
+        stateCount = max(stateCount, accept.first + 1);
+
+    vector<uint64_t> visits(stateCount);
+    for (StateId s = 0; s < stateCount; ++s)
+        visits[s] = profile.visits(s);
+
+    vector<StateId> order(stateCount);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(next(order.begin(), fixed), order.end(), [&](StateId a, StateId b) {
+        return visits[a] > visits[b];
+    });
+
+    // hot states: the fixed ones, plus as many of the most visited ones as needed for the coverage
+    const uint64_t total = accumulate(visits.begin(), visits.end(), uint64_t { 0 });
+    uint64_t covered = accumulate(visits.begin(), next(visits.begin(), fixed), uint64_t { 0 });
+    StateId hotStates = fixed;
+    while (hotStates < stateCount && visits[order[hotStates]] != 0
+           && static_cast<double>(covered) < coverage * static_cast<double>(total))
+        covered += visits[order[hotStates++]];
+
+    vector<StateId> renumbered(stateCount);
+    for (StateId i = 0; i < stateCount; ++i)
+        renumbered[order[i]] = i;
+
+    TransitionMap::Container transitions;
+    for (const pair<const StateId, TransitionRanges>& T: lexerDef.transitions.ranges())
+    {
+        TransitionRanges& ranges = transitions[renumbered[T.first]];
+        for (const TransitionRanges::Range& r: T.second)
+            ranges.define(r.first, r.last, renumbered[r.target]);
+    }
+    lexerDef.transitions = TransitionMap { move(transitions) };
+
+    AcceptStateMap acceptStates;
+    for (const pair<const StateId, Tag>& accept: lexerDef.acceptStates)
+        acceptStates[renumbered[accept.first]] = accept.second;
+    lexerDef.acceptStates = move(acceptStates);
+
+    BacktrackingMap backtrackingStates;
+    for (const pair<const StateId, StateId>& bt: lexerDef.backtrackingStates)
+        backtrackingStates[renumbered[bt.first]] = renumbered[bt.second];
+    lexerDef.backtrackingStates = move(backtrackingStates);
+
+    return hotStates;
+}
+
+} // namespace klex::regular
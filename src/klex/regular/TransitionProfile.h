@@ -0,0 +1,96 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/LexerDef.h>
+#include <klex/regular/State.h>
+#include <klex/regular/Symbols.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace klex::regular {
+
+/**
+ * Transition frequencies of a lexer, as recorded over a representative corpus.
+ *
+ * A profile is bound to the exact tables it has been recorded with, which is verified by
+ * a fingerprint of the transitions when applying it.
+ *
+ * @see renumberStates()
+ */
+class TransitionProfile {
+  public:
+	class InvalidProfile;
+
+	//! Maps (state, symbol) to the number of times the transition has been taken.
+	using CountMap = std::map<std::pair<StateId, Symbol>, uint64_t>;
+
+	TransitionProfile() : fingerprint_{0}, counts_{} {}
+
+	/**
+	 * Lexes @p corpus in the condition @p machine of @p lexerDef and counts every transition taken.
+	 *
+	 * Unrecognized input is skipped byte-wise. The states only reachable from other conditions
+	 * are never visited, and thus end up cold, unless recorded with a corpus of their own.
+	 *
+	 * @throws InvalidProfile if @p lexerDef has no such condition.
+	 */
+	void record(const LexerDef& lexerDef, std::string_view corpus, const std::string& machine = "INITIAL");
+
+	//! Retrieves the number of times the transition (s, c) has been taken.
+	uint64_t count(StateId s, Symbol c) const;
+
+	//! Retrieves the number of transitions taken out of state @p s.
+	uint64_t visits(StateId s) const;
+
+	const CountMap& counts() const noexcept { return counts_; }
+
+	//! Retrieves the fingerprint of the tables this profile has been recorded with.
+	uint64_t fingerprint() const noexcept { return fingerprint_; }
+
+	//! Computes a fingerprint of the transitions of @p lexerDef (which must be in TableLayout::Ranges).
+	static uint64_t fingerprint(const LexerDef& lexerDef);
+
+	//! Writes the profile in a line based text format.
+	void save(std::ostream& os) const;
+
+	//! Reads a profile previousely written by save().
+	static TransitionProfile load(std::istream& is);
+
+  private:
+	uint64_t fingerprint_;
+	CountMap counts_;
+};
+
+class TransitionProfile::InvalidProfile : public std::runtime_error {
+  public:
+	explicit InvalidProfile(const std::string& reason) : std::runtime_error{reason} {}
+};
+
+/**
+ * Renumbers the states of @p lexerDef such that the states most frequently visited in @p profile
+ * come first, in descending order of their visits.
+ *
+ * The initial states (and the begin-of-line states following them) keep their IDs.
+ * The transitions of @p lexerDef must be in TableLayout::Ranges.
+ *
+ * @param coverage fraction of all recorded visits the hot states have to account for
+ *
+ * @returns the number of hot states, i.e. all states below that ID are hot, to be passed on
+ *          to TransitionMap::convert().
+ *
+ * @throws TransitionProfile::InvalidProfile if @p profile has been recorded with different tables.
+ */
+StateId renumberStates(LexerDef& lexerDef, const TransitionProfile& profile, double coverage = 0.99);
+
+}  // namespace klex::regular
@@ -0,0 +1,118 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/TransitionProfile.h>
+#include <klex/regular/test_util.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+namespace
+{
+    const string corpus = "pragma if x1 abcd 42\npragma zzz\n";
+
+    LexerDef compile()
+    {
+        Compiler cc;
+        cc.parse(sampleRules);
+        return cc.compileMulti();
+    }
+
+} // namespace
+
+TEST(regular_TransitionProfile, record)
+{
+    const LexerDef def = compile();
+    TransitionProfile profile;
+    profile.record(def, corpus);
+
+    // "pragma" is started twice at the beginning of a line, via the begin-of-line initial state
+    const StateId q0 = def.initialStates.at("INITIAL");
+    EXPECT_EQ(2, profile.count(q0 + 1, 'p'));
+    EXPECT_EQ(0, profile.count(q0, 'p'));
+    EXPECT_EQ(1, profile.count(q0 + 1, Symbols::EndOfFile)); // after the trailing newline
+    EXPECT_TRUE(profile.visits(q0) > profile.visits(q0 + 1));
+
+    // the EOF symbol is fed once, leaving no transitions out of the state accepting it
+    EXPECT_EQ(0, profile.visits(def.transitions.apply(q0 + 1, Symbols::EndOfFile)));
+}
+
+TEST(regular_TransitionProfile, record_condition)
+{
+    Compiler cc;
+    cc.parse(R"(|Eof              ::= <<EOF>>
+                |Space(ignore)    ::= [\s\t\n]+
+                |Ident            ::= [a-z]+
+                |<Asm>Jump        ::= jmp)"_multiline);
+    const LexerDef def = cc.compileMulti();
+
+    TransitionProfile initial;
+    initial.record(def, "jmp");
+    EXPECT_EQ(0, initial.visits(def.initialStates.at("Asm")));
+
+    TransitionProfile asm_;
+    asm_.record(def, "jmp", "Asm");
+    EXPECT_EQ(1, asm_.count(def.initialStates.at("Asm"), 'j'));
+    EXPECT_EQ(0, asm_.visits(def.initialStates.at("INITIAL")));
+
+    EXPECT_THROW(initial.record(def, "jmp", "Unknown"), TransitionProfile::InvalidProfile);
+}
+
+TEST(regular_TransitionProfile, save_and_load)
+{
+    TransitionProfile profile;
+    profile.record(compile(), corpus);
+
+    stringstream sstr;
+    profile.save(sstr);
+    const TransitionProfile loaded = TransitionProfile::load(sstr);
+    EXPECT_EQ(profile.fingerprint(), loaded.fingerprint());
+    EXPECT_TRUE(profile.counts() == loaded.counts());
+
+    stringstream garbage { "klex-profile 1\nfingerprint 1234\n1 2\n" };
+    EXPECT_THROW(TransitionProfile::load(garbage), TransitionProfile::InvalidProfile);
+}
+
+TEST(regular_TransitionProfile, renumber)
+{
+    const LexerDef reference = compile();
+    TransitionProfile profile;
+    profile.record(reference, corpus);
+
+    LexerDef def = compile();
+    const StateId hotStates = renumberStates(def, profile);
+    EXPECT_TRUE(def.initialStates == reference.initialStates);
+    EXPECT_TRUE(hotStates < def.transitions.states().size());
+
+    // a profile only applies to the tables it has been recorded with
+    EXPECT_THROW(renumberStates(def, profile), TransitionProfile::InvalidProfile);
+
+    // hot states come first, in order of their visits
+    TransitionProfile renumbered;
+    renumbered.record(def, corpus);
+    for (StateId s = def.initialStates.at("INITIAL_0") + 2; s < hotStates; ++s)
+        EXPECT_TRUE(renumbered.visits(s - 1) >= renumbered.visits(s));
+    for (StateId s = hotStates; s < def.transitions.states().size(); ++s)
+        EXPECT_TRUE(renumbered.visits(s) <= renumbered.visits(hotStates - 1));
+
+    // split into hot and cold states, lexing just like before
+    def.transitions.convert(TableLayout::Dense, hotStates);
+    EXPECT_EQ(hotStates, def.transitions.hotStates());
+    EXPECT_TRUE(!def.transitions.ranges().empty());
+    EXPECT_TRUE(def.transitions.dense()->stateCount() <= hotStates);
+
+    // the sample input also visits states the corpus has left cold
+    expectSameTokens(reference, def, sampleInput);
+}
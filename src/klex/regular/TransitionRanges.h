@@ -0,0 +1,174 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/State.h>
+#include <klex/regular/Symbols.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <optional>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Outgoing transitions of a single deterministic state, stored as sorted, non-overlapping symbol
+ * ranges [first, last], each mapping to a target state.
+ *
+ * Adjacent ranges leading to the same target are merged as they are defined, such that e.g.
+ * a transition on any character (.) costs a handful of ranges rather than one entry per symbol.
+ */
+class TransitionRanges {
+  public:
+	struct Range {
+		Symbol first;
+		Symbol last;
+		StateId target;
+
+		bool operator==(const Range& other) const noexcept
+		{
+			return first == other.first && last == other.last && target == other.target;
+		}
+	};
+
+	using Container = std::vector<Range>;
+	using iterator = Container::iterator;
+	using const_iterator = Container::const_iterator;
+
+	TransitionRanges() = default;
+
+	//! Constructs the transitions from the given sorted, non-overlapping @p ranges.
+	TransitionRanges(std::initializer_list<Range> ranges) : ranges_{ranges} {}
+
+	bool empty() const noexcept { return ranges_.empty(); }
+	size_t size() const noexcept { return ranges_.size(); }
+
+	iterator begin() { return ranges_.begin(); }
+	iterator end() { return ranges_.end(); }
+	const_iterator begin() const { return ranges_.begin(); }
+	const_iterator end() const { return ranges_.end(); }
+
+	//! Retrieves the target state on symbol @p s, if any.
+	std::optional<StateId> find(Symbol s) const
+	{
+		if (const Range* r = lookup(s); r != nullptr)
+			return r->target;
+
+		return std::nullopt;
+	}
+
+	//! Defines the transition on all symbols in [@p first, @p last] to @p target.
+	void define(Symbol first, Symbol last, StateId target);
+
+	//! Defines the transition on symbol @p s to @p target.
+	void define(Symbol s, StateId target) { define(s, s, target); }
+
+	//! Removes the transition on symbol @p s, if any.
+	void remove(Symbol s);
+
+	//! Merges adjacent ranges leading to the same target, e.g. after targets have been rewritten.
+	void compact();
+
+	bool operator==(const TransitionRanges& other) const noexcept { return ranges_ == other.ranges_; }
+	bool operator!=(const TransitionRanges& other) const noexcept { return !(*this == other); }
+
+  private:
+	const Range* lookup(Symbol s) const
+	{
+		// the last range starting at or before s
+		auto i = std::upper_bound(ranges_.begin(), ranges_.end(), s,
+								  [](Symbol s, const Range& r) { return s < r.first; });
+		if (i == ranges_.begin())
+			return nullptr;
+
+		--i;
+		return s <= i->last ? &*i : nullptr;
+	}
+
+	static bool adjacent(const Range& a, const Range& b) noexcept
+	{
+		return a.target == b.target && static_cast<long>(a.last) + 1 == static_cast<long>(b.first);
+	}
+
+  private:
+	Container ranges_;
+};
+
+inline void TransitionRanges::define(Symbol first, Symbol last, StateId target)
+{
+	// fast path: ranges are usually defined in ascending order
+	if (ranges_.empty() || ranges_.back().last < first)
+	{
+		if (!ranges_.empty() && adjacent(ranges_.back(), Range{first, last, target}))
+			ranges_.back().last = last;
+		else
+			ranges_.push_back(Range{first, last, target});
+		return;
+	}
+
+	// cut [first, last] out of all overlapping ranges, then insert it
+	Container result;
+	result.reserve(ranges_.size() + 2);
+	for (const Range& r : ranges_)
+	{
+		if (r.last < first || r.first > last)
+			result.push_back(r);
+		else
+		{
+			if (r.first < first)
+				result.push_back(Range{r.first, first - 1, r.target});
+			if (r.last > last)
+				result.push_back(Range{last + 1, r.last, r.target});
+		}
+	}
+
+	auto i = std::lower_bound(result.begin(), result.end(), first,
+							  [](const Range& r, Symbol s) { return r.first < s; });
+	result.insert(i, Range{first, last, target});
+	ranges_ = std::move(result);
+	compact();
+}
+
+inline void TransitionRanges::remove(Symbol s)
+{
+	auto i = std::find_if(ranges_.begin(), ranges_.end(),
+						  [s](const Range& r) { return r.first <= s && s <= r.last; });
+	if (i == ranges_.end())
+		return;
+
+	if (i->first == s && i->last == s)
+		ranges_.erase(i);
+	else if (i->first == s)
+		i->first++;
+	else if (i->last == s)
+		i->last--;
+	else
+	{
+		const Range tail{s + 1, i->last, i->target};
+		i->last = s - 1;
+		ranges_.insert(std::next(i), tail);
+	}
+}
+
+inline void TransitionRanges::compact()
+{
+	if (ranges_.empty())
+		return;
+
+	size_t k = 0;
+	for (size_t i = 1; i < ranges_.size(); ++i)
+	{
+		if (adjacent(ranges_[k], ranges_[i]))
+			ranges_[k].last = ranges_[i].last;
+		else
+			ranges_[++k] = ranges_[i];
+	}
+	ranges_.resize(k + 1);
+}
+
+}  // namespace klex::regular
@@ -0,0 +1,90 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/DFA.h>
+#include <klex/regular/TransitionRanges.h>
+#include <klex/util/literals.h>
+#include <klex/util/testing.h>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util::literals;
+
+using Range = TransitionRanges::Range;
+
+TEST(regular_TransitionRanges, define_ascending)
+{
+    TransitionRanges T;
+    for (Symbol c = 'a'; c <= 'z'; ++c)
+        T.define(c, 1);
+    T.define('0', '9', 2); // out of order
+    T.define('_', 1);
+
+    ASSERT_EQ(3, T.size());
+    EXPECT_TRUE(*T.begin() == (Range { '0', '9', 2 }));
+    EXPECT_TRUE(*next(T.begin(), 1) == (Range { '_', '_', 1 }));
+    EXPECT_TRUE(*next(T.begin(), 2) == (Range { 'a', 'z', 1 }));
+
+    EXPECT_EQ(2, *T.find('5'));
+    EXPECT_EQ(1, *T.find('q'));
+    EXPECT_FALSE(T.find('A').has_value());
+    EXPECT_FALSE(T.find('`').has_value());
+}
+
+TEST(regular_TransitionRanges, define_overlapping)
+{
+    TransitionRanges T;
+    T.define('a', 'z', 1);
+    T.define('m', 'p', 2);
+
+    ASSERT_EQ(3, T.size());
+    EXPECT_EQ(1, *T.find('l'));
+    EXPECT_EQ(2, *T.find('m'));
+    EXPECT_EQ(2, *T.find('p'));
+    EXPECT_EQ(1, *T.find('q'));
+
+    // overwriting it back merges all into one range again
+    T.define('m', 'p', 1);
+    ASSERT_EQ(1, T.size());
+    EXPECT_TRUE(*T.begin() == (Range { 'a', 'z', 1 }));
+}
+
+TEST(regular_TransitionRanges, remove)
+{
+    TransitionRanges T { { 'a', 'z', 1 } };
+    T.remove('a');
+    T.remove('z');
+    T.remove('m');
+    T.remove('0'); // not present
+
+    ASSERT_EQ(2, T.size());
+    EXPECT_TRUE(*T.begin() == (Range { 'b', 'l', 1 }));
+    EXPECT_TRUE(*next(T.begin()) == (Range { 'n', 'y', 1 }));
+    EXPECT_FALSE(T.find('m').has_value());
+}
+
+TEST(regular_TransitionRanges, dfa_any_character)
+{
+    Compiler cc;
+    cc.parse(R"(|Eof     ::= <<EOF>>
+                |Comment ::= #.*
+                |)"_multiline);
+    const DFA dfa = cc.compileMinimalDFA();
+
+    // all transitions of .* (that is \t and the printable ASCII characters) collapse into two ranges
+    for (StateId s = 0; s < dfa.size(); ++s)
+        EXPECT_TRUE(dfa.stateTransitions(s).size() <= 2);
+
+    const LexerDef def = Compiler::generateTables(dfa, false, cc.names());
+    const StateId q1 = def.transitions.apply(def.initialStates.at("INITIAL"), '#');
+    ASSERT_TRUE(q1 != ErrorState);
+    EXPECT_EQ(q1, def.transitions.apply(q1, 'x'));
+    EXPECT_EQ(q1, def.transitions.apply(q1, '\t'));
+    EXPECT_EQ(q1, def.transitions.apply(q1, '~'));
+    EXPECT_EQ(ErrorState, def.transitions.apply(q1, '\n'));
+}
@@ -0,0 +1,120 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <klex/regular/BitParallelNFA.h>
+#include <klex/regular/LazyDFA.h>
+#include <klex/regular/Lexable.h>
+#include <klex/regular/LexerDef.h>
+#include <klex/util/testing.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace klex::regular {
+
+/**
+ * Rules the different lexer constructions are compared by, covering begin-of-line, trailing context,
+ * end-of-line, bounded repetition, and literals that share their prefixes with other rules.
+ */
+inline const std::string sampleRules = R"(
+	Spacing(ignore)  ::= [\s\t\n]+
+	Eof              ::= <<EOF>>
+	Pragma           ::= ^pragma
+	If               ::= if
+	Else             ::= else
+	ABBA             ::= abba
+	AB_CD            ::= ab/cd
+	CD               ::= cd
+	CDEF             ::= cdef
+	EOL_LF           ::= eol$
+	Number           ::= [0-9]{2,3}
+	Ident            ::= [a-z][a-z0-9]*
+)";
+
+//! Input to sampleRules, exercising each of them.
+inline const std::string sampleInput = "pragma if abba abcd cdef eol\n123\npragma else 99 xyz\n";
+
+/**
+ * Splits @p input into its tokens by the lexer @p ld, up to and including the Eof token (tag 1),
+ * for tests to compare the outcome of different lexer constructions.
+ *
+ * The Eof token's literal is left empty, as it is the EOF symbol itself.
+ */
+inline std::vector<std::pair<Tag, std::string>> tokenize(const LexerDef& ld, const std::string& input)
+{
+	std::vector<std::pair<Tag, std::string>> tokens;
+	Lexable<Tag, StateId, true, false> ls{ld, input};
+	for (auto i = begin(ls), e = end(ls); i != e; ++i)
+	{
+		if (token(i) == 1)
+		{
+			tokens.emplace_back(token(i), "");
+			break;
+		}
+		tokens.emplace_back(token(i), literal(i));
+	}
+	return tokens;
+}
+
+namespace detail {
+	template <typename Matcher>
+	std::vector<std::pair<Tag, std::string>> tokenizeMatches(Matcher& matcher, const std::string& input)
+	{
+		std::vector<std::pair<Tag, std::string>> tokens;
+		size_t offset = 0;
+		for (;;)
+		{
+			const bool bol = offset == 0 || input[offset - 1] == '\n';
+			const auto match = matcher.recognize(std::string_view{input}.substr(offset), bol);
+			if (!match.has_value())
+				break;
+			if (match->tag != IgnoreTag)
+				tokens.emplace_back(match->tag, input.substr(offset, match->length));
+			if (match->tag == 1)  // Eof
+				break;
+			offset += match->length;
+		}
+		return tokens;
+	}
+}  // namespace detail
+
+//! Splits @p input into its tokens by the lazily constructed DFA @p lazy, just like the above.
+inline std::vector<std::pair<Tag, std::string>> tokenize(LazyDFA& lazy, const std::string& input)
+{
+	return detail::tokenizeMatches(lazy, input);
+}
+
+//! Splits @p input into its tokens by the bit-parallel NFA simulation @p bp, just like the above.
+inline std::vector<std::pair<Tag, std::string>> tokenize(const BitParallelNFA& bp, const std::string& input)
+{
+	return detail::tokenizeMatches(bp, input);
+}
+
+/**
+ * Expects @p candidate to split @p input into the very same tokens as @p reference does, which
+ * in turn must recognize all of @p input, up to its Eof token.
+ */
+template <typename Reference, typename Candidate>
+void expectSameTokens(Reference&& reference, Candidate&& candidate, const std::string& input)
+{
+	const auto expected = tokenize(reference, input);
+	const auto actual = tokenize(candidate, input);
+
+	ASSERT_TRUE(!expected.empty() && expected.back().first == 1);
+	ASSERT_EQ(expected.size(), actual.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		EXPECT_EQ(expected[i].first, actual[i].first);
+		EXPECT_EQ(expected[i].second, actual[i].second);
+	}
+}
+
+}  // namespace klex::regular
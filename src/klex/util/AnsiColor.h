@@ -7,6 +7,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 namespace AnsiColor {
 
@@ -103,8 +104,8 @@ constexpr auto codes()
 {
     std::array<char, capacity(value) + 3 + (EOS ? 1 : 0)> result{};
 
-    size_t n = 0;  // n'th escape sequence being iterate through
-    size_t i = 0;  // i'th byte in output array
+    std::size_t n = 0;  // n'th escape sequence being iterate through
+    std::size_t i = 0;  // i'th byte in output array
 
     result[i++] = '\x1B';
     result[i++] = '[';
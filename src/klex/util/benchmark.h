@@ -0,0 +1,64 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+namespace klex::util {
+
+//! Retrieves the peak resident set size of this process so far, in bytes (0 if unsupported).
+inline size_t peakResidentSetSize()
+{
+#if defined(_WIN32)
+	return 0;
+#else
+	struct rusage usage {};
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return static_cast<size_t>(usage.ru_maxrss);
+#else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+//! Quotes @p s as a JSON string literal.
+inline std::string jsonString(std::string_view s)
+{
+	std::string out = "\"";
+	for (const char ch : s)
+	{
+		switch (ch)
+		{
+			case '"':
+				out += "\\\"";
+				break;
+			case '\\':
+				out += "\\\\";
+				break;
+			case '\n':
+				out += "\\n";
+				break;
+			default:
+				if (static_cast<unsigned char>(ch) < 0x20)
+					out += fmt::format("\\u{:04x}", static_cast<unsigned>(ch));
+				else
+					out += ch;
+		}
+	}
+	return out + '"';
+}
+
+}  // namespace klex::util
@@ -0,0 +1,36 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace klex::util {
+
+//! Retrieves the index of the least significant bit set in @p word, which must not be 0.
+inline unsigned countTrailingZeros(uint64_t word)
+{
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+#if defined(_M_X64) || defined(_M_ARM64)
+	_BitScanForward64(&index, word);
+#else
+	if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+		return static_cast<unsigned>(index);
+	_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+	index += 32;
+#endif
+	return static_cast<unsigned>(index);
+#else
+	return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+}
+
+}  // namespace klex::util
@@ -0,0 +1,80 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/util/heap_tracking.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace
+{
+    // every allocation is prefixed with its size, such that operator delete can account for it
+    constexpr size_t HeaderSize = alignof(max_align_t);
+
+    atomic<size_t> allocationCount { 0 };
+    atomic<size_t> heapCurrent { 0 };
+    atomic<size_t> heapPeak { 0 };
+} // namespace
+
+void* operator new(size_t size)
+{
+    void* p = malloc(size + HeaderSize);
+    if (p == nullptr)
+        throw bad_alloc {};
+
+    *static_cast<size_t*>(p) = size;
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    const size_t current = heapCurrent.fetch_add(size, memory_order_relaxed) + size;
+    if (current > heapPeak.load(memory_order_relaxed))
+        heapPeak.store(current, memory_order_relaxed);
+
+    return static_cast<char*>(p) + HeaderSize;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    void* base = static_cast<char*>(p) - HeaderSize;
+    heapCurrent.fetch_sub(*static_cast<size_t*>(base), memory_order_relaxed);
+    free(base);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+namespace klex::util
+{
+
+size_t heapAllocationCount()
+{
+    return allocationCount.load(memory_order_relaxed);
+}
+
+size_t heapCurrentSize()
+{
+    return heapCurrent.load(memory_order_relaxed);
+}
+
+size_t heapPeakSize()
+{
+    return heapPeak.load(memory_order_relaxed);
+}
+
+void resetHeapPeakSize()
+{
+    heapPeak.store(heapCurrent.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+} // namespace klex::util
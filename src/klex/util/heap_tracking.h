@@ -0,0 +1,28 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+#pragma once
+
+#include <cstddef>
+
+// Heap statistics as gathered by the global operator new/delete replacements in heap_tracking.cpp,
+// which only those executables that link it in (the benchmarks) get.
+
+namespace klex::util {
+
+//! Retrieves the number of allocations made so far.
+size_t heapAllocationCount();
+
+//! Retrieves the number of bytes currently allocated.
+size_t heapCurrentSize();
+
+//! Retrieves the highest number of bytes allocated at once since the last resetHeapPeakSize().
+size_t heapPeakSize();
+
+//! Lowers the peak heap size to what is currently allocated, e.g. before measuring a single run.
+void resetHeapPeakSize();
+
+}  // namespace klex::util
@@ -7,14 +7,18 @@
 
 #include <klex/util/AnsiColor.h>
 #include <klex/util/Flags.h>
+#include <klex/util/benchmark.h>
 #include <klex/util/testing.h>
 
 #include <fmt/format.h>
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <numeric>
 #include <random>
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -49,6 +53,35 @@ bool beginsWith(const string& str, const string_view& prefix)
     return string_view(&str[0], prefix.length()) == prefix;
 }
 
+bool matchesGlob(const string& glob, const string& name)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return PathMatchSpec(name.c_str(), glob.c_str()) == TRUE;
+#else
+    return fnmatch(glob.c_str(), name.c_str(), 0) == 0;
+#endif
+}
+
+string formatDuration(double nanoseconds)
+{
+    if (nanoseconds < 1e3)
+        return fmt::format("{:.1f} ns", nanoseconds);
+    if (nanoseconds < 1e6)
+        return fmt::format("{:.2f} us", nanoseconds / 1e3);
+    if (nanoseconds < 1e9)
+        return fmt::format("{:.2f} ms", nanoseconds / 1e6);
+    return fmt::format("{:.2f} s", nanoseconds / 1e9);
+}
+
+//! Runs the given number of iterations of @p benchmark and returns the elapsed time in seconds.
+double measure(Benchmark& benchmark, size_t iterations)
+{
+    const auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        benchmark.BenchmarkBody();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
 // ############################################################################
 
 class BailOutException
@@ -97,6 +130,20 @@ void Test::reportUnhandledException(const exception& e)
 
 // ############################################################################
 
+Benchmark::~Benchmark()
+{
+}
+
+void Benchmark::SetUp()
+{
+}
+
+void Benchmark::TearDown()
+{
+}
+
+// ############################################################################
+
 TestInfo::TestInfo(const string& testCaseName,
                    const string& testName,
                    bool enabled,
@@ -105,12 +152,25 @@ TestInfo::TestInfo(const string& testCaseName,
 {
 }
 
+BenchmarkInfo::BenchmarkInfo(const string& benchCaseName,
+                             const string& benchName,
+                             unique_ptr<BenchmarkFactory>&& benchFactory):
+    benchCaseName_(benchCaseName), benchName_(benchName), benchFactory_(move(benchFactory))
+{
+}
+
 // ############################################################################
 
 UnitTest::UnitTest():
     environments_(),
     testCases_(),
     activeTests_(),
+    benchmarks_(),
+    activeBenchmarks_(),
+    benchmarkResults_(),
+    benchmarkSamples_(30),
+    benchmarkTime_(0.25),
+    benchmarkWarmup_(0.05),
     repeats_(1),
     printProgress_(false),
     printSummaryDetails_(true),
@@ -194,7 +254,20 @@ int UnitTest::main(int argc, const char* argv[])
         .defineBool("randomize", 'R', "Randomizes test order.")
         .defineBool("sort", 's', "Sorts tests alphabetically ascending.")
         .defineBool("no-progress", 0, "Avoids printing progress.")
-        .defineNumber("repeat", 'r', "COUNT", "Repeat tests given number of times.", 1);
+        .defineNumber("repeat", 'r', "COUNT", "Repeat tests given number of times.", 1)
+        .defineString("benchmark",
+                      'b',
+                      "GLOB",
+                      "Runs the benchmarks matching the given glob instead of the tests.",
+                      "")
+        .defineNumber("benchmark-samples", 0, "COUNT", "Number of timing samples per benchmark.", 30)
+        .defineNumber("benchmark-time", 0, "MSECS", "Minimum measuring time per benchmark.", 250)
+        .defineNumber("benchmark-warmup", 0, "MSECS", "Warm-up time per benchmark.", 50)
+        .defineString("benchmark-json",
+                      0,
+                      "FILE",
+                      "Writes the benchmark results as JSON to the given file (use - for stdout).",
+                      "");
 
     try
     {
@@ -219,6 +292,33 @@ int UnitTest::main(int argc, const char* argv[])
     repeats_ = flags.getNumber("repeat");
     printProgress_ = !flags.getBool("no-progress");
 
+    if (const string benchmark = flags.getString("benchmark"); !benchmark.empty())
+    {
+        benchmarkSamples_ = static_cast<size_t>(max(1l, flags.getNumber("benchmark-samples")));
+        benchmarkTime_ = static_cast<double>(max(0l, flags.getNumber("benchmark-time"))) / 1000;
+        benchmarkWarmup_ = static_cast<double>(max(0l, flags.getNumber("benchmark-warmup"))) / 1000;
+
+        filterBenchmarks(benchmark, exclude);
+
+        if (flags.getBool("list"))
+        {
+            printBenchmarkList();
+            return EXIT_SUCCESS;
+        }
+
+        runBenchmarks();
+
+        if (const string output = flags.getString("benchmark-json"); output == "-")
+            writeBenchmarkReport(cout);
+        else if (!output.empty())
+        {
+            ofstream out { output };
+            writeBenchmarkReport(out);
+        }
+
+        return failCount_ == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (flags.getBool("randomize"))
         randomizeTestOrder();
     else if (flags.getBool("sort"))
@@ -247,25 +347,30 @@ void UnitTest::filterTests(const string& filter, const string& exclude)
         TestInfo* testInfo = testCases_[activeTests_[i]].get();
         string matchName = fmt::format("{}.{}", testInfo->testCaseName(), testInfo->testName());
 
-#if defined(_WIN32) || defined(_WIN64)
-        if (!exclude.empty() && PathMatchSpec(matchName.c_str(), exclude.c_str()) == TRUE)
+        if (!exclude.empty() && matchesGlob(exclude, matchName))
             continue; // exclude this one
 
-        if (PathMatchSpec(matchName.c_str(), filter.c_str()) == TRUE)
+        if (matchesGlob(filter, matchName))
             filtered.push_back(activeTests_[i]);
-#else
-        const int flags = 0;
+    }
+    activeTests_ = move(filtered);
+}
+
+void UnitTest::filterBenchmarks(const string& filter, const string& exclude)
+{
+    vector<size_t> filtered;
+    for (size_t i: activeBenchmarks_)
+    {
+        BenchmarkInfo* info = benchmarks_[i].get();
+        string matchName = fmt::format("{}.{}", info->benchCaseName(), info->benchName());
 
-        if (!exclude.empty() && fnmatch(exclude.c_str(), matchName.c_str(), flags) == 0)
+        if (!exclude.empty() && matchesGlob(exclude, matchName))
             continue; // exclude this one
 
-        if (fnmatch(filter.c_str(), matchName.c_str(), flags) == 0)
-        {
-            filtered.push_back(activeTests_[i]);
-        }
-#endif
+        if (matchesGlob(filter, matchName))
+            filtered.push_back(i);
     }
-    activeTests_ = move(filtered);
+    activeBenchmarks_ = move(filtered);
 }
 
 void UnitTest::run()
@@ -302,6 +407,168 @@ void UnitTest::printTestList()
     }
 }
 
+void UnitTest::printBenchmarkList()
+{
+    for (size_t i = 0, e = activeBenchmarks_.size(); i != e; ++i)
+    {
+        BenchmarkInfo* info = benchmarks_[activeBenchmarks_[i]].get();
+        printf("%4zu. %s.%s\n", i + 1, info->benchCaseName().c_str(), info->benchName().c_str());
+    }
+}
+
+void UnitTest::runBenchmarks()
+{
+    for (auto& env: environments_)
+    {
+        env->SetUp();
+    }
+
+    for (auto& init: initializers_)
+    {
+        init->invoke();
+    }
+
+    size_t succeeded = 0;
+    for (size_t i: activeBenchmarks_)
+    {
+        if (runBenchmark(benchmarks_[i].get()))
+            succeeded++;
+    }
+
+    for (auto& env: environments_)
+    {
+        env->TearDown();
+    }
+
+    fmt::print("{}Finished running {} benchmarks. {} success, {} failed.{}\n",
+               failCount_ ? colorsError.data() : colorsOk.data(),
+               activeBenchmarks_.size(),
+               succeeded,
+               activeBenchmarks_.size() - succeeded,
+               colorsReset.data());
+
+    printFailures();
+}
+
+bool UnitTest::runBenchmark(BenchmarkInfo* info)
+{
+    const string name = fmt::format("{}.{}", info->benchCaseName(), info->benchName());
+    if (printProgress_)
+        fmt::print("{}Running benchmark: {}{}\n", colorsTestCaseHeader.data(), name, colorsReset.data());
+
+    currentTestCase_ = nullptr;
+    const int failCount = failCount_;
+    unique_ptr<Benchmark> benchmark = info->createBenchmark();
+    vector<double> samples(benchmarkSamples_); // nanoseconds per iteration
+    size_t iterations = 1;
+    bool setUp = false;
+
+    try
+    {
+        benchmark->SetUp();
+        setUp = true;
+
+        // warm up, while calibrating the iterations per sample such that a sample takes
+        // at least its share of the measuring time
+        const double sampleTime = benchmarkTime_ / benchmarkSamples_;
+        for (double warmup = 0;;)
+        {
+            const double elapsed = measure(*benchmark, iterations);
+            warmup += elapsed;
+            if (elapsed >= sampleTime && warmup >= benchmarkWarmup_)
+                break;
+
+            if (elapsed < sampleTime)
+                iterations = elapsed * 10 <= sampleTime
+                                 ? iterations * 10
+                                 : static_cast<size_t>(ceil(iterations * sampleTime * 1.1 / elapsed));
+        }
+
+        for (double& sample: samples)
+            sample = measure(*benchmark, iterations) * 1e9 / iterations;
+    }
+    catch (const BailOutException&)
+    {
+        // no-op
+    }
+    catch (const exception& ex)
+    {
+        reportUnhandledException(ex);
+    }
+    catch (...)
+    {
+        reportMessage("Unhandled exception caught in benchmark.", false);
+    }
+
+    try
+    {
+        if (setUp)
+            benchmark->TearDown();
+    }
+    catch (...)
+    {
+        reportMessage("Unhandled exception caught in benchmark tear-down.", false);
+    }
+
+    if (failCount_ != failCount)
+        return false;
+
+    sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+
+    BenchmarkResult result;
+    result.name = name;
+    result.samples = n;
+    result.iterations = iterations;
+    result.min = samples.front();
+    result.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    result.p99 = samples[static_cast<size_t>(ceil(n * 0.99)) - 1];
+    result.mean = accumulate(samples.begin(), samples.end(), 0.0) / n;
+    result.bytesProcessed = benchmark->bytesProcessed();
+
+    fmt::print("{:<48} median {:>10}, min {:>10}, p99 {:>10} ({} x {} iterations)",
+               result.name,
+               formatDuration(result.median),
+               formatDuration(result.min),
+               formatDuration(result.p99),
+               result.samples,
+               result.iterations);
+    if (result.bytesProcessed)
+        fmt::print(", {:.2f} MB/s", result.bytesPerSecond() / (1024 * 1024));
+    fmt::print("\n");
+
+    benchmarkResults_.emplace_back(move(result));
+    return true;
+}
+
+void UnitTest::writeBenchmarkReport(ostream& os) const
+{
+    os << "{\n";
+    os << fmt::format("  \"samples\": {},\n", benchmarkSamples_);
+    os << fmt::format("  \"minTime\": {:.3f},\n", benchmarkTime_);
+    os << "  \"benchmarks\": [";
+    for (size_t i = 0; i < benchmarkResults_.size(); ++i)
+    {
+        const BenchmarkResult& r = benchmarkResults_[i];
+        os << (i ? ",\n" : "\n") << "    {";
+        os << fmt::format("\"name\": {}, \"samples\": {}, \"iterations\": {}, \"minNs\": {:.3f}, "
+                          "\"medianNs\": {:.3f}, \"p99Ns\": {:.3f}, \"meanNs\": {:.3f}",
+                          jsonString(r.name),
+                          r.samples,
+                          r.iterations,
+                          r.min,
+                          r.median,
+                          r.p99,
+                          r.mean);
+        if (r.bytesProcessed)
+            os << fmt::format(", \"bytes\": {}, \"mbPerSecond\": {:.2f}",
+                              r.bytesProcessed,
+                              r.bytesPerSecond() / (1024 * 1024));
+        os << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
 void UnitTest::printSummary()
 {
     // print summary
@@ -314,6 +581,11 @@ void UnitTest::printSummary()
                disabledCount(),
                colorsReset.data());
 
+    printFailures();
+}
+
+void UnitTest::printFailures()
+{
     if (printSummaryDetails_ && !failures_.empty())
     {
         printf("================================\n");
@@ -583,6 +855,16 @@ TestInfo* UnitTest::addTest(const char* testCaseName,
     return testCases_.back().get();
 }
 
+BenchmarkInfo* UnitTest::addBenchmark(const char* benchCaseName,
+                                      const char* benchName,
+                                      unique_ptr<BenchmarkFactory>&& benchFactory)
+{
+    benchmarks_.emplace_back(make_unique<BenchmarkInfo>(benchCaseName, benchName, move(benchFactory)));
+    activeBenchmarks_.emplace_back(activeBenchmarks_.size());
+
+    return benchmarks_.back().get();
+}
+
 void UnitTest::log(const string& message)
 {
     if (verbose_)
@@ -595,12 +877,15 @@ void UnitTest::log(const string& message)
             string line = message.substr(bol, eol - bol);
             if (eol + 1 < message.size() || (!line.empty() && line != "\n"))
             {
-                fmt::print("{}{}.{}:{} {}\n",
-                           colorsLog.data(),
-                           currentTestCase_->testCaseName(),
-                           currentTestCase_->testName(),
-                           colorsReset.data(),
-                           line);
+                if (!currentTestCase_) // running a benchmark
+                    fmt::print("{}\n", line);
+                else
+                    fmt::print("{}{}.{}:{} {}\n",
+                               colorsLog.data(),
+                               currentTestCase_->testCaseName(),
+                               currentTestCase_->testName(),
+                               colorsReset.data(),
+                               line);
             }
             bol = eol + 1;
         } while (eol != string::npos);
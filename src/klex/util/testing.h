@@ -12,6 +12,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <iosfwd>
 
 namespace klex::util::testing {
 
@@ -43,6 +44,11 @@ namespace klex::util::testing {
 #define TEST(testCase, testName) _CREATE_TEST(testCase, testName, ::klex::util::testing::Test)
 #define TEST_F(testFixture, testName) _CREATE_TEST(testFixture, testName, testFixture)
 
+#define BENCHMARK(benchCase, benchName) \
+  _CREATE_BENCHMARK(benchCase, benchName, ::klex::util::testing::Benchmark)
+#define BENCHMARK_F(benchFixture, benchName) \
+  _CREATE_BENCHMARK(benchFixture, benchName, benchFixture)
+
 #define EXPECT_EQ(expected, actual) \
   _EXPECT_BINARY(__FILE__, __LINE__, false, expected, actual, ==)
 
@@ -237,6 +243,30 @@ _TEST_CLASS_NAME(testCaseName, testName)::test_info_ =                        \
                                                                               \
 void _TEST_CLASS_NAME(testCaseName, testName)::TestBody()
 
+#define _BENCHMARK_CLASS_NAME(benchCaseName, benchName) \
+  Benchmark_##benchCaseName##benchName
+
+#define _CREATE_BENCHMARK(benchCaseName, benchName, ParentClass)              \
+class _BENCHMARK_CLASS_NAME(benchCaseName, benchName) : public ParentClass {  \
+ public:                                                                      \
+  _BENCHMARK_CLASS_NAME(benchCaseName, benchName)() {}                        \
+                                                                              \
+ private:                                                                     \
+  virtual void BenchmarkBody();                                               \
+                                                                              \
+  static ::klex::util::testing::BenchmarkInfo* const benchmark_info_;         \
+};                                                                            \
+                                                                              \
+::klex::util::testing::BenchmarkInfo* const                                   \
+_BENCHMARK_CLASS_NAME(benchCaseName, benchName)::benchmark_info_ =            \
+    ::klex::util::testing::UnitTest::instance()->addBenchmark(                \
+        #benchCaseName, #benchName,                                           \
+        std::make_unique<                                                     \
+            ::klex::util::testing::BenchmarkFactoryTemplate<                  \
+                _BENCHMARK_CLASS_NAME(benchCaseName, benchName)>>());         \
+                                                                              \
+void _BENCHMARK_CLASS_NAME(benchCaseName, benchName)::BenchmarkBody()
+
 // ############################################################################
 
 int main(int argc, const char* argv[]);
@@ -327,6 +357,101 @@ class TestInfo {
   std::unique_ptr<TestFactory> testFactory_;
 };
 
+/**
+ * interface to a single micro-benchmark.
+ *
+ * SetUp() and TearDown() are invoked once, BenchmarkBody() once per iteration.
+ */
+class Benchmark {
+ public:
+  virtual ~Benchmark();
+
+  virtual void SetUp();
+  virtual void BenchmarkBody() = 0;
+  virtual void TearDown();
+
+  //! Declares the number of bytes a single iteration processes, to report the throughput.
+  void setBytesProcessed(size_t bytes) { bytesProcessed_ = bytes; }
+  size_t bytesProcessed() const noexcept { return bytesProcessed_; }
+
+ private:
+  size_t bytesProcessed_ = 0;
+};
+
+/**
+ * Prevents the compiler from optimizing away the computation of @p value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * API to create one kind of a benchmark.
+ */
+class BenchmarkFactory {
+  BenchmarkFactory(const BenchmarkFactory&) = delete;
+  BenchmarkFactory& operator=(const BenchmarkFactory&) = delete;
+
+ public:
+  BenchmarkFactory() {}
+  virtual ~BenchmarkFactory() {}
+  virtual std::unique_ptr<Benchmark> createBenchmark() = 0;
+};
+
+template<typename TheBenchmarkClass>
+class BenchmarkFactoryTemplate : public BenchmarkFactory {
+ public:
+  std::unique_ptr<Benchmark> createBenchmark() override {
+    return std::make_unique<TheBenchmarkClass>();
+  }
+};
+
+/**
+ * BenchmarkInfo describes a single benchmark.
+ */
+class BenchmarkInfo {
+  BenchmarkInfo(const BenchmarkInfo&) = delete;
+  BenchmarkInfo& operator=(const BenchmarkInfo&) = delete;
+
+ public:
+  BenchmarkInfo(const std::string& benchCaseName,
+                const std::string& benchName,
+                std::unique_ptr<BenchmarkFactory>&& benchFactory);
+
+  const std::string& benchCaseName() const { return benchCaseName_; }
+  const std::string& benchName() const { return benchName_; }
+
+  std::unique_ptr<Benchmark> createBenchmark() { return benchFactory_->createBenchmark(); }
+
+ private:
+  std::string benchCaseName_;
+  std::string benchName_;
+  std::unique_ptr<BenchmarkFactory> benchFactory_;
+};
+
+/**
+ * Timings of a single benchmark, in nanoseconds per iteration.
+ */
+struct BenchmarkResult {
+  std::string name;
+  size_t samples;
+  size_t iterations;      //!< iterations per sample
+  double min;
+  double median;
+  double p99;
+  double mean;
+  size_t bytesProcessed;  //!< bytes per iteration, 0 if not declared
+
+  //! Throughput at the median timing, 0 if no bytes were declared.
+  double bytesPerSecond() const { return median > 0 ? bytesProcessed * 1e9 / median : 0; }
+};
+
 class UnitTest {
  public:
   UnitTest();
@@ -342,6 +467,11 @@ class UnitTest {
   void filterTests(const std::string& filter, const std::string& exclude);
   void run();
 
+  void printBenchmarkList();
+  void filterBenchmarks(const std::string& filter, const std::string& exclude);
+  void runBenchmarks();
+  void writeBenchmarkReport(std::ostream& os) const;
+
   void addEnvironment(std::unique_ptr<Environment>&& env);
 
   Callback* addInitializer(std::unique_ptr<Callback>&& cb);
@@ -350,6 +480,10 @@ class UnitTest {
                     const char* testName,
                     std::unique_ptr<TestFactory>&& testFactory);
 
+  BenchmarkInfo* addBenchmark(const char* benchCaseName,
+                              const char* benchName,
+                              std::unique_ptr<BenchmarkFactory>&& benchFactory);
+
   void reportError(const char* fileName,
                    int lineNo,
                    bool fatal,
@@ -393,7 +527,9 @@ class UnitTest {
 
  private:
   void runAllTestsOnce();
+  bool runBenchmark(BenchmarkInfo* benchmark);
   void printSummary();
+  void printFailures();
   size_t enabledCount() const;
   size_t disabledCount() const;
 
@@ -405,6 +541,13 @@ class UnitTest {
   //! ordered list of tests as offsets into testCases_
   std::vector<size_t> activeTests_;
 
+  std::vector<std::unique_ptr<BenchmarkInfo>> benchmarks_;
+  std::vector<size_t> activeBenchmarks_;
+  std::vector<BenchmarkResult> benchmarkResults_;
+  size_t benchmarkSamples_;
+  double benchmarkTime_;    //!< minimum measuring time per benchmark, in seconds
+  double benchmarkWarmup_;  //!< warm-up time per benchmark, in seconds
+
   int repeats_;
   bool verbose_;
   bool printProgress_;
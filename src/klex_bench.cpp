@@ -0,0 +1,422 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/BitParallelNFA.h>
+#include <klex/regular/Compiler.h>
+#include <klex/regular/DFAMinimizer.h>
+#include <klex/regular/LazyDFA.h>
+#include <klex/regular/Lexable.h>
+#include <klex/regular/Lexer.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/regular/TableLayoutPlanner.h>
+#include <klex/util/Flags.h>
+#include <klex/util/benchmark.h>
+#include <klex/util/heap_tracking.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(KLEX_BENCH_SPECS_DIR)
+#define KLEX_BENCH_SPECS_DIR "examples"
+#endif
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util;
+
+namespace
+{
+
+//! A lexer specification along with sample lines its corpora are assembled from.
+struct Spec
+{
+    string name;
+    string rules;
+    vector<string> lines;
+    char separator = '\n'; // between two lines of the corpus
+};
+
+// {{{ bundled specs
+const string MathExprRules = R"(
+    Space(ignore) ::= [\s\t]+
+    Eof           ::= <<EOF>>
+    Plus          ::= "+"
+    Minus         ::= "-"
+    Mul           ::= "*"
+    Div           ::= "/"
+    RndOpen       ::= "("
+    RndClose      ::= \)
+    Number        ::= ([0-9]+|[0-9]{1,3}(_[0-9]{3})*)
+    INVALID       ::= .
+)";
+
+const string WordCountRules = R"(
+    Word  ::= [a-zA-Z]+
+    LF    ::= \n
+    Other ::= .
+    Eof   ::= <<EOF>>
+)";
+
+const vector<string> CxxLines = {
+    "int main(int argc const char* argv[]) {",
+    "    if (argc != 2) return 1",
+    "    unsigned int count = 0x7fff",
+    "    while (count >= 1) { count -= 1 }",
+    "    auto message = \"hello, \\\"world\\\"\"",
+    "    /* legacy code path */ std << message << endl",
+    "    constexpr signed value = (4 * 2 + 1) / 3 % 5",
+    "    for (int i = 0 i <= 9 ++i) total += values[i]",
+    "    do { x = x << 1 } while (x < y)",
+    "    if (!done) x = -x",
+    "    char separator = ':'",
+    "}",
+};
+
+const vector<string> SolidityLines = {
+    "pragma solidity ^0.4.24;",
+    "contract Token is Owned {",
+    "    mapping (address => uint256) public balances;",
+    "    uint8 constant decimals = 18;",
+    "    string public name = \"Example Token\";",
+    "    bytes32 constant salt = hex\"deadbeef\";",
+    "    event Transfer(address indexed from, address indexed to, uint256 value);",
+    "    function transfer(address to, uint256 value) public returns (bool) {",
+    "        require(balances[msg.sender] >= value && value > 0);",
+    "        balances[msg.sender] -= value; balances[to] += value;",
+    "        emit Transfer(msg.sender, to, value);",
+    "        // transfers never fail silently",
+    "        return true;",
+    "    }",
+    "    uint256 total = 1_000_000 * 10 ** 18 + 0x1f;",
+    "}",
+};
+
+const vector<string> FlowLines = {
+    "handler main {",
+    "  if remote_ip in 10.0.0.0/8 then {",
+    "  var retries = 3;",
+    "  echo \"hello\";",
+    "  log \"local network\", remote_ip, 255.255.255.0;",
+    "  match path { on \"/static\" => docroot \"/var/www\"; }",
+    "  unless remote_ip == 192.168.0.1 or remote_ip == ::1 { return 403; }",
+    "  if path =^ '/api/' and not authorized then return 401;",
+    "  counter += 1_000 - 2 shl 1 % 7;",
+    "  import proxy from \"/usr/lib/x0d\";",
+    "}",
+};
+
+const vector<string> MathExprLines = {
+    "(1 + 23) * 456 / 7 - 1_000_000",
+    "42",
+    "((3 - 2) * (8 / 4)) + 999_999_999",
+    "12345 / (6 - 7) * 8",
+};
+
+const vector<string> WordCountLines = {
+    "The quick brown fox jumps over the lazy dog.",
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.",
+    "In 1984, 42 people read 3 books - each!",
+    "",
+};
+// }}}
+
+string readFile(const string& fileName)
+{
+    ifstream in { fileName };
+    if (!in.good())
+        throw runtime_error { fmt::format("Could not open {}.", fileName) };
+    stringstream sstr;
+    sstr << in.rdbuf();
+    return sstr.str();
+}
+
+vector<Spec> loadSpecs(const string& specsDir)
+{
+    return vector<Spec> {
+        { "cxx", readFile(specsDir + "/cxx.klex"), CxxLines },
+        { "solidity", readFile(specsDir + "/solidity.klex"), SolidityLines },
+        { "flow", readFile(specsDir + "/flow.klex"), FlowLines },
+        { "mathexpr", MathExprRules, MathExprLines, ' ' },
+        { "wordcount", WordCountRules, WordCountLines },
+    };
+}
+
+//! Assembles a corpus of at least @p size bytes out of randomly picked lines, deterministic by @p seed.
+string generateCorpus(const Spec& spec, size_t size, uint64_t seed)
+{
+    const vector<string>& lines = spec.lines;
+    mt19937_64 rng { seed };
+    uniform_int_distribution<size_t> pick { 0, lines.size() - 1 };
+
+    string corpus;
+    corpus.reserve(size + 128);
+    while (corpus.size() < size)
+    {
+        corpus += lines[pick(rng)];
+        corpus += spec.separator;
+    }
+    return corpus;
+}
+
+//! Lexes the whole input and returns the number of tokens (not counting ignored ones).
+using Engine = function<size_t(istream& input, string_view corpus)>;
+
+struct Measurement
+{
+    string spec;
+    string engine;
+    optional<TableLayout> layout;
+    size_t bytes;
+    size_t tokens;
+    double seconds;       // fastest of all repetitions
+    size_t allocations;   // of the last repetition
+    size_t peakHeap;      // beyond the heap in use when the runs started
+    optional<string> error;
+};
+
+Measurement measure(const Spec& spec, string engineName, optional<TableLayout> layout,
+                    const Engine& engine, const string& corpus, unsigned repeat)
+{
+    Measurement m {
+        spec.name, move(engineName), layout, corpus.size(), 0, numeric_limits<double>::max(), 0, 0, {}
+    };
+
+    const size_t heapBefore = heapCurrentSize();
+    resetHeapPeakSize();
+
+    for (unsigned i = 0; i < repeat; ++i)
+    {
+        istringstream input { corpus };
+        const size_t allocationsBefore = heapAllocationCount();
+        const auto start = chrono::steady_clock::now();
+        try
+        {
+            m.tokens = engine(input, corpus);
+        }
+        catch (const exception& e)
+        {
+            m.error = e.what();
+            break;
+        }
+        const chrono::duration<double> duration = chrono::steady_clock::now() - start;
+        m.seconds = min(m.seconds, duration.count());
+        m.allocations = heapAllocationCount() - allocationsBefore;
+    }
+    m.peakHeap = heapPeakSize() - heapBefore;
+
+    return m;
+}
+
+Tag eofTag(const Compiler& cc)
+{
+    for (const Rule& rule: cc.rules())
+        if (rule.pattern == "<<EOF>>")
+            return rule.tag;
+
+    throw runtime_error { "Lexer specification does not define an <<EOF>> rule." };
+}
+
+template <typename Matcher>
+size_t recognizeAll(Matcher& matcher, string_view corpus)
+{
+    size_t tokens = 0;
+    size_t offset = 0;
+    for (;;)
+    {
+        const bool isBeginOfLine = offset == 0 || corpus[offset - 1] == '\n';
+        const auto match = matcher.recognize(corpus.substr(offset), isBeginOfLine);
+        if (!match.has_value())
+            throw LexerError { static_cast<unsigned>(offset) };
+        if (match->tag != IgnoreTag)
+            ++tokens;
+        if (match->length == 0) // <<EOF>>
+            return tokens;
+        offset += match->length;
+    }
+}
+
+void runSpec(const Spec& spec, const Flags& flags, vector<Measurement>& results)
+{
+    const string engineFilter = flags.getString("engine");
+    const unsigned repeat = static_cast<unsigned>(max(1l, flags.getNumber("repeat")));
+    const string corpus = generateCorpus(spec,
+                                         static_cast<size_t>(flags.getNumber("size")),
+                                         static_cast<uint64_t>(flags.getNumber("seed")));
+
+    Compiler cc;
+    cc.parse(spec.rules);
+    const Tag eof = eofTag(cc);
+    const MultiDFA multiDFA = DFAMinimizer { cc.compileMultiDFA() }.constructMultiDFA();
+
+    auto run = [&](const string& engineName, optional<TableLayout> layout, const Engine& engine) {
+        if (!engineFilter.empty() && engineFilter != engineName)
+            return;
+        cerr << fmt::format("{}: {} {}\n", spec.name, engineName, layout ? to_string(*layout) : "");
+        results.emplace_back(measure(spec, engineName, layout, engine, corpus, repeat));
+    };
+
+    for (TableLayout layout:
+         { TableLayout::Ranges, TableLayout::Comb, TableLayout::Dense, TableLayout::Classes })
+    {
+        const LexerDef def = Compiler::generateTables(multiDFA, cc.containsBeginOfLine(), cc.names(), layout);
+
+        run("Lexer", layout, [&](istream& input, string_view) {
+            Lexer<Tag, StateId, true, false> lexer { def, input };
+            size_t tokens = 1;
+            while (lexer.recognize() != eof)
+                ++tokens;
+            return tokens;
+        });
+
+        run("Lexable", layout, [&](istream& input, string_view) {
+            Lexable<Tag, StateId, true, false> lexable { def, input };
+            size_t tokens = 0;
+            for (auto i = begin(lexable), e = end(lexable); i != e; ++i)
+            {
+                ++tokens;
+                if (token(i) == eof)
+                    break;
+            }
+            return tokens;
+        });
+    }
+
+    // compiled outside of the timed runs, the states it materializes on demand are kept across them
+    LazyDFA lazy = cc.compileLazyDFA();
+    run("LazyDFA", nullopt, [&](istream&, string_view input) { return recognizeAll(lazy, input); });
+
+    try
+    {
+        const BitParallelNFA bitParallel = cc.compileBitParallelNFA();
+        run("BitParallelNFA", nullopt, [&](istream&, string_view input) {
+            return recognizeAll(bitParallel, input);
+        });
+    }
+    catch (const BitParallelNFA::TooManyPositions& e)
+    {
+        cerr << fmt::format("{}: BitParallelNFA skipped. {}\n", spec.name, e.what());
+    }
+}
+
+void writeJson(ostream& os, const Flags& flags, const vector<Measurement>& results)
+{
+    os << "{\n";
+    os << fmt::format("  \"size\": {},\n", flags.getNumber("size"));
+    os << fmt::format("  \"seed\": {},\n", flags.getNumber("seed"));
+    os << fmt::format("  \"repeat\": {},\n", flags.getNumber("repeat"));
+    os << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Measurement& m = results[i];
+        os << (i ? ",\n" : "\n") << "    {";
+        os << fmt::format("\"spec\": {}, \"engine\": {}, \"layout\": {}, \"bytes\": {}",
+                          jsonString(m.spec),
+                          jsonString(m.engine),
+                          m.layout ? jsonString(to_string(*m.layout)) : "null",
+                          m.bytes);
+        if (m.error)
+            os << fmt::format(", \"error\": {}", jsonString(*m.error));
+        else
+            os << fmt::format(", \"tokens\": {}, \"seconds\": {:.6f}, \"mbPerSecond\": {:.2f}, "
+                              "\"tokensPerSecond\": {:.0f}, \"allocationsPerToken\": {:.3f}",
+                              m.tokens,
+                              m.seconds,
+                              static_cast<double>(m.bytes) / (1024 * 1024) / m.seconds,
+                              static_cast<double>(m.tokens) / m.seconds,
+                              m.tokens ? static_cast<double>(m.allocations) / m.tokens : 0.0);
+        os << fmt::format(", \"peakHeap\": {}}}", m.peakHeap);
+    }
+    os << "\n  ],\n";
+    os << fmt::format("  \"peakRss\": {}\n", peakResidentSetSize());
+    os << "}\n";
+}
+
+optional<int> prepareAndParseCLI(Flags& flags, int argc, const char* argv[])
+{
+    flags.defineBool("help", 'h', "Prints this help and exits");
+    flags.defineString("specs-dir",
+                       0,
+                       "DIR",
+                       "Directory containing the bundled lexer specifications (cxx, solidity, flow).",
+                       KLEX_BENCH_SPECS_DIR);
+    flags.defineString("spec", 's', "NAME", "Only benchmark the given specification.", "");
+    flags.defineString("engine", 'e', "NAME", "Only benchmark the given runtime engine.", "");
+    flags.defineNumber(
+        "size", 'n', "BYTES", "Size of the generated input corpus per specification.", 1 << 20);
+    flags.defineNumber("seed", 0, "NUMBER", "Seed of the input corpus generator.", 1);
+    flags.defineNumber(
+        "repeat", 'r', "COUNT", "Number of runs per engine, the fastest one is reported.", 3);
+    flags.defineString(
+        "output", 'o', "FILE", "Output file for the JSON report (use - to represent stdout).", "-");
+
+    try
+    {
+        flags.parse(argc, argv);
+    }
+    catch (const Flags::Error& e)
+    {
+        cerr << "Failed to parse command line parameters. " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (flags.getBool("help"))
+    {
+        static string_view const title = "klex_bench - klex lexer throughput benchmark\n"
+                                         "(c) 2018 Christian Parpart <christian@parpart.family>\n"
+                                         "\n";
+        cerr << flags.helpText(title) << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    return nullopt;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    Flags flags;
+    if (optional<int> rc = prepareAndParseCLI(flags, argc, argv); rc)
+        return rc.value();
+
+    vector<Measurement> results;
+    try
+    {
+        for (const Spec& spec: loadSpecs(flags.getString("specs-dir")))
+            if (flags.getString("spec").empty() || flags.getString("spec") == spec.name)
+                runSpec(spec, flags, results);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (const string output = flags.getString("output"); output == "-")
+        writeJson(cout, flags, results);
+    else
+    {
+        ofstream out { output };
+        writeJson(out, flags, results);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,349 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/DFAMinimizer.h>
+#include <klex/regular/MultiDFA.h>
+#include <klex/util/Flags.h>
+#include <klex/util/benchmark.h>
+#include <klex/util/heap_tracking.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util;
+
+namespace
+{
+
+// {{{ synthetic rule sets
+/**
+ * Generates @p count distinct lowercase words of 4 to 12 letters, deterministic by @p rng.
+ */
+vector<string> generateWords(size_t count, mt19937_64& rng)
+{
+    uniform_int_distribution<size_t> length { 4, 12 };
+    uniform_int_distribution<int> letter { 'a', 'z' };
+
+    set<string> seen;
+    vector<string> words;
+    words.reserve(count);
+    while (words.size() < count)
+    {
+        string word(length(rng), ' ');
+        for (char& ch: word)
+            ch = static_cast<char>(letter(rng));
+        if (seen.insert(word).second)
+            words.emplace_back(move(word));
+    }
+    return words;
+}
+
+//! Rules every generated rule set ends with.
+const string CommonRules = R"(
+    Spacing(ignore) ::= [\s\t\n]+
+    Ident           ::= [a-z][a-z0-9_]*
+    Eof             ::= <<EOF>>
+)";
+
+//! @p n keyword rules.
+string keywordRules(size_t n, mt19937_64& rng)
+{
+    string rules;
+    const vector<string> words = generateWords(n, rng);
+    for (size_t i = 0; i < words.size(); ++i)
+        rules += fmt::format("K{} ::= \"{}\"\n", i, words[i]);
+    return rules + CommonRules;
+}
+
+//! A single rule alternating between @p n sequences of (nested) character classes.
+string alternationRules(size_t n, mt19937_64& rng)
+{
+    uniform_int_distribution<int> letter { 'a', 'x' };
+    uniform_int_distribution<int> digit { '0', '9' };
+
+    string alternatives;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const char a = static_cast<char>(letter(rng));
+        const char d = static_cast<char>(digit(rng));
+        if (i)
+            alternatives += '|';
+        alternatives += fmt::format("[{}-{}][0-{}]([{}-z_]|[{}-9]x)", a, static_cast<char>(a + 2), d, a, d);
+    }
+    return fmt::format("Alt ::= {}\n", alternatives) + CommonRules;
+}
+
+//! Rules with bounded repetitions up to @p n.
+string repetitionRules(size_t n, mt19937_64&)
+{
+    return fmt::format("Fixed   ::= [a-f0-9]{{{0}}}#\n"
+                       "Bounded ::= [a-z]{{1,{0}}}@\n"
+                       "Nested  ::= ([a-z][0-9]{{0,3}}){{{1},{0}}}!\n",
+                       n,
+                       n / 2)
+           + CommonRules;
+}
+
+//! @p n conditions with a few keyword rules each.
+string conditionRules(size_t n, mt19937_64& rng)
+{
+    constexpr size_t RulesPerCondition = 8;
+
+    string rules;
+    const vector<string> words = generateWords(n * RulesPerCondition, rng);
+    for (size_t c = 0; c < n; ++c)
+        for (size_t i = 0; i < RulesPerCondition; ++i)
+            rules += fmt::format("<C{}>K{}_{} ::= \"{}\"\n", c, c, i, words[c * RulesPerCondition + i]);
+    return rules + "<*>" + CommonRules.substr(CommonRules.rfind("Eof"));
+}
+
+struct Scenario
+{
+    string name;
+    string flag;  // name of the command line flag listing the parameters to run this scenario with
+    function<string(size_t, mt19937_64&)> generate;
+};
+
+const vector<Scenario> Scenarios = {
+    { "keywords", "keywords", keywordRules },
+    { "alternation", "alternation", alternationRules },
+    { "repetition", "repetition", repetitionRules },
+    { "conditions", "conditions", conditionRules },
+};
+// }}}
+
+struct Phase
+{
+    string name;
+    double seconds;
+    size_t allocations;
+    size_t peakHeap;  // beyond the heap in use when the phase started
+    size_t peakRss;
+};
+
+struct Measurement
+{
+    string scenario;
+    size_t parameter;
+    size_t rules = 0;
+    size_t nfaStates = 0;
+    size_t dfaStates = 0;
+    size_t minimalDfaStates = 0;
+    size_t tableFootprint = 0;
+    vector<Phase> phases;
+    optional<string> error;
+};
+
+template <typename Body>
+void measurePhase(Measurement& m, string name, Body&& body)
+{
+    const size_t heapBefore = heapCurrentSize();
+    const size_t allocationsBefore = heapAllocationCount();
+    resetHeapPeakSize();
+    const auto start = chrono::steady_clock::now();
+
+    body();
+
+    const chrono::duration<double> duration = chrono::steady_clock::now() - start;
+    m.phases.emplace_back(Phase { move(name),
+                                  duration.count(),
+                                  heapAllocationCount() - allocationsBefore,
+                                  heapPeakSize() - heapBefore,
+                                  peakResidentSetSize() });
+}
+
+Measurement run(const Scenario& scenario, size_t parameter, const Flags& flags)
+{
+    Measurement m { scenario.name, parameter };
+
+    mt19937_64 rng { static_cast<uint64_t>(flags.getNumber("seed")) };
+    const string rules = scenario.generate(parameter, rng);
+    const Compiler::DFAConstruction construction = flags.getBool("direct-dfa")
+                                                       ? Compiler::DFAConstruction::PositionAutomaton
+                                                       : Compiler::DFAConstruction::SubsetConstruction;
+
+    try
+    {
+        Compiler cc { construction };
+        measurePhase(m, "parse", [&]() { cc.parse(rules); });
+        m.rules = cc.rules().size();
+        m.nfaStates = cc.size();
+
+        MultiDFA multiDFA;
+        measurePhase(m, "compileMultiDFA", [&]() { multiDFA = cc.compileMultiDFA(); });
+        m.dfaStates = multiDFA.dfa.size();
+
+        measurePhase(m, "minimize", [&]() { multiDFA = DFAMinimizer { multiDFA }.constructMultiDFA(); });
+        m.minimalDfaStates = multiDFA.dfa.size();
+
+        measurePhase(m, "generateTables", [&]() {
+            const LexerDef def = Compiler::generateTables(
+                multiDFA, cc.containsBeginOfLine(), cc.names(), TableLayout::Auto);
+            m.tableFootprint = def.transitions.footprint();
+        });
+    }
+    catch (const exception& e)
+    {
+        m.error = e.what();
+    }
+
+    return m;
+}
+
+//! Parses a comma separated list of numbers.
+vector<size_t> parseList(const string& list)
+{
+    vector<size_t> values;
+    istringstream sstr { list };
+    for (string value; getline(sstr, value, ',');)
+        if (!value.empty())
+            values.push_back(stoul(value));
+    return values;
+}
+
+void writeJson(ostream& os, const Flags& flags, const vector<Measurement>& results)
+{
+    os << "{\n";
+    os << fmt::format("  \"seed\": {},\n", flags.getNumber("seed"));
+    os << fmt::format("  \"construction\": {},\n",
+                      jsonString(flags.getBool("direct-dfa") ? "position" : "subset"));
+    os << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Measurement& m = results[i];
+        os << (i ? ",\n" : "\n") << "    {";
+        os << fmt::format("\"scenario\": {}, \"parameter\": {}", jsonString(m.scenario), m.parameter);
+        if (m.error)
+            os << fmt::format(", \"error\": {}", jsonString(*m.error));
+        os << fmt::format(", \"rules\": {}, \"nfaStates\": {}, \"dfaStates\": {}, \"minimalDfaStates\": {}, "
+                          "\"tableFootprint\": {},\n",
+                          m.rules,
+                          m.nfaStates,
+                          m.dfaStates,
+                          m.minimalDfaStates,
+                          m.tableFootprint);
+        os << "     \"phases\": [";
+        for (size_t k = 0; k < m.phases.size(); ++k)
+        {
+            const Phase& phase = m.phases[k];
+            os << (k ? ", " : "")
+               << fmt::format("{{\"name\": {}, \"seconds\": {:.6f}, \"allocations\": {}, \"peakHeap\": {}, "
+                              "\"peakRss\": {}}}",
+                              jsonString(phase.name),
+                              phase.seconds,
+                              phase.allocations,
+                              phase.peakHeap,
+                              phase.peakRss);
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+optional<int> prepareAndParseCLI(Flags& flags, int argc, const char* argv[])
+{
+    flags.defineBool("help", 'h', "Prints this help and exits");
+    flags.defineString(
+        "keywords", 0, "LIST", "Comma separated numbers of keyword rules to compile.", "1000,2000,4000");
+    flags.defineString("alternation",
+                       0,
+                       "LIST",
+                       "Comma separated widths of an alternation of character class sequences to compile.",
+                       "16,64,256");
+    flags.defineString(
+        "repetition", 0, "LIST", "Comma separated upper bounds of {m,n} repetitions to compile.", "8,16,32");
+    flags.defineString("conditions",
+                       0,
+                       "LIST",
+                       "Comma separated numbers of conditions (8 rules each) to compile.",
+                       "4,16,64,256");
+    flags.defineString("scenario", 's', "NAME", "Only run the given scenario.", "");
+    flags.defineBool("direct-dfa",
+                     0,
+                     "Construct the DFA directly from the regular expressions (position automaton) "
+                     "instead of via NFA and subset construction.");
+    flags.defineNumber("seed", 0, "NUMBER", "Seed of the rule set generator.", 1);
+    flags.defineString(
+        "output", 'o', "FILE", "Output file for the JSON report (use - to represent stdout).", "-");
+
+    try
+    {
+        flags.parse(argc, argv);
+    }
+    catch (const Flags::Error& e)
+    {
+        cerr << "Failed to parse command line parameters. " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (flags.getBool("help"))
+    {
+        static string_view const title = "klex_compile_bench - klex compile time scaling benchmark\n"
+                                         "(c) 2018 Christian Parpart <christian@parpart.family>\n"
+                                         "\n";
+        cerr << flags.helpText(title) << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    return nullopt;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    Flags flags;
+    if (optional<int> rc = prepareAndParseCLI(flags, argc, argv); rc)
+        return rc.value();
+
+    vector<Measurement> results;
+    try
+    {
+        for (const Scenario& scenario: Scenarios)
+        {
+            if (!flags.getString("scenario").empty() && flags.getString("scenario") != scenario.name)
+                continue;
+
+            for (size_t parameter: parseList(flags.getString(scenario.flag)))
+            {
+                cerr << fmt::format("{}: {}\n", scenario.name, parameter);
+                results.emplace_back(run(scenario, parameter, flags));
+            }
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (const string output = flags.getString("output"); output == "-")
+        writeJson(cout, flags, results);
+    else
+    {
+        ofstream out { output };
+        writeJson(out, flags, results);
+    }
+
+    return EXIT_SUCCESS;
+}
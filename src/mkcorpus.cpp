@@ -0,0 +1,150 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/regular/Compiler.h>
+#include <klex/regular/CorpusGenerator.h>
+#include <klex/util/Flags.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace klex::regular;
+using namespace klex::util;
+
+//! Parses a size such as 4096, 64K, 16M or 2G.
+optional<size_t> parseSize(const string& text)
+{
+    size_t length = 0;
+    unsigned long long value = 0;
+    try
+    {
+        value = stoull(text, &length);
+    }
+    catch (const exception&)
+    {
+        return nullopt;
+    }
+
+    const string suffix = text.substr(length);
+    if (suffix.empty())
+        return static_cast<size_t>(value);
+    if (suffix == "K" || suffix == "k")
+        return static_cast<size_t>(value << 10);
+    if (suffix == "M" || suffix == "m")
+        return static_cast<size_t>(value << 20);
+    if (suffix == "G" || suffix == "g")
+        return static_cast<size_t>(value << 30);
+
+    return nullopt;
+}
+
+//! Applies weights given as comma separated NAME=WEIGHT pairs.
+void applyWeights(CorpusGenerator& generator, const string& weights)
+{
+    istringstream sstr { weights };
+    for (string weight; getline(sstr, weight, ',');)
+    {
+        if (weight.empty())
+            continue;
+
+        const size_t eq = weight.find('=');
+        if (eq == string::npos)
+            throw invalid_argument { "Malformed weight: " + weight };
+
+        generator.setWeight(weight.substr(0, eq), stod(weight.substr(eq + 1)));
+    }
+}
+
+optional<int> prepareAndParseCLI(Flags& flags, int argc, const char* argv[])
+{
+    flags.defineBool("help", 'h', "Prints this help and exits");
+    flags.defineString("file", 'f', "PATTERN_FILE", "Input file with lexer rules");
+    flags.defineString(
+        "size", 'n', "SIZE", "Minimum size of the corpus in bytes (suffixes K, M and G accepted).", "1M");
+    flags.defineNumber("seed", 0, "NUMBER", "Seed of the random generator.", 1);
+    flags.defineString("weights",
+                       'w',
+                       "LIST",
+                       "Comma separated list of TOKEN=WEIGHT pairs, setting the relative frequency of "
+                       "the given tokens (1 by default, 0 to disable a token).",
+                       "");
+    flags.defineBool("adversarial",
+                     'a',
+                     "Chains tokens such that the lexer has to look ahead (and roll back) as far as "
+                     "possible.");
+    flags.defineString("output", 'o', "FILE", "Output file for the corpus (use - to represent stdout).", "-");
+
+    try
+    {
+        flags.parse(argc, argv);
+    }
+    catch (const Flags::Error& e)
+    {
+        cerr << "Failed to parse command line parameters. " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (flags.getBool("help"))
+    {
+        static string_view const title = "mkcorpus - klex input corpus generator\n"
+                                         "(c) 2018 Christian Parpart <christian@parpart.family>\n"
+                                         "\n";
+        cerr << flags.helpText(title) << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    return nullopt;
+}
+
+int main(int argc, const char* argv[])
+{
+    Flags flags;
+    if (optional<int> rc = prepareAndParseCLI(flags, argc, argv); rc)
+        return rc.value();
+
+    const optional<size_t> size = parseSize(flags.getString("size"));
+    if (!size.has_value())
+    {
+        cerr << fmt::format("Invalid size: {}\n", flags.getString("size"));
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        Compiler cc;
+        cc.parse(make_unique<ifstream>(flags.getString("file")));
+        const LexerDef lexerDef = cc.compileMulti();
+
+        CorpusGenerator generator { lexerDef,
+                                    static_cast<uint64_t>(flags.getNumber("seed")),
+                                    flags.getBool("adversarial") ? CorpusGenerator::Mode::Adversarial
+                                                                 : CorpusGenerator::Mode::Regular };
+        applyWeights(generator, flags.getString("weights"));
+
+        if (const string output = flags.getString("output"); output == "-")
+            generator.generate(*size, cout);
+        else
+        {
+            ofstream out { output, ios::binary };
+            generator.generate(*size, out);
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
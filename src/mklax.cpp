@@ -0,0 +1,357 @@
+// This file is part of the "klex" project, http://github.com/christianparpart/klex>
+//   (c) 2018 Christian Parpart <christian@parpart.family>
+//
+// Licensed under the MIT License (the "License"); you may not use this
+// file except in compliance with the License. You may obtain a copy of
+// the License at: http://opensource.org/licenses/MIT
+
+#include <klex/Report.h>
+#include <klex/cfg/Grammar.h>
+#include <klex/cfg/GrammarParser.h>
+#include <klex/cfg/LeftRecursion.h>
+#include <klex/cfg/ll/SyntaxTable.h>
+#include <klex/regular/CxxGenerator.h>
+#include <klex/regular/TableLayoutPlanner.h>
+#include <klex/util/Flags.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+
+using namespace std;
+using namespace klex;
+using namespace klex::cfg;
+using namespace klex::util;
+
+using klex::cfg::ll::SyntaxTable;
+using klex::regular::TableLayout;
+
+struct PerfTimer
+{
+    using Duration = chrono::duration<double>;
+    using TimePoint = chrono::time_point<chrono::high_resolution_clock>;
+
+    explicit PerfTimer(bool _enabled): enabled { _enabled }
+    {
+        if (_enabled)
+            start = chrono::high_resolution_clock::now();
+    }
+
+    bool enabled;
+    TimePoint start;
+    TimePoint end;
+
+    void lap(string_view message, size_t count, string_view item)
+    {
+        if (enabled)
+        {
+            end = chrono::high_resolution_clock::now();
+            const Duration duration = end - start;
+            swap(end, start);
+
+            cerr << fmt::format("{}: {} seconds ({} {})\n", message, duration.count(), count, item);
+        }
+    }
+};
+
+/**
+ * Reports each pair of productions of the same non-terminal whose FIRST+ sets intersect,
+ * i.e. which an LL(1) parser cannot decide between.
+ *
+ * @returns the number of conflicts found.
+ */
+size_t checkConflicts(const Grammar& grammar, Report& report)
+{
+    size_t conflicts = 0;
+    for (const NonTerminal& nt: grammar.nonterminals)
+    {
+        map<string, const Production*> lookaheads;
+        for (const Production* p: grammar.getProductions(nt))
+        {
+            for (const Terminal& w: p->first1())
+            {
+                auto [i, inserted] = lookaheads.emplace(fmt::format("{}", w), p);
+                if (!inserted)
+                {
+                    report.typeError(SourceLocation {},
+                                     "LL(1) conflict on {} with lookahead {} between {} and {}.",
+                                     nt.name,
+                                     i->first,
+                                     to_string(*i->second),
+                                     to_string(*p));
+                    conflicts++;
+                }
+            }
+        }
+    }
+    return conflicts;
+}
+
+void generateStringVectorCxx(ostream& os, string_view name, const vector<string>& values)
+{
+    os << "  // " << name << "\n";
+    os << "  std::vector<std::string> {\n";
+    for (const string& value: values)
+        os << "    \"" << value << "\",\n";
+    os << "  },\n";
+}
+
+template <typename T>
+void generateIntVectorCxx(ostream& os, string_view name, string_view typeName, const vector<T>& values)
+{
+    os << "  // " << name << "\n";
+    os << "  " << typeName << " {";
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i % 16 == 0)
+            os << "\n   ";
+        os << " " << values[i] << ",";
+    }
+    os << "\n  },\n";
+}
+
+void generateTableDefCxx(ostream& os, const SyntaxTable& st, const string& fullyQualifiedSymbolName)
+{
+    auto [ns, tableName] = regular::splitNamespace(fullyQualifiedSymbolName);
+
+    os << "#include <klex/cfg/ll/SyntaxTable.h>\n";
+    os << "\n";
+
+    if (!ns.empty())
+        os << "namespace " << ns << " {\n\n";
+
+    os << "klex::cfg::ll::SyntaxTable " << tableName << " {\n";
+    generateStringVectorCxx(os, "names", st.names);
+    generateStringVectorCxx(os, "terminal names", st.terminalNames);
+    generateStringVectorCxx(os, "non-terminal names", st.nonterminalNames);
+    generateStringVectorCxx(os, "action names", st.actionNames);
+    generateStringVectorCxx(os, "production names", st.productionNames);
+
+    os << "  // productions\n";
+    os << "  klex::cfg::ll::SyntaxTable::ProductionVec {\n";
+    for (size_t i = 0; i < st.productions.size(); ++i)
+    {
+        os << "    {";
+        for (size_t k = 0; k < st.productions[i].size(); ++k)
+            os << (k ? ", " : " ") << st.productions[i][k];
+        os << (st.productions[i].empty() ? "}" : " }") << ", // " << st.productionNames[i] << "\n";
+    }
+    os << "  },\n";
+
+    generateIntVectorCxx(os, "production symbols", "std::vector<int>", st.productionSymbols);
+    generateIntVectorCxx(os, "production offsets", "std::vector<size_t>", st.productionOffsets);
+
+    // sorted, to keep the output stable across runs
+    const map<int, map<int, int>> table = [&]() {
+        map<int, map<int, int>> sorted;
+        for (auto&& [nt, lookaheads]: st.table)
+            sorted[nt].insert(lookaheads.begin(), lookaheads.end());
+        return sorted;
+    }();
+    os << "  // sparse parse table\n";
+    os << "  klex::cfg::ll::SyntaxTable::NonTerminalMap {\n";
+    for (auto&& [nt, lookaheads]: table)
+    {
+        os << "    { " << nt << ", {";
+        for (auto&& [w, p]: lookaheads)
+            os << " {" << w << ", " << p << "},";
+        os << " }}, // " << st.nonterminalName(nt) << "\n";
+    }
+    os << "  },\n";
+
+    generateIntVectorCxx(os,
+                         fmt::format("dense parse table ({} non-terminals x {} terminals)",
+                                     st.nonterminalCount(),
+                                     st.terminalCount()),
+                         "std::vector<klex::cfg::ll::SyntaxTable::ProductionId>",
+                         st.denseTable);
+
+    os << "  // start symbol\n";
+    os << "  " << st.startSymbol << ",\n";
+
+    os << "  // lexer\n";
+    os << "  klex::regular::LexerDef ";
+    regular::generateLexerDefCxx(os, st.lexerDef);
+    os << "\n};\n";
+
+    if (!ns.empty())
+        os << "\n} // namespace " << ns << "\n";
+}
+
+void generateEnumCxx(ostream& os, string_view typeName, const vector<string>& names, int first)
+{
+    os << "enum class " << typeName << " {\n";
+    for (size_t i = 0; i < names.size(); ++i)
+        os << "  " << names[i] << " = " << first + static_cast<int>(i) << ",\n";
+    os << "};\n\n";
+}
+
+void generateSymbolDefCxx(ostream& os, const SyntaxTable& st, const string& fullyQualifiedSymbolName)
+{
+    auto [ns, tableName] = regular::splitNamespace(fullyQualifiedSymbolName);
+
+    os << "#pragma once\n\n";
+    os << "#include <klex/cfg/ll/SyntaxTable.h>\n\n";
+    os << "// the EOF terminal would clash with the macro of the same name from <cstdio>\n";
+    os << "#pragma push_macro(\"EOF\")\n";
+    os << "#undef EOF\n\n";
+    if (!ns.empty())
+        os << "namespace " << ns << " {\n\n";
+
+    os << "extern klex::cfg::ll::SyntaxTable " << tableName << ";\n\n";
+    generateEnumCxx(os, "NonTerminal", st.nonterminalNames, st.nonterminalMin());
+    generateEnumCxx(os, "Terminal", st.terminalNames, st.terminalMin());
+    generateEnumCxx(os, "Action", st.actionNames, st.actionMin());
+
+    if (!ns.empty())
+        os << "} // namespace " << ns << "\n\n";
+
+    os << "#pragma pop_macro(\"EOF\")\n";
+}
+
+optional<TableLayout> parseTableLayout(string_view name)
+{
+    for (TableLayout layout: { TableLayout::Ranges,
+                               TableLayout::Comb,
+                               TableLayout::Dense,
+                               TableLayout::Classes,
+                               TableLayout::Auto })
+        if (name == to_string(layout))
+            return layout;
+
+    return nullopt;
+}
+
+template <typename Generator>
+void writeOutput(const string& fileName, Generator generate)
+{
+    if (fileName != "-")
+    {
+        if (auto p = fs::path { fileName }.remove_filename(); p != "")
+            fs::create_directories(p);
+        ofstream ofs { fileName };
+        generate(ofs);
+    }
+    else
+    {
+        generate(cerr);
+    }
+}
+
+optional<int> prepareAndParseCLI(Flags& flags, int argc, const char* argv[])
+{
+    flags.defineBool("help", 'h', "Prints this help and exits");
+    flags.defineString("file", 'f', "GRAMMAR_FILE", "Input file with the grammar");
+    flags.defineString("output-table",
+                       't',
+                       "FILE",
+                       "Output file that will contain the compiled tables (use - to represent stderr)",
+                       "-");
+    flags.defineString("output-symbols",
+                       'T',
+                       "FILE",
+                       "Output file that will contain the symbol enums (use - to represent stderr)",
+                       "-");
+    flags.defineString("table-name",
+                       'n',
+                       "IDENTIFIER",
+                       "Symbol name for generated table (may include namespace).",
+                       "syntaxTable");
+    flags.defineString("table-layout",
+                       0,
+                       "LAYOUT",
+                       "Runtime layout of the generated lexer's transition table, one of: ranges, comb, "
+                       "dense, classes, or auto to have it chosen based on the table's statistics.",
+                       "auto");
+    flags.defineBool("dump", 'd', "Prints the finalized grammar and its parse table to stdout.");
+    flags.defineBool("perf", 'p', "Print performance counters to stderr.");
+
+    try
+    {
+        flags.parse(argc, argv);
+    }
+    catch (const Flags::Error& e)
+    {
+        cerr << "Failed to parse command line parameters. " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (flags.getBool("help"))
+    {
+        static string_view const title = "mklax - klex LL(1) parser generator\n"
+                                         "(c) 2018 Christian Parpart <christian@parpart.family>\n"
+                                         "\n";
+        cerr << flags.helpText(title) << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    return nullopt;
+}
+
+int main(int argc, const char* argv[])
+{
+    Flags flags;
+    if (optional<int> rc = prepareAndParseCLI(flags, argc, argv); rc)
+        return rc.value();
+
+    const optional<TableLayout> tableLayout = parseTableLayout(flags.getString("table-layout"));
+    if (!tableLayout.has_value())
+    {
+        cerr << fmt::format("Unknown table layout: {}\n", flags.getString("table-layout"));
+        return EXIT_FAILURE;
+    }
+
+    const string klaxFileName = flags.getString("file");
+    ifstream klaxFile { klaxFileName };
+    if (!klaxFile.good())
+    {
+        cerr << fmt::format("Could not open grammar file: {}\n", klaxFileName);
+        return EXIT_FAILURE;
+    }
+    string source { istreambuf_iterator<char> { klaxFile }, istreambuf_iterator<char> {} };
+
+    PerfTimer perfTimer { flags.getBool("perf") };
+    ConsoleReport report;
+    Grammar grammar = GrammarParser(move(source), &report).parse();
+    if (report.containsFailures())
+        return EXIT_FAILURE;
+    perfTimer.lap("Grammar parsing", grammar.productions.size(), "productions");
+
+    if (LeftRecursion::isLeftRecursive(grammar))
+    {
+        cerr << "Grammar is left recursive, which an LL(1) parser cannot handle.\n";
+        return EXIT_FAILURE;
+    }
+
+    grammar.finalize();
+    perfTimer.lap("Grammar finalization", grammar.nonterminals.size(), "non-terminals");
+
+    if (checkConflicts(grammar, report) != 0)
+        return EXIT_FAILURE;
+
+    SyntaxTable st = SyntaxTable::construct(grammar);
+    perfTimer.lap("Syntax table construction", st.denseTable.size(), "table entries");
+
+    st.lexerDef.transitions.convert(*tableLayout == TableLayout::Auto
+                                        ? regular::planTableLayout(st.lexerDef).layout
+                                        : *tableLayout);
+    perfTimer.lap("Lexer table generation", st.lexerDef.transitions.footprint(), "bytes");
+
+    if (flags.getBool("dump"))
+        cout << grammar.dump() << "\n" << st.dump(grammar);
+
+    const string tableName = flags.getString("table-name");
+    writeOutput(flags.getString("output-table"),
+                [&](ostream& os) { generateTableDefCxx(os, st, tableName); });
+    writeOutput(flags.getString("output-symbols"),
+                [&](ostream& os) { generateSymbolDefCxx(os, st, tableName); });
+
+    return EXIT_SUCCESS;
+}
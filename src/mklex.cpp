@@ -6,6 +6,7 @@
 // the License at: http://opensource.org/licenses/MIT
 
 #include <klex/regular/Compiler.h>
+#include <klex/regular/CxxGenerator.h>
 #include <klex/regular/DFA.h>
 #include <klex/regular/DFAMinimizer.h>
 #include <klex/regular/DotWriter.h>
@@ -15,6 +16,8 @@
 #include <klex/regular/RegExprParser.h>
 #include <klex/regular/Rule.h>
 #include <klex/regular/RuleParser.h>
+#include <klex/regular/TableLayoutPlanner.h>
+#include <klex/regular/TransitionProfile.h>
 #include <klex/util/Flags.h>
 
 #include <chrono>
@@ -31,25 +34,6 @@ using namespace std;
 using namespace klex::regular;
 using namespace klex::util;
 
-string charLiteral(Symbol ch)
-{
-    switch (ch)
-    {
-        case Symbols::EndOfFile:
-        case Symbols::Error: return fmt::format("{}", (int) ch);
-        case ' ': return string { "' '" };
-        case '\t': return string { "'\\t'" };
-        case '\n': return string { "'\\n'" };
-        case '\'': return string { "'\\''" };
-        case '\\': return string { "'\\\\'" };
-        default:
-            if (ch >= 0 && ch <= 255 && isprint(ch))
-                return fmt::format("'{}'", (char) ch);
-            else
-                return fmt::format("{}", (int) ch);
-    }
-}
-
 struct PerfTimer
 {
     using Duration = chrono::duration<double>;
@@ -78,15 +62,6 @@ struct PerfTimer
     }
 };
 
-pair<string, string> splitNamespace(const string& fullyQualifiedName)
-{
-    size_t n = fullyQualifiedName.rfind("::");
-    if (n != string::npos)
-        return make_pair(fullyQualifiedName.substr(0, n), fullyQualifiedName.substr(n + 2));
-    else
-        return make_pair(string(), fullyQualifiedName);
-}
-
 void generateTableDefCxx(ostream& os,
                          const LexerDef& lexerDef,
                          const RuleList& rules,
@@ -100,65 +75,45 @@ void generateTableDefCxx(ostream& os,
     if (!ns.empty())
         os << "namespace " << ns << " {\n\n";
 
-    os << "klex::regular::LexerDef " << tableName << " {\n";
-    os << "  // initial states\n";
-    os << "  std::map<std::string, klex::regular::StateId> {\n";
-    for (const pair<const string, StateId>& s0: lexerDef.initialStates)
-        os << fmt::format("    {{ \"{}\", {} }},\n", s0.first, s0.second);
-    os << "  },\n";
-    os << "  // containsBeginOfLineStates\n";
-    os << "  " << (lexerDef.containsBeginOfLineStates ? "true" : "false") << ",\n";
-    os << "  // state transition table \n";
-    os << "  klex::regular::TransitionMap::Container {\n";
-    for (StateId stateId: lexerDef.transitions.states())
-    {
-        os << "    { " << fmt::format("{:>3}", stateId) << ", {";
-        int c = 0;
-        for (pair<Symbol, StateId> t: lexerDef.transitions.map(stateId))
-        {
-            if (c)
-                os << ", ";
-            os << "{" << charLiteral(t.first) << ", " << t.second << "}";
-            c++;
-        }
-        os << "}},\n";
-    }
-    os << "  },\n";
-    os << "  // accept state to action label mappings\n";
-    os << "  klex::regular::AcceptStateMap {\n";
-    for (const pair<StateId, Tag>& accept: lexerDef.acceptStates)
-    {
-        os << fmt::format("    {{ {:>3}, {:>3} }}, //", accept.first, accept.second);
-        set<string> names;
-        for_each(rules.begin(), rules.end(), [&](const auto& rule) {
-            if (accept.second == rule.tag)
-                names.emplace(rule.name);
-        });
-        for_each(names.begin(), names.end(), [&](const auto& name) { os << " " << name; });
-        os << "\n";
-    }
-    os << "  },\n";
-    os << "  // backtracking map\n";
-    os << "  klex::regular::BacktrackingMap {\n";
-    for (const pair<StateId, StateId>& backtrack: lexerDef.backtrackingStates)
-    {
-        os << fmt::format("    {{ {:>3}, {:>3} }},\n", backtrack.first, backtrack.second);
-    }
-    os << "  },\n";
-    os << "  // tag-to-name mappings\n";
-    os << "  std::map<klex::regular::Tag, std::string> {\n";
-    for (const pair<Tag, string>& tagName: lexerDef.tagNames)
-    {
-        if (tagName.first != IgnoreTag)
-            os << fmt::format("    {{ {}, \"{}\" }},\n", tagName.first, tagName.second);
-    }
-    os << "  }\n";
-    os << "};\n";
+    os << "klex::regular::LexerDef " << tableName << " ";
+    generateLexerDefCxx(os, lexerDef, rules);
+    os << ";\n";
 
     if (!ns.empty())
         os << "\n} // namespace " << ns << "\n";
 }
 
+optional<TableLayout> parseTableLayout(string_view name)
+{
+    for (TableLayout layout: { TableLayout::Ranges,
+                               TableLayout::Comb,
+                               TableLayout::Dense,
+                               TableLayout::Classes,
+                               TableLayout::Auto })
+        if (name == to_string(layout))
+            return layout;
+
+    return nullopt;
+}
+
+void reportTableLayout(ostream& os, const TableLayoutPlan& plan)
+{
+    const TableStatistics& stats = plan.statistics;
+    os << fmt::format("Table statistics: {} states, {} symbols in {} classes, {} transitions "
+                      "({:.1f}% density), {} backtracking states\n",
+                      stats.states,
+                      stats.symbols,
+                      stats.classes,
+                      stats.transitions,
+                      100.0 * stats.density,
+                      stats.backtrackingStates);
+    for (const pair<const TableLayout, size_t>& fp: plan.footprints)
+        os << fmt::format("Table layout {:<8} {:>9} bytes{}\n",
+                          to_string(fp.first) + ":",
+                          fp.second,
+                          fp.first == plan.layout ? " (chosen)" : "");
+}
+
 bool compareRuleNameSize(const Rule& a, const Rule& b)
 {
     return a.name.size() < b.name.size();
@@ -254,6 +209,33 @@ optional<int> prepareAndParseCLI(Flags& flags, int argc, const char* argv[])
     flags.defineBool(
         "debug-nfa", 'd', "Writes dot graph of non-deterministic finite automaton to stdout and exits.");
     flags.defineBool("no-dfa-minimize", 0, "Do not minimize the DFA");
+    flags.defineBool("direct-dfa",
+                     0,
+                     "Construct the DFA directly from the regular expressions (position automaton) "
+                     "instead of via NFA and subset construction.");
+    flags.defineString("table-layout",
+                       0,
+                       "LAYOUT",
+                       "Runtime layout of the generated transition table, one of: ranges, comb, dense, "
+                       "classes, or auto to have it chosen based on the table's statistics.",
+                       "auto");
+    flags.defineString("profile",
+                       0,
+                       "PROFILE_FILE",
+                       "Transition profile to order the states by, putting the hot ones first and "
+                       "keeping the cold ones apart from the chosen table layout.",
+                       "");
+    flags.defineString("corpus",
+                       0,
+                       "FILE",
+                       "Lexes FILE with the compiled tables, writes the recorded transition profile to "
+                       "the file given by --profile and exits.",
+                       "");
+    flags.defineString("corpus-condition",
+                       0,
+                       "CONDITION",
+                       "Condition to lex the --corpus FILE in. States of other conditions remain cold.",
+                       "INITIAL");
     flags.defineBool("perf", 'p', "Print performance counters to stderr.");
 
     try
@@ -286,11 +268,25 @@ int main(int argc, const char* argv[])
 
     fs::path klexFileName = flags.getString("file");
 
+    const optional<TableLayout> tableLayout = parseTableLayout(flags.getString("table-layout"));
+    if (!tableLayout.has_value())
+    {
+        cerr << fmt::format("Unknown table layout: {}\n", flags.getString("table-layout"));
+        return EXIT_FAILURE;
+    }
+
+    // the NFA dump requires the NFA to be actually built
+    const bool directDFA = flags.getBool("direct-dfa") && !flags.getBool("debug-nfa");
+
     PerfTimer perfTimer { flags.getBool("perf") };
-    Compiler builder;
+    Compiler builder { directDFA ? Compiler::DFAConstruction::PositionAutomaton
+                                 : Compiler::DFAConstruction::SubsetConstruction };
     builder.parse(make_unique<ifstream>(klexFileName.string()));
     const RuleList& rules = builder.rules();
-    perfTimer.lap("NFA construction", builder.size(), "states");
+    if (directDFA)
+        perfTimer.lap("RegExpr parsing", rules.size(), "rules");
+    else
+        perfTimer.lap("NFA construction", builder.size(), "states");
 
     if (flags.getBool("debug-nfa"))
     {
@@ -343,6 +339,56 @@ int main(int argc, const char* argv[])
     }
 
     LexerDef lexerDef = Compiler::generateTables(multiDFA, builder.containsBeginOfLine(), builder.names());
+
+    if (string corpusFile = flags.getString("corpus"); !corpusFile.empty())
+    {
+        if (flags.getString("profile").empty())
+        {
+            cerr << "Recording a profile requires --profile.\n";
+            return EXIT_FAILURE;
+        }
+        ifstream corpus { corpusFile };
+        const string text { istreambuf_iterator<char> { corpus }, istreambuf_iterator<char> {} };
+        TransitionProfile profile;
+        try
+        {
+            profile.record(lexerDef, text, flags.getString("corpus-condition"));
+        }
+        catch (const TransitionProfile::InvalidProfile& e)
+        {
+            cerr << fmt::format("{}: {}\n", corpusFile, e.what());
+            return EXIT_FAILURE;
+        }
+        ofstream ofs { flags.getString("profile") };
+        profile.save(ofs);
+        perfTimer.lap("Profile recording", text.size(), "bytes");
+        return EXIT_SUCCESS;
+    }
+
+    StateId hotStates = TransitionMap::AllStates;
+    if (string profileFile = flags.getString("profile"); !profileFile.empty())
+    {
+        try
+        {
+            ifstream ifs { profileFile };
+            hotStates = renumberStates(lexerDef, TransitionProfile::load(ifs));
+        }
+        catch (const TransitionProfile::InvalidProfile& e)
+        {
+            cerr << fmt::format("{}: {}\n", profileFile, e.what());
+            return EXIT_FAILURE;
+        }
+        perfTimer.lap("State renumbering", hotStates, "hot states");
+    }
+
+    // only planned if not forced, as the planner builds the class table to predict footprints
+    optional<TableLayoutPlan> plan;
+    if (*tableLayout == TableLayout::Auto)
+        plan = planTableLayout(lexerDef);
+    lexerDef.transitions.convert(plan ? plan->layout : *tableLayout, hotStates);
+    perfTimer.lap("Table generation", lexerDef.transitions.footprint(), "bytes");
+    if (flags.getBool("perf") && plan)
+        reportTableLayout(cerr, *plan);
     if (string tableFile = flags.getString("output-table"); tableFile != "-")
     {
         if (auto p = fs::path { tableFile }.remove_filename(); p != "")